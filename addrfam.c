@@ -1,4 +1,5 @@
 #include <stdlib.h>
+#include <string.h>
 
 #include "header.h"
 
@@ -10,3 +11,23 @@ address_family *addr_fams[] = {
 	&addr_meta,
 	NULL
 };
+
+/* The tables are in keywords.c and the per-family .c files, see phash.pl */
+
+address_family *get_address_family(const char *name) {
+	int i = perfect_hash_find(&addr_fam_hash, name);
+
+	if (i >= 0 && strcmp(addr_fams[i]->name, name) == 0)
+		return addr_fams[i];
+
+	return NULL;
+}
+
+method *get_method(const address_family *af, const char *name) {
+	int i = perfect_hash_find(&af->method_hash, name);
+
+	if (i >= 0 && strcmp(af->method[i].name, name) == 0)
+		return &af->method[i];
+
+	return NULL;
+}
@@ -79,6 +79,19 @@ bool execable(const char *program) {
 	return false;
 }
 
+/* Replace a value being converted, in place unless the new one is longer */
+static void set_value(char **pparam, const char *value) {
+	size_t len = strlen(value);
+
+	if (len > strlen(*pparam)) {
+		*pparam = resize_string(*pparam, len + 1);
+		if (!*pparam)
+			err(1, "realloc");
+	}
+
+	memmove(*pparam, value, len + 1);
+}
+
 void cleanup_hwaddress(interface_defn *ifd, char **pparam, int argc, char **argv) {
 	/* replace "random" with a random MAC address */
 	if (strcmp(*pparam, "random") == 0) {
@@ -95,10 +108,11 @@ void cleanup_hwaddress(interface_defn *ifd, char **pparam, int argc, char **argv
 		close(fd);
 		mac[0] |= 0x2; // locally administered
 		mac[0] &= ~0x1; // unicast
-		*pparam = realloc(*pparam, 18);
-		if (!*pparam)
-			err(1, "realloc");
-		snprintf(*pparam, 18, "%02hhx:%02hhx:%02hhx:%02hhx:%02hhx:%02hhx", mac[0], mac[1], mac[2], mac[3], mac[4], mac[5]);
+
+		char s[18];
+
+		snprintf(s, sizeof s, "%02hhx:%02hhx:%02hhx:%02hhx:%02hhx:%02hhx", mac[0], mac[1], mac[2], mac[3], mac[4], mac[5]);
+		set_value(pparam, s);
 		return;
 	}
 
@@ -119,16 +133,14 @@ void cleanup_hwaddress(interface_defn *ifd, char **pparam, int argc, char **argv
 
 void make_hex_address(interface_defn *ifd, char **pparam, int argc, char **argv) {
 	char addrcomp[4];
-	int maxlen = strlen("0000:0000");
+	char s[sizeof "0000:0000"];
 
 	int ret = sscanf(*pparam, "%3hhu.%3hhu.%3hhu.%3hhu", &addrcomp[0], &addrcomp[1], &addrcomp[2], &addrcomp[3]);
 	if (ret != 4)
 		return;
 
-	*pparam = realloc(*pparam, maxlen + 1);
-	if (*pparam == NULL)
-		return;
-	snprintf(*pparam, maxlen + 1, "%.2hhx%.2hhx:%.2hhx%.2hhx", addrcomp[0], addrcomp[1], addrcomp[2], addrcomp[3]);
+	snprintf(s, sizeof s, "%.2hhx%.2hhx:%.2hhx%.2hhx", addrcomp[0], addrcomp[1], addrcomp[2], addrcomp[3]);
+	set_value(pparam, s);
 }
 
 void compute_v4_addr(interface_defn *ifd, char **pparam, int argc, char **argv) {
@@ -141,10 +153,7 @@ void compute_v4_addr(interface_defn *ifd, char **pparam, int argc, char **argv)
 	if (!token)
 		return;
 
-	*pparam = realloc(*pparam, strlen(token) + 1);
-	if (*pparam == NULL)
-		return;
-	strcpy(*pparam, token);
+	set_value(pparam, token);
 }
 
 void compute_v4_mask(interface_defn *ifd, char **pparam, int argc, char **argv) {
@@ -192,10 +201,7 @@ void compute_v4_mask(interface_defn *ifd, char **pparam, int argc, char **argv)
 	if (inet_ntop(AF_INET, &mask, s, sizeof(s)) == NULL)
 		return;
 
-	*pparam = realloc(*pparam, strlen(s) + 1);
-	if (*pparam == NULL)
-		return;
-	strcpy(*pparam, s);
+	set_value(pparam, s);
 }
 
 void compute_v4_broadcast(interface_defn *ifd, char **pparam, int argc, char **argv) {
@@ -206,22 +212,12 @@ void compute_v4_broadcast(interface_defn *ifd, char **pparam, int argc, char **a
 	struct in_addr addr;
 	struct in_addr mask;
 
-	char *s = get_var("address", strlen("address"), ifd);
-	if (!s)
-		return;
-
-	int r = inet_pton(AF_INET, s, &addr);
-	free(s);
-	if (r != 1)
+	const char *s = get_var("address", strlen("address"), ifd);
+	if (!s || inet_pton(AF_INET, s, &addr) != 1)
 		return;
 
 	s = get_var("netmask", strlen("netmask"), ifd);
-	if (!s)
-		return;
-
-	r = inet_pton(AF_INET, s, &mask);
-	free(s);
-	if (r != 1)
+	if (!s || inet_pton(AF_INET, s, &mask) != 1)
 		return;
 
 	if (mask.s_addr != htonl(0xfffffffe)) {
@@ -243,24 +239,15 @@ void compute_v4_broadcast(interface_defn *ifd, char **pparam, int argc, char **a
 	if (inet_ntop(AF_INET, &addr, buffer, sizeof(buffer)) == NULL)
 		return;
 
-	*pparam = realloc(*pparam, strlen(buffer) + 1);
-	if (*pparam == NULL)
-		return;
-	strcpy(*pparam, buffer);
+	set_value(pparam, buffer);
 }
 
 void set_preferred_lft(interface_defn *ifd, char **pparam, int argc, char **argv) {
 	if (!ifd->real_iface)
 		return;
 
-	if (iface_has(":")) {
-		char s[] = "0";
-
-		*pparam = realloc(*pparam, sizeof(s));
-		if (*pparam == NULL)
-			return;
-		strcpy(*pparam, s);
-	}
+	if (iface_has(":"))
+		set_value(pparam, "0");
 }
 
 void get_token(interface_defn *ifd, char **pparam, int argc, char **argv) {
@@ -272,26 +259,23 @@ void get_token(interface_defn *ifd, char **pparam, int argc, char **argv) {
 	if (argc > 1)
 		token_no = atoi(argv[1]);
 
-	char *s = strdup(*pparam);
-	char *token = strtok(s, argv[0]);
+	/* the tokens strtok() would find, without copying the value for it */
+	const char *token = *pparam + strspn(*pparam, argv[0]);
 
-	while (token_no > 0) {
-		token = strtok(NULL, argv[0]);
+	while (token_no > 0 && *token) {
+		token += strcspn(token, argv[0]);
+		token += strspn(token, argv[0]);
 		token_no--;
 	}
 
-	if (token) {
-		strcpy(*pparam, token);
-	} else {
-		if (argc == 3) {
-			free(*pparam);
-			*pparam = strdup(argv[2]);
-			if (!*pparam)
-				err(1, "strdup");
-		}
-	}
+	if (*token) {
+		size_t len = strcspn(token, argv[0]);
 
-	free(s);
+		memmove(*pparam, token, len);
+		(*pparam)[len] = '\0';
+	} else if (argc == 3) {
+		set_value(pparam, argv[2]);
+	}
 }
 
 void to_decimal(interface_defn *ifd, char **pparam, int argc, char **argv) {
@@ -315,25 +299,15 @@ void map_value(interface_defn *ifd, char **pparam, int argc, char **argv) {
 
 	int value = (atoi(*pparam) || strcasecmp(*pparam, "on") == 0 || strcasecmp(*pparam, "true") == 0 || strcasecmp(*pparam, "yes") == 0);
 
-	if ((value < argc) && (argv[value] != NULL)) {
-		*pparam = realloc(*pparam, strlen(argv[value]) + 1);
-		if (*pparam == NULL)
-			return;
-		strcpy(*pparam, argv[value]);
-	} else {
-		*pparam = realloc(*pparam, 1);
-		if (*pparam == NULL)
-			return;
-		*pparam[0] = 0;
-	}
+	if ((value < argc) && (argv[value] != NULL))
+		set_value(pparam, argv[value]);
+	else
+		set_value(pparam, "");
 }
 
 void if_set(interface_defn *ifd, char **pparam, int argc, char **argv) {
 	if (argc < 1)
 		return;
 
-	*pparam = realloc(*pparam, strlen(argv[0]) + 1);
-	if (*pparam == NULL)
-		return;
-	strcpy(*pparam, argv[0]);
+	set_value(pparam, argv[0]);
 }
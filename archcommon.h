@@ -6,6 +6,7 @@ bool execable(const char *);
 #define iface_has(s) _iface_has(ifd->real_iface, (s))
 #define iface_is_lo() ((!strcmp(ifd->logical_iface, LO_IFACE)) && (!no_loopback))
 #define var_strcasecmp(name, value) (strcasecmp(value, get_var(name, strlen(name), ifd)))
+#define var_strcasecmp_slot(slots, slot, value) (strcasecmp(value, get_slot_var(slots, slot, ifd)))
 
 bool _iface_has(const char *, const char *);
 void cleanup_hwaddress(interface_defn *ifd, char **pparam, int argc, char **argv);
@@ -0,0 +1,160 @@
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <err.h>
+#include <sys/mman.h>
+
+#include "header.h"
+
+/*
+ * The parsed configuration is allocated from a few large chunks, which are
+ * only ever freed all at once. Option and allow class names are interned,
+ * so each distinct name is stored once however many stanzas use it.
+ *
+ * Strings in the arena may be modified in place, but not freed or
+ * reallocated; use release_string() and resize_string() for values that
+ * might have come from here.
+ */
+
+#define ARENA_ALIGN sizeof(void *)
+#define ARENA_MIN_CHUNK (64 * 1024)
+#define ARENA_MAX_CHUNK (1024 * 1024)
+
+struct chunk {
+	struct chunk *next;
+	char *start;
+	char *end;
+	bool mapped;		/* adopted with arena_adopt(), to be unmapped */
+};
+
+static struct chunk *chunks;
+static char *next_free;
+static char *chunk_end;
+static size_t chunk_size = ARENA_MIN_CHUNK;
+
+static hash_table interned;
+
+static void add_chunk(char *start, size_t size, bool mapped) {
+	struct chunk *chunk = malloc(sizeof *chunk);
+	if (!chunk)
+		err(1, "malloc");
+
+	*chunk = (struct chunk) {
+		.next = chunks,
+		.start = start,
+		.end = start + size,
+		.mapped = mapped,
+	};
+
+	chunks = chunk;
+}
+
+static void *alloc_bytes(size_t size, size_t align) {
+	uintptr_t p = ((uintptr_t)next_free + align - 1) & ~(uintptr_t)(align - 1);
+
+	if (!next_free || size > (uintptr_t)chunk_end - p) {
+		size_t n = chunk_size;
+
+		if (n < size)
+			n = size;
+
+		if (chunk_size < ARENA_MAX_CHUNK)
+			chunk_size *= 2;
+
+		/* calloc(), so that arena_alloc() always returns zeroed memory */
+		char *start = calloc(1, n);
+		if (!start)
+			err(1, "calloc");
+
+		add_chunk(start, n, false);
+		next_free = start;
+		chunk_end = start + n;
+		p = (uintptr_t)start;
+	}
+
+	next_free = (char *)p + size;
+
+	return (void *)p;
+}
+
+void *arena_alloc(size_t size) {
+	return alloc_bytes(size, ARENA_ALIGN);
+}
+
+char *arena_strndup(const char *str, size_t len) {
+	char *copy = alloc_bytes(len + 1, 1);
+
+	memcpy(copy, str, len);
+	copy[len] = '\0';
+
+	return copy;
+}
+
+char *arena_strdup(const char *str) {
+	return arena_strndup(str, strlen(str));
+}
+
+/* Make memory obtained with mmap() part of the arena, such as a loaded cache */
+void arena_adopt(void *start, size_t size) {
+	add_chunk(start, size, true);
+}
+
+bool arena_owns(const void *ptr) {
+	for (struct chunk *chunk = chunks; chunk; chunk = chunk->next)
+		if ((const char *)ptr >= chunk->start && (const char *)ptr < chunk->end)
+			return true;
+
+	return false;
+}
+
+void arena_free(void) {
+	hash_clear(&interned);
+
+	while (chunks) {
+		struct chunk *next = chunks->next;
+
+		if (chunks->mapped)
+			munmap(chunks->start, chunks->end - chunks->start);
+		else
+			free(chunks->start);
+
+		free(chunks);
+		chunks = next;
+	}
+
+	next_free = chunk_end = NULL;
+	chunk_size = ARENA_MIN_CHUNK;
+}
+
+/* The one copy of a name; equal names give equal pointers. Must not be modified. */
+char *intern(const char *str, size_t len) {
+	char *copy = hash_get(&interned, str, len);
+
+	if (!copy) {
+		copy = arena_strndup(str, len);
+		hash_set(&interned, copy, copy);
+	}
+
+	return copy;
+}
+
+void release_string(char *str) {
+	if (!arena_owns(str))
+		free(str);
+}
+
+/* Like realloc(), but also for strings that live in the arena */
+char *resize_string(char *str, size_t size) {
+	if (!str || !arena_owns(str))
+		return realloc(str, size);
+
+	char *copy = malloc(size);
+
+	if (copy) {
+		size_t len = strlen(str) + 1;
+
+		memcpy(copy, str, len < size ? len : size);
+	}
+
+	return copy;
+}
@@ -0,0 +1,135 @@
+/*
+ * Measure how long read_interfaces() takes for a generated interfaces file,
+ * and how long looking up address families and methods takes with the
+ * perfect hash tables compared to trying each name with strcmp().
+ *
+ * usage: parse-bench [stanzas [iterations]]
+ */
+
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <time.h>
+#include <err.h>
+
+#include "../header.h"
+
+static const char *v4_methods[] = { "static", "dhcp", "manual" };
+static const char *v6_methods[] = { "static", "auto", "manual" };
+
+/* Write stanzas of the kinds a large interfaces file has */
+static void write_corpus(FILE *f, int n_stanzas) {
+	fprintf(f, "auto lo\niface lo inet loopback\n\n");
+
+	for (int i = 0; i < n_stanzas; i++) {
+		int parent = i / 4000, vlan = i % 4000 + 1;
+		const char *v4 = v4_methods[i % 3];
+		const char *v6 = v6_methods[i % 3];
+
+		fprintf(f, "%s eth%d.%d\n", i % 2 ? "auto" : "allow-hotplug", parent, vlan);
+		fprintf(f, "iface eth%d.%d inet %s\n", parent, vlan, v4);
+
+		if (strcmp(v4, "static") == 0)
+			fprintf(f, "\taddress 10.%d.%d.1/24\n\tgateway 10.%d.%d.254\n",
+				i / 256 % 256, i % 256, i / 256 % 256, i % 256);
+
+		fprintf(f, "\tmtu 1500\n\tpost-up ip route add 192.168.%d.0/24 dev $IFACE\n\n", i % 256);
+
+		fprintf(f, "iface eth%d.%d inet6 %s\n", parent, vlan, v6);
+
+		if (strcmp(v6, "static") == 0)
+			fprintf(f, "\taddress fd00:%x::1/64\n", i);
+
+		fprintf(f, "\n");
+
+		if (i % 100 == 0)
+			fprintf(f, "no-auto-down eth%d.%d\n\n", parent, vlan);
+	}
+}
+
+static double now(void) {
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/* The lookups as they were, to compare with */
+static method *linear_lookup(const char *af_name, const char *method_name) {
+	for (int i = 0; addr_fams[i]; i++)
+		if (strcmp(addr_fams[i]->name, af_name) == 0)
+			for (int j = 0; j < addr_fams[i]->n_methods; j++)
+				if (strcmp(addr_fams[i]->method[j].name, method_name) == 0)
+					return &addr_fams[i]->method[j];
+
+	return NULL;
+}
+
+static method *hash_lookup(const char *af_name, const char *method_name) {
+	address_family *af = get_address_family(af_name);
+
+	return af ? get_method(af, method_name) : NULL;
+}
+
+static void measure_lookups(const char *label, method *(*lookup)(const char *, const char *), int iterations) {
+	int found = 0;
+	double start = now();
+
+	for (int n = 0; n < iterations; n++)
+		for (int i = 0; addr_fams[i]; i++)
+			for (int j = 0; j < addr_fams[i]->n_methods; j++)
+				found += lookup(addr_fams[i]->name, addr_fams[i]->method[j].name) != NULL;
+
+	double elapsed = now() - start;
+
+	printf("%-12s %8d lookups %8.1f ns/lookup\n", label, found, elapsed / found * 1e9);
+}
+
+int main(int argc, char **argv) {
+	int n_stanzas = argc > 1 ? atoi(argv[1]) : 20000;
+	int iterations = argc > 2 ? atoi(argv[2]) : 10;
+	char path[] = "/tmp/parse-bench.XXXXXX";
+
+	if (n_stanzas < 0 || iterations < 1)
+		errx(1, "usage: parse-bench [stanzas [iterations]]");
+
+	int fd = mkstemp(path);
+	if (fd == -1)
+		err(1, "mkstemp");
+
+	FILE *f = fdopen(fd, "w");
+	if (!f)
+		err(1, "fdopen");
+
+	write_corpus(f, n_stanzas);
+
+	if (fclose(f) == EOF)
+		err(1, "%s", path);
+
+	double best = 0;
+
+	for (int i = 0; i < iterations; i++) {
+		double start = now();
+
+		if (!read_interfaces(path, NULL, false))
+			errx(1, "%s: parse failed", path);
+
+		double elapsed = now() - start;
+
+		if (!i || elapsed < best)
+			best = elapsed;
+	}
+
+	unlink(path);
+
+	printf("%-12s %8d stanzas %8.1f ms\n", "parse", n_stanzas, best * 1e3);
+
+	measure_lookups("strcmp", linear_lookup, iterations * 10000);
+	measure_lookups("perfect hash", hash_lookup, iterations * 10000);
+
+	return 0;
+}
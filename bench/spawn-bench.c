@@ -0,0 +1,131 @@
+/*
+ * Compare the latency of starting a command with fork() + exec, the way
+ * doit() used to, and with posix_spawn(), while the process holds about as
+ * much memory as ifup does after parsing a large interfaces file.
+ *
+ * usage: spawn-bench [stanzas [iterations [command]]]
+ */
+
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <spawn.h>
+#include <time.h>
+#include <err.h>
+#include <sys/wait.h>
+
+#include "../header.h"
+
+extern char **environ;
+
+static const char *names[] = {
+	"address", "netmask", "broadcast", "gateway", "mtu", "hwaddress",
+	"dns-nameservers", "dns-search", "up", "down", "pre-up", "post-down",
+};
+
+/* Build stanzas the way read_interfaces() does: one allocation per string */
+static interfaces_file *synthetic_config(int n_stanzas) {
+	interfaces_file *defn = calloc(1, sizeof *defn);
+	interface_defn **tail = &defn->ifaces;
+
+	for (int i = 0; i < n_stanzas; i++) {
+		interface_defn *iface = calloc(1, sizeof *iface);
+		if (!iface)
+			err(1, "calloc");
+
+		if (asprintf(&iface->logical_iface, "eth%d.%d", i / 4000, i % 4000 + 1) == -1)
+			err(1, "asprintf");
+
+		iface->real_iface = iface->logical_iface;
+		iface->n_options = iface->max_options = sizeof names / sizeof *names;
+		iface->option = calloc(iface->n_options, sizeof *iface->option);
+
+		for (int j = 0; j < iface->n_options; j++) {
+			iface->option[j].name = strdup(names[j]);
+			if (asprintf(&iface->option[j].value, "ip route add 10.%d.%d.0/24 via 10.0.0.1 dev %s # %d",
+					i / 256 % 256, i % 256, iface->logical_iface, j) == -1)
+				err(1, "asprintf");
+		}
+
+		*tail = iface;
+		tail = &iface->next;
+	}
+
+	return defn;
+}
+
+static double now(void) {
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void run_fork(char **argv) {
+	pid_t child;
+	int status;
+
+	switch (child = fork()) {
+	case -1:
+		err(1, "fork");
+
+	case 0:
+		execve(argv[0], argv, environ);
+		_exit(127);
+
+	default:
+		break;
+	}
+
+	waitpid(child, &status, 0);
+}
+
+static void run_spawn(char **argv) {
+	pid_t child;
+	int status;
+
+	int error = posix_spawn(&child, argv[0], NULL, NULL, argv, environ);
+	if (error)
+		errx(1, "posix_spawn: %s", strerror(error));
+
+	waitpid(child, &status, 0);
+}
+
+static void measure(const char *label, void (*run)(char **), char **argv, int iterations) {
+	double start = now();
+
+	for (int i = 0; i < iterations; i++)
+		run(argv);
+
+	double elapsed = now() - start;
+
+	printf("%-12s %8d runs %10.1f us/run\n", label, iterations, elapsed / iterations * 1e6);
+}
+
+int main(int argc, char **argv) {
+	int n_stanzas = argc > 1 ? atoi(argv[1]) : 20000;
+	int iterations = argc > 2 ? atoi(argv[2]) : 500;
+	char *command[] = { argc > 3 ? argv[3] : "/bin/true", NULL };
+
+	if (n_stanzas < 0 || iterations < 1)
+		errx(1, "usage: spawn-bench [stanzas [iterations [command]]]");
+
+	interfaces_file *defn = synthetic_config(n_stanzas);
+
+	printf("%d stanzas loaded, running %s\n", n_stanzas, command[0]);
+
+	/* warm up both paths before measuring */
+	run_fork(command);
+	run_spawn(command);
+
+	measure("fork+exec", run_fork, command, iterations);
+	measure("posix_spawn", run_spawn, command, iterations);
+
+	(void)defn;
+
+	return 0;
+}
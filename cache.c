@@ -0,0 +1,630 @@
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <err.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "header.h"
+
+/*
+ * A compiled copy of the parsed interfaces file, so that the next run can
+ * map it instead of parsing everything again. It is only used as long as
+ * none of the files and directories the parser looked at have changed.
+ *
+ * All references in the cache file are offsets from its start, 0 meaning
+ * NULL, so the file can be mapped anywhere.
+ */
+
+#define CACHE_MAGIC "ifupdown cache 2"
+
+struct cache_header {
+	char magic[16];
+	uint32_t size;
+	uint32_t filename;
+	uint32_t no_loopback_before;
+	uint32_t no_loopback_after;
+	uint32_t n_files, files;
+	uint32_t n_ifaces, ifaces;
+	uint32_t n_allowups, allowups;
+	uint32_t n_mappings, mappings;
+	uint32_t n_lists[3], lists[3];
+};
+
+struct cache_file {
+	uint32_t path;
+	uint32_t kind;
+	uint64_t dev;
+	uint64_t ino;
+	uint64_t size;
+	int64_t mtime_sec;
+	int64_t mtime_nsec;
+	int64_t ctime_sec;
+	int64_t ctime_nsec;
+};
+
+struct cache_iface {
+	uint32_t logical_iface;
+	uint32_t address_family;
+	uint32_t method;
+	uint32_t n_options, options;
+};
+
+struct cache_option {
+	uint32_t name;
+	uint32_t value;
+};
+
+struct cache_allowup {
+	uint32_t when;
+	uint32_t n_interfaces, interfaces;
+};
+
+struct cache_mapping {
+	uint32_t script;
+	uint32_t n_matches, matches;
+	uint32_t n_mappings, mappings;
+};
+
+/* What the parser depended on in this run */
+static struct cache_file *files = NULL;
+static char **file_paths = NULL;
+static int n_files = 0;
+static int max_files = 0;
+static bool cacheable = true;
+static time_t parse_start;
+
+void cache_begin(void) {
+	for (int i = 0; i < n_files; i++)
+		free(file_paths[i]);
+
+	n_files = 0;
+	cacheable = true;
+	parse_start = time(NULL);
+}
+
+void cache_disable(void) {
+	cacheable = false;
+}
+
+void cache_depend(const char *path, dependency kind) {
+	struct stat st;
+
+	if (!cacheable)
+		return;
+
+	if (kind == DEPEND_ABSENT)
+		memset(&st, 0, sizeof st);
+
+	cache_depend_stat(path, kind, kind == DEPEND_ABSENT || stat(path, &st) == 0 ? &st : NULL);
+}
+
+/* Like cache_depend(), with what stat() said about path, or NULL if it failed */
+void cache_depend_stat(const char *path, dependency kind, const struct stat *st) {
+	if (!cacheable)
+		return;
+
+	if (!st) {
+		cacheable = false;
+		return;
+	}
+
+	if (n_files == max_files) {
+		max_files = max_files ? 2 * max_files : 16;
+		files = realloc(files, max_files * sizeof *files);
+		file_paths = realloc(file_paths, max_files * sizeof *file_paths);
+		if (!files || !file_paths)
+			err(1, "realloc");
+	}
+
+	file_paths[n_files] = strdup(path);
+	if (!file_paths[n_files])
+		err(1, "strdup");
+
+	files[n_files] = (struct cache_file) {
+		.kind = kind,
+		.dev = st->st_dev,
+		.ino = st->st_ino,
+		.size = st->st_size,
+		.mtime_sec = st->st_mtim.tv_sec,
+		.mtime_nsec = st->st_mtim.tv_nsec,
+		.ctime_sec = st->st_ctim.tv_sec,
+		.ctime_nsec = st->st_ctim.tv_nsec,
+	};
+
+	n_files++;
+}
+
+/*
+ * Note the directory that the wildcards in a source or source-dir pattern
+ * are matched against. Anything wordexp() does beyond matching names in a
+ * single directory cannot be checked cheaply, so it makes the result
+ * uncacheable.
+ */
+void cache_depend_pattern(const char *pattern) {
+	const char *wildcard = strpbrk(pattern, "*?[");
+
+	if (!wildcard)
+		return;
+
+	if (strpbrk(pattern, "$~`\\\"'{}()|&;<> \t\n") || strchr(wildcard, '/')) {
+		cacheable = false;
+		return;
+	}
+
+	const char *slash = memrchr(pattern, '/', wildcard - pattern);
+	char *dir = slash ? strndup(pattern, slash == pattern ? 1 : slash - pattern) : strdup(".");
+	if (!dir)
+		err(1, "strdup");
+
+	cache_depend(dir, DEPEND_GLOB);
+	free(dir);
+}
+
+/* The output of the cache writer */
+struct buffer {
+	char *data;
+	size_t len;
+	size_t max;
+};
+
+static uint32_t put(struct buffer *b, const void *data, size_t len) {
+	size_t pos = (b->len + 7) & ~(size_t)7;
+
+	if (pos + len > b->max) {
+		b->max = (pos + len) * 2;
+		b->data = realloc(b->data, b->max);
+		if (!b->data)
+			err(1, "realloc");
+	}
+
+	memset(b->data + b->len, 0, pos - b->len);
+	memcpy(b->data + pos, data, len);
+	b->len = pos + len;
+
+	return pos;
+}
+
+static uint32_t put_string(struct buffer *b, const char *str) {
+	return str ? put(b, str, strlen(str) + 1) : 0;
+}
+
+static uint32_t put_strings(struct buffer *b, char **strs, int n) {
+	uint32_t offsets[n + 1];
+
+	for (int i = 0; i < n; i++)
+		offsets[i] = put_string(b, strs[i]);
+
+	return put(b, offsets, n * sizeof *offsets);
+}
+
+void cache_save(const char *cachefile, const char *filename, interfaces_file *defn, bool no_loopback_before, int first_in_list[3]) {
+	if (!cacheable || !cachefile)
+		return;
+
+	/* a file changed within the same second might change again unnoticed */
+	for (int i = 0; i < n_files; i++)
+		if (files[i].mtime_sec >= parse_start || files[i].ctime_sec >= parse_start)
+			return;
+
+	struct buffer b = { NULL, 0, 0 };
+	struct cache_header header = {
+		.magic = CACHE_MAGIC,
+		.no_loopback_before = no_loopback_before,
+		.no_loopback_after = no_loopback,
+	};
+
+	put(&b, &header, sizeof header);
+	header.filename = put_string(&b, filename);
+
+	struct cache_file file_entries[n_files + 1];
+
+	for (int i = 0; i < n_files; i++) {
+		file_entries[i] = files[i];
+		file_entries[i].path = put_string(&b, file_paths[i]);
+	}
+
+	header.n_files = n_files;
+	header.files = put(&b, file_entries, n_files * sizeof *file_entries);
+
+	for (interface_defn *iface = defn->ifaces; iface; iface = iface->next)
+		header.n_ifaces++;
+
+	struct cache_iface *ifaces = calloc(header.n_ifaces + 1, sizeof *ifaces);
+	if (!ifaces)
+		err(1, "calloc");
+
+	int n = 0;
+
+	for (interface_defn *iface = defn->ifaces; iface; iface = iface->next, n++) {
+		/* inherited options are stored with each stanza */
+		interface_defn flat = {0};
+		interface_defn *opts = iface;
+
+		if (iface->inherits) {
+			flatten_options(iface, &flat);
+			opts = &flat;
+		}
+
+		struct cache_option options[opts->n_options + 1];
+
+		for (int i = 0; i < opts->n_options; i++) {
+			options[i].name = put_string(&b, opts->option[i].name);
+			options[i].value = put_string(&b, opts->option[i].value);
+		}
+
+		ifaces[n] = (struct cache_iface) {
+			.logical_iface = put_string(&b, iface->logical_iface),
+			.address_family = put_string(&b, iface->address_family ? iface->address_family->name : NULL),
+			.method = put_string(&b, iface->method ? iface->method->name : NULL),
+			.n_options = opts->n_options,
+			.options = put(&b, options, opts->n_options * sizeof *options),
+		};
+
+		free(flat.option);
+		clear_option_index(&flat);
+	}
+
+	header.ifaces = put(&b, ifaces, header.n_ifaces * sizeof *ifaces);
+	free(ifaces);
+
+	for (allowup_defn *allowup = defn->allowups; allowup; allowup = allowup->next)
+		header.n_allowups++;
+
+	struct cache_allowup allowups[header.n_allowups + 1];
+	n = 0;
+
+	for (allowup_defn *allowup = defn->allowups; allowup; allowup = allowup->next, n++) {
+		allowups[n] = (struct cache_allowup) {
+			.when = put_string(&b, allowup->when),
+			.n_interfaces = allowup->n_interfaces,
+			.interfaces = put_strings(&b, allowup->interfaces, allowup->n_interfaces),
+		};
+	}
+
+	header.allowups = put(&b, allowups, header.n_allowups * sizeof *allowups);
+
+	for (mapping_defn *map = defn->mappings; map; map = map->next)
+		header.n_mappings++;
+
+	struct cache_mapping mappings[header.n_mappings + 1];
+	n = 0;
+
+	for (mapping_defn *map = defn->mappings; map; map = map->next, n++) {
+		mappings[n] = (struct cache_mapping) {
+			.script = put_string(&b, map->script),
+			.n_matches = map->n_matches,
+			.matches = put_strings(&b, map->match, map->n_matches),
+			.n_mappings = map->n_mappings,
+			.mappings = put_strings(&b, map->mapping, map->n_mappings),
+		};
+	}
+
+	header.mappings = put(&b, mappings, header.n_mappings * sizeof *mappings);
+
+	char **lists[3] = { no_auto_down_int, no_scripts_int, rename_int };
+	int counts[3] = { no_auto_down_ints, no_scripts_ints, rename_ints };
+
+	for (int i = 0; i < 3; i++) {
+		header.n_lists[i] = counts[i] - first_in_list[i];
+		header.lists[i] = put_strings(&b, lists[i] + first_in_list[i], header.n_lists[i]);
+	}
+
+	/* so that every string is terminated within the file */
+	put(&b, "", 1);
+
+	header.size = b.len;
+	memcpy(b.data, &header, sizeof header);
+
+	char *tmpfile;
+	if (asprintf(&tmpfile, "%s.XXXXXX", cachefile) == -1)
+		err(1, "asprintf");
+
+	int fd = mkstemp(tmpfile);
+
+	if (fd != -1) {
+		bool okay = fchmod(fd, 0644) == 0 && write(fd, b.data, b.len) == (ssize_t)b.len;
+
+		if (close(fd) || !okay || rename(tmpfile, cachefile))
+			unlink(tmpfile);
+	}
+
+	free(tmpfile);
+	free(b.data);
+}
+
+/* Everything the loader needs to check offsets against */
+struct mapped {
+	const char *data;
+	size_t size;
+};
+
+static bool valid_array(const struct mapped *m, uint32_t offset, uint32_t n, size_t size) {
+	return offset % 8 == 0 && offset <= m->size && n <= (m->size - offset) / size;
+}
+
+static bool valid_strings(const struct mapped *m, uint32_t offset, uint32_t n, bool may_be_null) {
+	if (!valid_array(m, offset, n, sizeof(uint32_t)))
+		return false;
+
+	const uint32_t *strs = (const uint32_t *)(m->data + offset);
+
+	for (uint32_t i = 0; i < n; i++)
+		if (strs[i] >= m->size || (!strs[i] && !may_be_null))
+			return false;
+
+	return true;
+}
+
+static char *string_at(const struct mapped *m, uint32_t offset) {
+	return offset ? (char *)m->data + offset : NULL;
+}
+
+static char **strings_at(const struct mapped *m, uint32_t offset, uint32_t n) {
+	const uint32_t *strs = (const uint32_t *)(m->data + offset);
+	char **result = malloc((n + 1) * sizeof *result);
+	if (!result)
+		err(1, "malloc");
+
+	for (uint32_t i = 0; i < n; i++)
+		result[i] = string_at(m, strs[i]);
+
+	return result;
+}
+
+static bool valid_cache(const struct mapped *m, const char *filename) {
+	const struct cache_header *header = (const struct cache_header *)m->data;
+
+	if (m->size < sizeof *header || m->data[m->size - 1])
+		return false;
+
+	if (memcmp(header->magic, CACHE_MAGIC, sizeof header->magic) || header->size != m->size)
+		return false;
+
+	if (!header->filename || header->filename >= m->size || strcmp(m->data + header->filename, filename))
+		return false;
+
+	if (header->no_loopback_before != no_loopback)
+		return false;
+
+	if (!valid_array(m, header->files, header->n_files, sizeof(struct cache_file)))
+		return false;
+
+	const struct cache_file *file_entries = (const struct cache_file *)(m->data + header->files);
+
+	for (uint32_t i = 0; i < header->n_files; i++) {
+		const struct cache_file *f = &file_entries[i];
+		struct stat st;
+
+		if (!f->path || f->path >= m->size)
+			return false;
+
+		if (stat(m->data + f->path, &st) == -1) {
+			if (f->kind == DEPEND_ABSENT && errno == ENOENT)
+				continue;
+
+			return false;
+		}
+
+		if (f->kind == DEPEND_ABSENT || f->dev != (uint64_t)st.st_dev || f->ino != (uint64_t)st.st_ino || f->size != (uint64_t)st.st_size)
+			return false;
+
+		if (f->mtime_sec != st.st_mtim.tv_sec || f->mtime_nsec != st.st_mtim.tv_nsec)
+			return false;
+
+		/* unlike the mtime, this cannot be set back */
+		if (f->ctime_sec != st.st_ctim.tv_sec || f->ctime_nsec != st.st_ctim.tv_nsec)
+			return false;
+	}
+
+	if (!valid_array(m, header->ifaces, header->n_ifaces, sizeof(struct cache_iface)))
+		return false;
+
+	const struct cache_iface *ifaces = (const struct cache_iface *)(m->data + header->ifaces);
+
+	for (uint32_t i = 0; i < header->n_ifaces; i++) {
+		const struct cache_iface *iface = &ifaces[i];
+
+		if (!iface->logical_iface || iface->logical_iface >= m->size || iface->address_family >= m->size || iface->method >= m->size)
+			return false;
+
+		if (!valid_array(m, iface->options, iface->n_options, sizeof(struct cache_option)))
+			return false;
+
+		const struct cache_option *options = (const struct cache_option *)(m->data + iface->options);
+
+		for (uint32_t j = 0; j < iface->n_options; j++)
+			if (!options[j].name || options[j].name >= m->size || !options[j].value || options[j].value >= m->size)
+				return false;
+	}
+
+	if (!valid_array(m, header->allowups, header->n_allowups, sizeof(struct cache_allowup)))
+		return false;
+
+	const struct cache_allowup *allowups = (const struct cache_allowup *)(m->data + header->allowups);
+
+	for (uint32_t i = 0; i < header->n_allowups; i++)
+		if (!allowups[i].when || allowups[i].when >= m->size || !valid_strings(m, allowups[i].interfaces, allowups[i].n_interfaces, false))
+			return false;
+
+	if (!valid_array(m, header->mappings, header->n_mappings, sizeof(struct cache_mapping)))
+		return false;
+
+	const struct cache_mapping *mappings = (const struct cache_mapping *)(m->data + header->mappings);
+
+	for (uint32_t i = 0; i < header->n_mappings; i++) {
+		if (mappings[i].script >= m->size)
+			return false;
+
+		if (!valid_strings(m, mappings[i].matches, mappings[i].n_matches, false) || !valid_strings(m, mappings[i].mappings, mappings[i].n_mappings, false))
+			return false;
+	}
+
+	for (int i = 0; i < 3; i++)
+		if (!valid_strings(m, header->lists[i], header->n_lists[i], false))
+			return false;
+
+	return true;
+}
+
+static method *find_method(const char *af_name, const char *method_name, address_family **af) {
+	*af = NULL;
+
+	if (!af_name)
+		return NULL;
+
+	*af = get_address_family(af_name);
+
+	return *af && method_name ? get_method(*af, method_name) : NULL;
+}
+
+static void append_list(char ***list, int *count, char **items, int n) {
+	if (!n)
+		return;
+
+	*list = realloc(*list, (*count + n) * sizeof **list);
+	if (!*list)
+		err(1, "realloc");
+
+	for (int i = 0; i < n; i++) {
+		(*list)[*count + i] = strdup(items[i]);
+		if (!(*list)[*count + i])
+			err(1, "strdup");
+	}
+
+	*count += n;
+}
+
+interfaces_file *cache_load(const char *cachefile, const char *filename) {
+	if (!cachefile)
+		return NULL;
+
+	int fd = open(cachefile, O_RDONLY | O_CLOEXEC);
+	if (fd == -1)
+		return NULL;
+
+	struct stat st;
+	void *data = MAP_FAILED;
+
+	/* private, so that nothing we do to the strings can reach the file */
+	if (fstat(fd, &st) == 0 && st.st_size > 0)
+		data = mmap(NULL, st.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+
+	close(fd);
+
+	if (data == MAP_FAILED)
+		return NULL;
+
+	struct mapped m = { data, st.st_size };
+
+	if (!valid_cache(&m, filename)) {
+		munmap(data, st.st_size);
+		return NULL;
+	}
+
+	const struct cache_header *header = data;
+	const struct cache_iface *ifaces = (const struct cache_iface *)(m.data + header->ifaces);
+	address_family *afs[header->n_ifaces + 1];
+	method *methods[header->n_ifaces + 1];
+
+	for (uint32_t i = 0; i < header->n_ifaces; i++) {
+		methods[i] = find_method(string_at(&m, ifaces[i].address_family), string_at(&m, ifaces[i].method), &afs[i]);
+
+		if (!methods[i]) {
+			munmap(data, st.st_size);
+			return NULL;
+		}
+	}
+
+	/* the strings are used where they are, the mapping stays for as long as the arena */
+	arena_adopt(data, st.st_size);
+
+	interfaces_file *defn = arena_alloc(sizeof *defn);
+
+	for (uint32_t i = 0; i < header->n_ifaces; i++) {
+		interface_defn *iface = arena_alloc(sizeof *iface);
+		const struct cache_option *options = (const struct cache_option *)(m.data + ifaces[i].options);
+
+		*iface = (interface_defn) {
+			.logical_iface = string_at(&m, ifaces[i].logical_iface),
+			.address_family = afs[i],
+			.method = methods[i],
+			.n_options = ifaces[i].n_options,
+			.max_options = ifaces[i].n_options,
+		};
+
+		/* the option array itself grows at run time */
+		iface->option = iface->n_options ? malloc(iface->n_options * sizeof *iface->option) : NULL;
+		if (iface->n_options && !iface->option)
+			err(1, "malloc");
+
+		for (int j = 0; j < iface->n_options; j++) {
+			const char *name = string_at(&m, options[j].name);
+
+			iface->option[j].name = intern(name, strlen(name));
+			iface->option[j].value = string_at(&m, options[j].value);
+			iface->option[j].next_same = -1;
+		}
+
+		add_interface(defn, iface);
+	}
+
+	const struct cache_allowup *allowups = (const struct cache_allowup *)(m.data + header->allowups);
+
+	for (uint32_t i = 0; i < header->n_allowups; i++) {
+		allowup_defn *allowup = arena_alloc(sizeof *allowup);
+		const char *when = string_at(&m, allowups[i].when);
+
+		allowup->when = intern(when, strlen(when));
+		allowup->n_interfaces = allowup->max_interfaces = allowups[i].n_interfaces;
+		allowup->interfaces = strings_at(&m, allowups[i].interfaces, allowups[i].n_interfaces);
+
+		add_allowup(defn, allowup);
+	}
+
+	const struct cache_mapping *mappings = (const struct cache_mapping *)(m.data + header->mappings);
+
+	for (uint32_t i = 0; i < header->n_mappings; i++) {
+		mapping_defn *map = arena_alloc(sizeof *map);
+
+		map->script = string_at(&m, mappings[i].script);
+		map->n_matches = map->max_matches = mappings[i].n_matches;
+		map->match = strings_at(&m, mappings[i].matches, mappings[i].n_matches);
+		map->n_mappings = map->max_mappings = mappings[i].n_mappings;
+		map->mapping = strings_at(&m, mappings[i].mappings, mappings[i].n_mappings);
+
+		add_mapping(defn, map);
+	}
+
+	char ***lists[3] = { &no_auto_down_int, &no_scripts_int, &rename_int };
+	int *counts[3] = { &no_auto_down_ints, &no_scripts_ints, &rename_ints };
+
+	for (int i = 0; i < 3; i++) {
+		char **items = strings_at(&m, header->lists[i], header->n_lists[i]);
+		append_list(lists[i], counts[i], items, header->n_lists[i]);
+		free(items);
+	}
+
+	no_loopback = header->no_loopback_after;
+
+	/* say what parsing would have said */
+	if (verbose) {
+		const struct cache_file *file_entries = (const struct cache_file *)(m.data + header->files);
+
+		for (uint32_t i = 0; i < header->n_files; i++) {
+			if (file_entries[i].kind == DEPEND_SOURCE)
+				warnx("parsing file %s", m.data + file_entries[i].path);
+			else if (file_entries[i].kind == DEPEND_DIR)
+				warnx("reading directory %s", m.data + file_entries[i].path);
+		}
+	}
+
+	return defn;
+}
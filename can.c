@@ -0,0 +1,146 @@
+#include <stddef.h>
+#include "header.h"
+
+
+#include "archcommon.h"
+#include "archlinux.h"
+
+
+static option_default _static_default[] = {
+	{ NULL, NULL }
+};
+static conversion _static_conv[] = {
+	{ CONVERT_END, NULL, 0, -1, NULL, NULL, 0, NULL }
+};
+static const char *const _static_slot_names[] = {
+	"bitrate",
+	"samplepoint",
+	"loopback",
+	"listenonly",
+	"triple",
+	"oneshot",
+	"berr",
+	"restart-ms",
+	NULL
+};
+static const option_slots _static_slots = { 8, _static_slot_names };
+static const template_op _static_up_0[] = {
+    { TEMPLATE_TEXT, "ip link set ", 12, -1, 0, 0 },
+    { TEMPLATE_VAR, "iface", 5, -1, 0, 0 },
+    { TEMPLATE_TEXT, " type can bitrate ", 18, -1, 0, 0 },
+    { TEMPLATE_VAR, "bitrate", 7, 0, 0, 0 },
+    { TEMPLATE_END, NULL, 0, -1, 0, 0 },
+};
+static const template_op _static_up_1[] = {
+    { TEMPLATE_OPEN, NULL, 0, -1, 0, 0 },
+    { TEMPLATE_TEXT, " ip link set ", 13, -1, 0, 0 },
+    { TEMPLATE_VAR, "iface", 5, -1, 0, 0 },
+    { TEMPLATE_TEXT, " type can loopback ", 19, -1, 0, 0 },
+    { TEMPLATE_VAR, "loopback", 8, 2, 0, 0 },
+    { TEMPLATE_TEXT, " ", 1, -1, 0, 0 },
+    { TEMPLATE_CLOSE, NULL, 0, -1, 0, 0 },
+    { TEMPLATE_END, NULL, 0, -1, 0, 0 },
+};
+static const template_op _static_up_2[] = {
+    { TEMPLATE_OPEN, NULL, 0, -1, 0, 0 },
+    { TEMPLATE_TEXT, " ip link set ", 13, -1, 0, 0 },
+    { TEMPLATE_VAR, "iface", 5, -1, 0, 0 },
+    { TEMPLATE_TEXT, " type can listen-only ", 22, -1, 0, 0 },
+    { TEMPLATE_VAR, "listenonly", 10, 3, 0, 0 },
+    { TEMPLATE_TEXT, " ", 1, -1, 0, 0 },
+    { TEMPLATE_CLOSE, NULL, 0, -1, 0, 0 },
+    { TEMPLATE_END, NULL, 0, -1, 0, 0 },
+};
+static const template_op _static_up_3[] = {
+    { TEMPLATE_OPEN, NULL, 0, -1, 0, 0 },
+    { TEMPLATE_TEXT, " ip link set ", 13, -1, 0, 0 },
+    { TEMPLATE_VAR, "iface", 5, -1, 0, 0 },
+    { TEMPLATE_TEXT, " type can triple-sampling ", 26, -1, 0, 0 },
+    { TEMPLATE_VAR, "triple", 6, 4, 0, 0 },
+    { TEMPLATE_TEXT, " ", 1, -1, 0, 0 },
+    { TEMPLATE_CLOSE, NULL, 0, -1, 0, 0 },
+    { TEMPLATE_END, NULL, 0, -1, 0, 0 },
+};
+static const template_op _static_up_4[] = {
+    { TEMPLATE_OPEN, NULL, 0, -1, 0, 0 },
+    { TEMPLATE_TEXT, " ip link set ", 13, -1, 0, 0 },
+    { TEMPLATE_VAR, "iface", 5, -1, 0, 0 },
+    { TEMPLATE_TEXT, " type can one-shot ", 19, -1, 0, 0 },
+    { TEMPLATE_VAR, "oneshot", 7, 5, 0, 0 },
+    { TEMPLATE_TEXT, " ", 1, -1, 0, 0 },
+    { TEMPLATE_CLOSE, NULL, 0, -1, 0, 0 },
+    { TEMPLATE_END, NULL, 0, -1, 0, 0 },
+};
+static const template_op _static_up_5[] = {
+    { TEMPLATE_OPEN, NULL, 0, -1, 0, 0 },
+    { TEMPLATE_TEXT, " ip link set ", 13, -1, 0, 0 },
+    { TEMPLATE_VAR, "iface", 5, -1, 0, 0 },
+    { TEMPLATE_TEXT, " type can berr-reporting ", 25, -1, 0, 0 },
+    { TEMPLATE_VAR, "berr", 4, 6, 0, 0 },
+    { TEMPLATE_TEXT, " ", 1, -1, 0, 0 },
+    { TEMPLATE_CLOSE, NULL, 0, -1, 0, 0 },
+    { TEMPLATE_END, NULL, 0, -1, 0, 0 },
+};
+static const template_op _static_up_6[] = {
+    { TEMPLATE_OPEN, NULL, 0, -1, 0, 0 },
+    { TEMPLATE_TEXT, " ip link set ", 13, -1, 0, 0 },
+    { TEMPLATE_VAR, "iface", 5, -1, 0, 0 },
+    { TEMPLATE_TEXT, " type can restart-ms ", 21, -1, 0, 0 },
+    { TEMPLATE_VAR, "restart-ms", 10, 7, 0, 0 },
+    { TEMPLATE_TEXT, " ", 1, -1, 0, 0 },
+    { TEMPLATE_CLOSE, NULL, 0, -1, 0, 0 },
+    { TEMPLATE_END, NULL, 0, -1, 0, 0 },
+};
+static const template_op _static_up_7[] = {
+    { TEMPLATE_TEXT, "ip link set ", 12, -1, 0, 0 },
+    { TEMPLATE_VAR, "iface", 5, -1, 0, 0 },
+    { TEMPLATE_TEXT, " up", 3, -1, 0, 0 },
+    { TEMPLATE_END, NULL, 0, -1, 0, 0 },
+};
+static const command_op _static_up_ops[] = {
+	{ COMMAND_LINK_SET, 0, NULL, false, _static_up_0, "ip link set %iface% type can bitrate %bitrate%" },
+	{ COMMAND_LINK_SET, 0, NULL, false, _static_up_1, "[[ ip link set %iface% type can loopback %loopback% ]]" },
+	{ COMMAND_LINK_SET, 0, NULL, false, _static_up_2, "[[ ip link set %iface% type can listen-only %listenonly% ]]" },
+	{ COMMAND_LINK_SET, 0, NULL, false, _static_up_3, "[[ ip link set %iface% type can triple-sampling %triple% ]]" },
+	{ COMMAND_LINK_SET, 0, NULL, false, _static_up_4, "[[ ip link set %iface% type can one-shot %oneshot% ]]" },
+	{ COMMAND_LINK_SET, 0, NULL, false, _static_up_5, "[[ ip link set %iface% type can berr-reporting %berr% ]]" },
+	{ COMMAND_LINK_SET, 0, NULL, false, _static_up_6, "[[ ip link set %iface% type can restart-ms %restart-ms% ]]" },
+	{ COMMAND_LINK_SET, 0, NULL, false, _static_up_7, "ip link set %iface% up" },
+	{ COMMAND_END, 0, NULL, false, NULL, NULL }
+};
+static int _static_up(interface_defn *ifd, execfn *exec) {
+	return execute_ops(_static_up_ops, &_static_slots, ifd, exec);
+}
+static const template_op _static_down_0[] = {
+    { TEMPLATE_TEXT, "ip link set ", 12, -1, 0, 0 },
+    { TEMPLATE_VAR, "iface", 5, -1, 0, 0 },
+    { TEMPLATE_TEXT, " down", 5, -1, 0, 0 },
+    { TEMPLATE_END, NULL, 0, -1, 0, 0 },
+};
+static const command_op _static_down_ops[] = {
+	{ COMMAND_LINK_SET, 0, NULL, false, _static_down_0, "ip link set %iface% down" },
+	{ COMMAND_END, 0, NULL, false, NULL, NULL }
+};
+static int _static_down(interface_defn *ifd, execfn *exec) {
+	return execute_ops(_static_down_ops, &_static_slots, ifd, exec);
+}
+static const command_op _static_rename_ops[] = { { COMMAND_END, 0, NULL, false, NULL, NULL } };
+static int _static_rename(interface_defn *ifd, execfn *exec) { return 0; }
+static method methods[] = {
+        {
+                "static",
+                _static_up, _static_down, _static_rename,
+                _static_conv, _static_default,
+                &_static_slots,
+                _static_up_ops, _static_down_ops, _static_rename_ops,
+        },
+};
+
+static const signed char method_slots[] = { 0 };
+
+address_family addr_can = {
+        "can",
+        sizeof(methods)/sizeof(struct method),
+        methods,
+        { 1, 0, method_slots }
+};
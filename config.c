@@ -1,16 +1,18 @@
 #include <stdbool.h>
 #include <stdlib.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <string.h>
 #include <errno.h>
-#include <assert.h>
 #include <errno.h>
 #include <ctype.h>
 #include <libgen.h>
 #include <wordexp.h>
 #include <dirent.h>
+#include <fcntl.h>
 #include <sys/types.h>
 #include <sys/stat.h>
+#include <sys/mman.h>
 #include <unistd.h>
 #include <err.h>
 
@@ -28,129 +30,202 @@ static const char *keywords[] = {
 	NULL
 };
 
-static int get_line(char **result, size_t *result_len, FILE *f, int *line) {
-	size_t pos;
+/* Set by read_interfaces(), see there */
+static bool lazy;
+
+/*
+ * Interfaces files are mapped (or, when that is not possible, read) whole
+ * and scanned with memchr(). Each logical line is copied once into a buffer
+ * of its own, where continuations are joined and words are terminated in
+ * place; the file itself is never written to.
+ */
+struct scanner {
+	const char *data;
+	size_t size;
+	bool mapped;
+	const char *pos;
+	char *buf;
+	size_t buf_size;
+	int line;
+};
 
-	do {
-		pos = 0;
+/* Read a file that cannot be mapped, such as a pipe, or is not worth mapping */
+static bool read_whole(struct scanner *s, int fd, size_t size_hint) {
+	char *data = NULL;
+	size_t alloc = 0;
+	size_t size = 0;
 
-		do {
-			if (*result_len - pos < 10) {
-				char *newstr = realloc(*result, *result_len * 2 + 80);
-				if (newstr == NULL) {
-					return 0;
-				}
+	if (size_hint) {
+		data = malloc(size_hint);
+		if (!data)
+			err(1, "malloc");
 
-				*result = newstr;
-				*result_len = *result_len * 2 + 80;
-			}
+		alloc = size_hint;
+	}
 
-			if (!fgets(*result + pos, *result_len - pos, f)) {
-				if (ferror(f) == 0 && pos == 0)
-					return 0;
+	for (;;) {
+		if (alloc - size < 4096) {
+			alloc = alloc * 2 + 4096;
 
-				if (ferror(f) != 0)
-					return 0;
-			}
+			char *newdata = realloc(data, alloc);
+			if (!newdata)
+				err(1, "realloc");
 
-			pos += strlen(*result + pos);
-		} while (pos == *result_len - 1 && (*result)[pos - 1] != '\n');
+			data = newdata;
+		}
 
-		if (pos != 0 && (*result)[pos - 1] == '\n')
-			(*result)[--pos] = '\0';
+		ssize_t n = read(fd, data + size, alloc - size);
 
-		(*line)++;
+		if (n < 0 && errno == EINTR)
+			continue;
 
-		assert((*result)[pos] == '\0');
+		if (n < 0) {
+			free(data);
+			return false;
+		}
 
-		int first = 0;
+		if (n == 0)
+			break;
 
-		while (isspace((*result)[first]) && (*result)[first])
-			first++;
+		size += n;
+	}
 
-		memmove(*result, *result + first, pos - first + 1);
-		pos -= first;
-	} while ((*result)[0] == '#');
+	s->data = data;
+	s->size = size;
 
-	while (pos && (*result)[pos - 1] == '\\') {
-		(*result)[--pos] = '\0';
+	return true;
+}
 
-		do {
-			if (*result_len - pos < 10) {
-				char *newstr = realloc(*result, *result_len * 2 + 80);
-				if (newstr == NULL) {
-					return 0;
-				}
+/* Files smaller than this are read, which is cheaper than mapping them */
+#define MAP_MIN_SIZE (32 * 1024)
 
-				*result = newstr;
-				*result_len = *result_len * 2 + 80;
-			}
-			if (!fgets(*result + pos, *result_len - pos, f)) {
-				if (ferror(f) == 0 && pos == 0)
-					return 0;
+/* st gets what fstat() says about the file, or is zeroed if that failed */
+static bool open_scanner(struct scanner *s, int fd, struct stat *st) {
+	*s = (struct scanner) { NULL };
 
-				if (ferror(f) != 0)
-					return 0;
-			}
+	size_t size_hint = 0;
+
+	if (fstat(fd, st) == -1)
+		memset(st, 0, sizeof *st);
+	else if (S_ISREG(st->st_mode) && (uintmax_t)st->st_size < SIZE_MAX - 4096)
+		size_hint = st->st_size + 4096;	/* so that reading ends without growing the buffer */
+
+	if (S_ISREG(st->st_mode) && st->st_size >= MAP_MIN_SIZE && (uintmax_t)st->st_size <= SIZE_MAX) {
+		void *data = mmap(NULL, st->st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+		if (data != MAP_FAILED) {
+			s->data = data;
+			s->size = st->st_size;
+			s->mapped = true;
+		}
+	}
+
+	if (!s->mapped && !read_whole(s, fd, size_hint))
+		return false;
 
-			pos += strlen(*result + pos);
-		} while (pos == *result_len - 1 && (*result)[pos - 1] != '\n');
+	s->pos = s->data;
 
-		if (pos != 0 && (*result)[pos - 1] == '\n')
-			(*result)[--pos] = '\0';
+	return true;
+}
+
+static void close_scanner(struct scanner *s) {
+	if (s->mapped)
+		munmap((void *)s->data, s->size);
+	else
+		free((void *)s->data);
+
+	free(s->buf);
+}
+
+static const char *next_physical_line(struct scanner *s, size_t *len) {
+	const char *end = s->data + s->size;
+
+	if (s->pos >= end)
+		return NULL;
 
-		(*line)++;
+	const char *start = s->pos;
+	const char *nl = memchr(start, '\n', end - start);
 
-		assert((*result)[pos] == '\0');
+	if (!nl)
+		nl = end;
+
+	*len = nl - start;
+	s->pos = nl + 1;
+	s->line++;
+
+	return start;
+}
+
+static void append_line(struct scanner *s, size_t *pos, const char *line, size_t len) {
+	if (*pos + len + 1 > s->buf_size) {
+		s->buf_size = (*pos + len + 1) * 2;
+		s->buf = realloc(s->buf, s->buf_size);
+		if (!s->buf)
+			err(1, "realloc");
+	}
+
+	memcpy(s->buf + *pos, line, len);
+	*pos += len;
+	s->buf[*pos] = '\0';
+}
+
+/* Returns the next line that is not a comment, without surrounding whitespace */
+static char *get_line(struct scanner *s) {
+	const char *line;
+	size_t len;
+
+	do {
+		line = next_physical_line(s, &len);
+		if (!line)
+			return NULL;
+
+		while (len && isspace((unsigned char)*line)) {
+			line++;
+			len--;
+		}
+	} while (len && *line == '#');
+
+	size_t pos = 0;
+
+	append_line(s, &pos, line, len);
+
+	while (pos && s->buf[pos - 1] == '\\') {
+		s->buf[--pos] = '\0';
+
+		if ((line = next_physical_line(s, &len)))
+			append_line(s, &pos, line, len);
 	}
 
-	while (pos && isspace((*result)[pos - 1]))	/* remove trailing whitespace */
+	while (pos && isspace((unsigned char)s->buf[pos - 1]))	/* remove trailing whitespace */
 		pos--;
 
-	(*result)[pos] = '\0';
+	s->buf[pos] = '\0';
 
-	return 1;
+	return s->buf;
 }
 
-static char *next_word(char *buf, char *word, int maxlen) {
+/* Splits off the first word of buf, terminating it in place, and returns the rest */
+static char *next_word(char *buf, char **word) {
 	if (!buf)
 		return NULL;
 
 	if (!*buf)
 		return NULL;
 
-	while (!isspace(*buf) && *buf) {
-		if (maxlen-- > 1)
-			*word++ = *buf;
+	*word = buf;
 
+	while (!isspace((unsigned char)*buf) && *buf)
 		buf++;
-	}
 
-	if (maxlen > 0)
-		*word = '\0';
+	if (*buf)
+		*buf++ = '\0';
 
-	while (isspace(*buf) && *buf)
+	while (isspace((unsigned char)*buf) && *buf)
 		buf++;
 
 	return buf;
 }
 
-static address_family *get_address_family(address_family *af[], const char *name) {
-	for (int i = 0; af[i]; i++)
-		if (strcmp(af[i]->name, name) == 0)
-			return af[i];
-
-	return NULL;
-}
-
-static method *get_method(address_family *af, const char *name) {
-	for (int i = 0; i < af->n_methods; i++)
-		if (strcmp(af->method[i].name, name) == 0)
-			return &af->method[i];
-
-	return NULL;
-}
-
 static keyword get_keyword(const char *word) {
 	for (int i = 0; keywords[i]; i++) {
 		if (strcmp(keywords[i], word) == 0) {
@@ -161,28 +236,21 @@ static keyword get_keyword(const char *word) {
 	return -1;
 }
 
-static allowup_defn *get_allowup(allowup_defn **allowups, const char *name) {
-	for (; *allowups; allowups = &(*allowups)->next)
-		if (strcmp((*allowups)->when, name) == 0)
-			break;
-
-	if (*allowups == NULL) {
-		*allowups = calloc(1, sizeof **allowups);
-		if (*allowups == NULL)
-			err(1, "calloc");
+static allowup_defn *get_allowup(interfaces_file *defn, const char *name) {
+	allowup_defn *allowup = find_allowup(defn, name);
 
-		(*allowups)->when = strdup(name);
-		if ((*allowups)->when == NULL)
-			err(1, "strdup");
+	if (allowup == NULL) {
+		allowup = arena_alloc(sizeof *allowup);
+		allowup->when = intern(name, strlen(name));
+		add_allowup(defn, allowup);
 	}
 
-	return *allowups;
+	return allowup;
 }
 
 static allowup_defn *add_allow_up(const char *filename, int line, allowup_defn *allow_up, const char *iface_name) {
-	for (int i = 0; i < allow_up->n_interfaces; i++)
-		if (strcmp(iface_name, allow_up->interfaces[i]) == 0)
-			return allow_up;
+	if (hash_get(&allow_up->members, iface_name, strlen(iface_name)))
+		return allow_up;
 
 	if (allow_up->n_interfaces == allow_up->max_interfaces) {
 		char **tmp;
@@ -197,89 +265,449 @@ static allowup_defn *add_allow_up(const char *filename, int line, allowup_defn *
 		allow_up->interfaces = tmp;
 	}
 
-	allow_up->interfaces[allow_up->n_interfaces] = strdup(iface_name);
+	allow_up->interfaces[allow_up->n_interfaces] = arena_strdup(iface_name);
+	hash_set(&allow_up->members, allow_up->interfaces[allow_up->n_interfaces], allow_up);
 	allow_up->n_interfaces++;
 
 	return allow_up;
 }
 
-variable *set_variable(const char *name, const char *value, variable **var, int *n_vars, int *max_vars) {
-	/*
-	 * if name ends with '?', don't update
-	 * the variable if it already exists
-	 */
-	bool dont_update = false;
+static variable *new_variable(variable **var, int *n_vars, int *max_vars) {
+	if (*n_vars >= *max_vars) {
+		variable *new_var;
+
+		*max_vars = *max_vars ? *max_vars * 2 : 10;
+		new_var = realloc(*var, sizeof *new_var * *max_vars);
+
+		if (new_var == NULL)
+			err(1, "realloc");
+
+		*var = new_var;
+	}
+
+	(*var)[*n_vars].next_same = -1;
+
+	return &((*var)[(*n_vars)++]);
+}
+
+static variable *append_variable(const char *name, size_t len, const char *value, variable **var, int *n_vars, int *max_vars) {
+	variable *new_var = new_variable(var, n_vars, max_vars);
+
+	new_var->name = intern(name, len);
+	new_var->value = arena_strdup(value);
+
+	return new_var;
+}
+
+/* Options that may be given more than once, and are then all run in order */
+bool multi_valued(const char *name) {
+	return strcmp(name, "pre-up") == 0 || strcmp(name, "up") == 0 || strcmp(name, "down") == 0 || strcmp(name, "post-down") == 0;
+}
+
+void clear_option_index(interface_defn *ifd) {
+	free(ifd->option_index);
+	ifd->option_index = NULL;
+	ifd->n_slots = 0;
+
+	free(ifd->slot_option);
+	ifd->slot_option = NULL;
+	ifd->slotted = NULL;
+}
+
+static option_slot *find_slot(interface_defn *ifd, const char *name, size_t len, uint32_t hash) {
+	size_t mask = ifd->n_slots - 1;
+
+	for (size_t i = hash & mask;; i = (i + 1) & mask) {
+		option_slot *slot = &ifd->option_index[i];
+
+		if (slot->first == -1 || (slot->hash == hash && strncmpz(name, ifd->option[slot->first].name, len) == 0))
+			return slot;
+	}
+}
+
+static void index_option(interface_defn *ifd, int i) {
+	const char *name = ifd->option[i].name;
+	uint32_t hash = hash_string(name, strlen(name));
+	size_t mask = ifd->n_slots - 1;
+	option_slot *slot;
+
+	/* names are interned, so comparing pointers is enough here */
+	for (size_t j = hash & mask;; j = (j + 1) & mask) {
+		slot = &ifd->option_index[j];
+
+		if (slot->first == -1 || ifd->option[slot->first].name == name)
+			break;
+	}
+
+	ifd->option[i].next_same = -1;
+
+	if (slot->first == -1) {
+		*slot = (option_slot) { hash, i, i };
+	} else {
+		ifd->option[slot->last].next_same = i;
+		slot->last = i;
+	}
+}
+
+/* The index is kept at most half full, so probing always ends at an empty slot */
+static void build_option_index(interface_defn *ifd, int n_options) {
+	int n_slots = 16;
+
+	while (n_slots < 2 * n_options)
+		n_slots *= 2;
+
+	free(ifd->option_index);
+	ifd->option_index = malloc(sizeof *ifd->option_index * n_slots);
+	if (!ifd->option_index)
+		err(1, "malloc");
+
+	ifd->n_slots = n_slots;
+
+	for (int i = 0; i < n_slots; i++)
+		ifd->option_index[i].first = -1;
+
+	for (int i = 0; i < ifd->n_options; i++)
+		index_option(ifd, i);
+}
+
+/* Returns the index of the first option called name, or -1 */
+int find_option(interface_defn *ifd, const char *name, size_t len) {
+	if (!ifd->option_index && ifd->n_options >= OPTION_INDEX_MIN)
+		build_option_index(ifd, ifd->n_options);
+
+	if (ifd->option_index) {
+		option_slot *slot = find_slot(ifd, name, len, hash_string(name, len));
+
+		return slot->first;
+	}
+
+	for (int i = 0; i < ifd->n_options; i++)
+		if (strncmpz(name, ifd->option[i].name, len) == 0)
+			return i;
+
+	return -1;
+}
+
+/* Returns the index of the first option in a slot of slots, like find_option() for its name */
+int find_option_slot(interface_defn *ifd, const option_slots *slots, int slot) {
+	if (ifd->slotted != slots) {
+		free(ifd->slot_option);
+		ifd->slot_option = malloc(sizeof *ifd->slot_option * (slots->n_slots + 1));
+		if (!ifd->slot_option)
+			err(1, "malloc");
+
+		for (int i = 0; i < slots->n_slots; i++)
+			ifd->slot_option[i] = find_option(ifd, slots->name[i], strlen(slots->name[i]));
 
+		ifd->slotted = slots;
+	}
+
+	return ifd->slot_option[slot];
+}
+
+/* Returns the index of the next option with the same name as option i, or -1 */
+int next_option(interface_defn *ifd, int i) {
+	if (ifd->option_index)
+		return ifd->option[i].next_same;
+
+	/* names are interned */
+	for (int j = i + 1; j < ifd->n_options; j++)
+		if (ifd->option[i].name == ifd->option[j].name)
+			return j;
+
+	return -1;
+}
+
+static void load_options(interface_defn *ifd);
+
+/* The value of a single-valued option a stanza inherits, or NULL */
+static const char *inherited_option(interface_defn *ifd, const char *name, size_t len) {
+	for (interface_defn *from = ifd->inherits; from; from = from->inherits) {
+		/* a stanza from a file that is parsed eagerly can inherit from a deferred one */
+		load_options(from);
+
+		int i = find_option(from, name, len);
+
+		if (i != -1)
+			return from->option[i].value;
+	}
+
+	return NULL;
+}
+
+static void add_to_index(interface_defn *ifd, int i) {
+	if (ifd->option_index) {
+		if (2 * ifd->n_options > ifd->n_slots)
+			build_option_index(ifd, ifd->n_options);
+		else
+			index_option(ifd, i);
+	}
+
+	/* a slot that was empty may be filled now */
+	if (ifd->slotted) {
+		for (int j = 0; j < ifd->slotted->n_slots; j++) {
+			if (ifd->slot_option[j] == -1 && strcmp(ifd->slotted->name[j], ifd->option[i].name) == 0) {
+				ifd->slot_option[j] = i;
+				break;
+			}
+		}
+	}
+}
+
+/*
+ * Set an option, or add it if it is one of the command lists. With a
+ * name ending in '?', an option that is already set is left alone.
+ */
+variable *set_option(interface_defn *ifd, const char *name, const char *value) {
 	size_t len = strlen(name);
+	bool dont_update = name[len - 1] == '?';
 
-	if (name[len - 1] == '?') {
-		dont_update = true;
+	if (dont_update)
 		len--;
-	}
 
-	if (strcmp(name, "pre-up") != 0 && strcmp(name, "up") != 0 && strcmp(name, "down") != 0 && strcmp(name, "post-down") != 0) {
-		for (int j = 0; j < *n_vars; j++) {
-			if (strncmpz(name, (*var)[j].name, len) == 0) {
-				if (dont_update)
-					return NULL;
+	if (!multi_valued(name)) {
+		int i = find_option(ifd, name, len);
 
-				if ((*var)[j].value == value)
-					return &(*var)[j];
+		if (i == -1 && dont_update && inherited_option(ifd, name, len))
+			return NULL;
 
-				free((*var)[j].value);
-				(*var)[j].value = strdup(value);
+		if (i != -1) {
+			if (dont_update)
+				return NULL;
 
-				if (!(*var)[j].value)
-					err(1, "strdup");
+			variable *var = &ifd->option[i];
 
-				return &((*var)[j]);
+			if (var->value != value) {
+				release_string(var->value);
+				var->value = strdup(value);
+				if (!var->value)
+					err(1, "strdup");
 			}
+
+			return var;
 		}
 	}
 
-	if (*n_vars >= *max_vars) {
-		variable *new_var;
+	variable *var = append_variable(name, len, value, &ifd->option, &ifd->n_options, &ifd->max_options);
 
-		*max_vars += 10;
-		new_var = realloc(*var, sizeof *new_var * *max_vars);
+	add_to_index(ifd, ifd->n_options - 1);
 
-		if (new_var == NULL)
-			err(1, "realloc");
+	return var;
+}
 
-		*var = new_var;
+/* Add an option line of a stanza, with rest being its non-empty value */
+static void parse_option(interface_defn *ifd, const char *name, char *rest) {
+	if (strcmp(name, "post-up") == 0)
+		name = "up";
+
+	if (strcmp(name, "pre-down") == 0)
+		name = "down";
+
+	char *joined = NULL;
+
+	if (!multi_valued(name)) {
+		int i = find_option(ifd, name, strlen(name));
+		const char *inherited = i == -1 ? inherited_option(ifd, name, strlen(name)) : NULL;
+
+		if (i != -1) {
+			size_t l = strlen(ifd->option[i].value);
+
+			ifd->option[i].value = resize_string(ifd->option[i].value, l + strlen(rest) + 2);	/* 2 for NL and NULL */
+			if (!ifd->option[i].value)
+				err(1, "realloc");
+
+			ifd->option[i].value[l] = '\n';
+			strcpy(&(ifd->option[i].value[l + 1]), rest);
+			rest = ifd->option[i].value;
+		} else if (inherited) {
+			/* The same, but the inherited value stays as it is */
+			size_t l = strlen(inherited);
+
+			joined = malloc(l + strlen(rest) + 2);
+			if (!joined)
+				err(1, "malloc");
+
+			memcpy(joined, inherited, l);
+			joined[l] = '\n';
+			strcpy(joined + l + 1, rest);
+			rest = joined;
+		}
 	}
 
-	(*var)[*n_vars].name = strndup(name, len);
-	(*var)[*n_vars].value = strdup(value);
+	set_option(ifd, name, rest);
+	free(joined);
+}
 
-	if (!(*var)[*n_vars].name || !(*var)[*n_vars].value)
-		err(1, "strdup");
+/* Lines starting with these words are not options, see read_interfaces_defn() */
+static stanza_word get_stanza_word(const char *word) {
+	int i = perfect_hash_find(&stanza_word_hash, word);
 
-	(*n_vars)++;
-	return &((*var)[(*n_vars) - 1]);
+	if (i >= 0 && strcmp(stanza_words[i], word) == 0)
+		return i;
+
+	if (strncmp(word, "allow-", 6) == 0 && word[6])
+		return STANZA_ALLOW;
+
+	if (strlmatch(word, "source-dir") == 0)
+		return STANZA_SOURCE_DIRECTORY;
+
+	return STANZA_NONE;
 }
 
-void convert_variables(conversion *conversions, interface_defn *ifd) {
-	for (conversion *c = conversions; c && c->option && c->fn; c++) {
-		if (strcmp(c->option, "iface") == 0) {
-			if (c->newoption) {
-				variable *o = set_variable(c->newoption, ifd->real_iface, &ifd->option, &ifd->n_options, &ifd->max_options);
-				if (o)
-					c->fn(ifd, &o->value, c->argc, c->argv);
-				continue;
-			}
+/*
+ * Parse the option lines of a stanza that read_interfaces() only checked,
+ * those of the stanza it inherits from first. They run from right after
+ * the iface line up to the next line that starts something else; an auto,
+ * allow-, no-auto-down or no-scripts line without names does not.
+ */
+static void load_options(interface_defn *ifd) {
+	stanza_body *body = ifd->body;
+
+	if (!body)
+		return;
+
+	ifd->body = NULL;
+
+	if (ifd->inherits)
+		load_options(ifd->inherits);
+
+	struct scanner s = {
+		.data = body->start,
+		.size = body->end - body->start,
+		.pos = body->start,
+		.line = body->line,
+	};
+	char *buf;
+
+	while ((buf = get_line(&s))) {
+		char *firstword;
+		char *rest = next_word(buf, &firstword);
+
+		if (rest == NULL)
+			continue;
+
+		stanza_word word = get_stanza_word(firstword);
+
+		if (word == STANZA_NONE)
+			parse_option(ifd, firstword, rest);
+		else if (*rest || !(word == STANZA_AUTO || word == STANZA_ALLOW ||
+				    word == STANZA_NO_AUTO_DOWN || word == STANZA_NO_SCRIPTS))
+			break;
+	}
+
+	free(s.buf);
+}
+
+/*
+ * An option a stanza sets itself replaces an inherited one of the same name
+ * where it is, unless the option can have multiple values, and is appended
+ * otherwise. Values are not copied.
+ */
+static void merge_options(interface_defn *flat, interface_defn *ifd) {
+	if (ifd->inherits)
+		merge_options(flat, ifd->inherits);
+
+	for (int j = 0; j < ifd->n_options; j++) {
+		variable *var = &ifd->option[j];
+		int i = multi_valued(var->name) ? -1 : find_option(flat, var->name, strlen(var->name));
+
+		if (i != -1) {
+			flat->option[i].value = var->value;
+		} else {
+			variable *new_var = new_variable(&flat->option, &flat->n_options, &flat->max_options);
+
+			new_var->name = var->name;
+			new_var->value = var->value;
+			add_to_index(flat, flat->n_options - 1);
 		}
+	}
+}
 
-		for (int j = 0; j < ifd->n_options; j++) {
-			if (strcmp(ifd->option[j].name, c->option) == 0) {
-				if (c->newoption) {
-					variable *o = set_variable(c->newoption, ifd->option[j].value, &ifd->option, &ifd->n_options, &ifd->max_options);
-					if (o)
-						c->fn(ifd, &o->value, c->argc, c->argv);
-				} else {
-					variable *o = &(ifd->option[j]);
+/* Fill flat, which has no options yet, with all options of ifd, the inherited ones included */
+void flatten_options(interface_defn *ifd, interface_defn *flat) {
+	int max = 0;
+
+	load_options(ifd);
+
+	for (interface_defn *from = ifd; from; from = from->inherits)
+		max += from->n_options;
+
+	if (max) {
+		flat->option = malloc(sizeof *flat->option * max);
+		if (!flat->option)
+			err(1, "malloc");
+
+		flat->max_options = max;
+
+		if (max >= OPTION_INDEX_MIN)
+			build_option_index(flat, max);
+	}
+
+	merge_options(flat, ifd);
+}
+
+/*
+ * Give a stanza its own copy of the options it inherits, before it is
+ * changed. The stanzas inheriting from it get theirs first, so that they
+ * keep the options it had in the interfaces file.
+ */
+void resolve_options(interface_defn *ifd) {
+	load_options(ifd);
+
+	for (interface_defn *heir = ifd->heirs; heir; heir = heir->next_heir)
+		resolve_options(heir);
+
+	ifd->heirs = NULL;
+
+	if (!ifd->inherits)
+		return;
+
+	interface_defn flat = {0};
+
+	flatten_options(ifd, &flat);
+
+	for (int i = 0; i < flat.n_options; i++)
+		flat.option[i].value = arena_strdup(flat.option[i].value);
+
+	free(ifd->option);
+	clear_option_index(ifd);
+
+	ifd->option = flat.option;
+	ifd->n_options = flat.n_options;
+	ifd->max_options = flat.max_options;
+	ifd->option_index = flat.option_index;
+	ifd->n_slots = flat.n_slots;
+	ifd->inherits = NULL;
+}
+
+void remove_option(interface_defn *ifd, int i) {
+	release_string(ifd->option[i].value);
+
+	ifd->n_options--;
+	memmove(&ifd->option[i], &ifd->option[i + 1], sizeof *ifd->option * (ifd->n_options - i));
+
+	clear_option_index(ifd);
+}
+
+void convert_variables(const method *meth, interface_defn *ifd) {
+	for (conversion *c = meth->conversions; c && c->source != CONVERT_END; c++) {
+		if (c->source == CONVERT_IFACE) {
+			variable *o = set_option(ifd, c->newoption, ifd->real_iface);
+			if (o)
+				c->fn(ifd, &o->value, c->argc, c->argv);
+			continue;
+		}
+
+		int first = c->slot >= 0 ? find_option_slot(ifd, meth->slots, c->slot) : find_option(ifd, c->option, c->option_len);
+
+		for (int j = first; j != -1; j = next_option(ifd, j)) {
+			if (c->newoption) {
+				variable *o = set_option(ifd, c->newoption, ifd->option[j].value);
+				if (o)
 					c->fn(ifd, &o->value, c->argc, c->argv);
-				}
+			} else {
+				variable *o = &(ifd->option[j]);
+				c->fn(ifd, &o->value, c->argc, c->argv);
 			}
 		}
 	}
@@ -296,75 +724,335 @@ static int directory_filter(const struct dirent *d) {
 	return 1;
 }
 
-struct seen_file {
-	struct seen_file *next;
-	char *filename;
-} *seen_files = NULL;
+/* The files read so far, so that none is read twice */
+static hash_table seen_files;
 
 static bool already_seen(const char *filename) {
-	if(seen_files)
-		for(struct seen_file *seen = seen_files; seen; seen = seen->next)
-			if(strcmp(seen->filename, filename) == 0)
-				return true;
+	if (hash_get(&seen_files, filename, strlen(filename)))
+		return true;
+
+	char *copy = arena_strdup(filename);
+
+	hash_set(&seen_files, copy, copy);
+
+	return false;
+}
+
+static void clear_seen(void) {
+	hash_clear(&seen_files);
+}
+
+/* The VLANs of one parent interface, in the order they were defined */
+struct vlan_list {
+	interface_defn *first;
+	interface_defn *last;
+	bool ranges_added;	/* instances of ranges have been appended */
+};
+
+/* Length of the parent name if iface is a VLAN interface, 0 otherwise */
+size_t vlan_parent_len(const char *iface) {
+	const char *dot = strchr(iface, '.');
+
+	return dot ? (size_t)(dot - iface) : 0;
+}
+
+static struct vlan_list *get_vlans(interfaces_file *defn, const char *parent, size_t len) {
+	struct vlan_list *vlans = hash_get(&defn->vlan_index, parent, len);
 
-	struct seen_file *seen = malloc(sizeof *seen);
-	if(!seen)
+	if (!vlans) {
+		vlans = arena_alloc(sizeof *vlans);
+		hash_set(&defn->vlan_index, intern(parent, len), vlans);
+	}
+
+	return vlans;
+}
+
+static void append_vlan(struct vlan_list *vlans, interface_defn *iface) {
+	iface->next_vlan = NULL;
+
+	if (vlans->last)
+		vlans->last->next_vlan = iface;
+	else
+		vlans->first = iface;
+
+	vlans->last = iface;
+}
+
+static void add_vlan(interfaces_file *defn, interface_defn *iface) {
+	size_t len = vlan_parent_len(iface->logical_iface);
+
+	if (len)
+		append_vlan(get_vlans(defn, iface->logical_iface, len), iface);
+}
+
+/* Parse a name with a {first..last} range of numbers in it */
+bool parse_range(const char *name, name_range *range) {
+	const char *open = strchr(name, '{');
+	char *end;
+
+	if (!open || !isdigit((unsigned char)open[1]))
+		return false;
+
+	long first = strtol(open + 1, &end, 10);
+
+	if (strncmp(end, "..", 2) != 0 || !isdigit((unsigned char)end[2]))
+		return false;
+
+	long last = strtol(end + 2, &end, 10);
+
+	/* a digit right after the range would make the numbers ambiguous */
+	if (*end != '}' || first > last || isdigit((unsigned char)end[1]) || strchr(end + 1, '{'))
+		return false;
+
+	*range = (name_range) {
+		.prefix_len = open - name,
+		.suffix = end + 1,
+		.first = first,
+		.last = last,
+	};
+
+	return true;
+}
+
+/* The name of instance i of a range */
+char *range_name(const char *name, const name_range *range, long i) {
+	size_t size = range->prefix_len + 21 + strlen(range->suffix) + 1;
+	char *result = malloc(size);
+	if (!result)
 		err(1, "malloc");
 
-	seen->filename = strdup(filename);
-	if(!seen->filename)
-		err(1, "strdup");
+	snprintf(result, size, "%.*s%ld%s", (int)range->prefix_len, name, i, range->suffix);
 
-	seen->next = seen_files;
-	seen_files = seen;
+	return result;
+}
+
+/* Return true if name is an instance of a range, with suffix_len characters of its suffix */
+static bool range_index(const char *name, const char *pattern, const name_range *range, size_t suffix_len, long *i) {
+	if (strncmp(name, pattern, range->prefix_len) != 0)
+		return false;
+
+	const char *digits = name + range->prefix_len;
+	char *end;
+
+	if (!isdigit((unsigned char)*digits) || (digits[0] == '0' && isdigit((unsigned char)digits[1])))
+		return false;
+
+	*i = strtol(digits, &end, 10);
+
+	return strncmpz(range->suffix, end, suffix_len) == 0 && *i >= range->first && *i <= range->last;
+}
+
+/* Return true if name is one of the names of a pattern with a range in it */
+bool in_range(const char *pattern, const char *name) {
+	name_range range;
+	long i;
+
+	return parse_range(pattern, &range) && range_index(name, pattern, &range, strlen(range.suffix), &i);
+}
+
+/* Copy a value of a range stanza with %i% replaced by the number of the instance */
+static char *expand_index(const char *value, const char *number) {
+	size_t n = 0;
+
+	for (const char *p = strstr(value, "%i%"); p; p = strstr(p + 3, "%i%"))
+		n++;
+
+	if (!n)
+		return arena_strdup(value);
+
+	char *result = arena_alloc(strlen(value) + n * strlen(number) + 1);
+	char *out = result;
+	const char *p;
 
+	while ((p = strstr(value, "%i%"))) {
+		memcpy(out, value, p - value);
+		out = stpcpy(out + (p - value), number);
+		value = p + 3;
+	}
+
+	strcpy(out, value);
+
+	return result;
+}
+
+static interface_defn *lookup_interface(interfaces_file *defn, const char *name) {
+	return hash_get(&defn->iface_index, name, strlen(name));
+}
+
+/* Returns true if iface is the first stanza with its name */
+static bool index_interface(interfaces_file *defn, interface_defn *iface) {
+	interface_defn *first = lookup_interface(defn, iface->logical_iface);
+
+	iface->next_same = NULL;
+
+	if (!first) {
+		hash_set(&defn->iface_index, iface->logical_iface, iface);
+		return true;
+	}
+
+	while (first->next_same)
+		first = first->next_same;
+
+	first->next_same = iface;
 	return false;
 }
 
-static void clear_seen(void) {
-	while(seen_files) {
-		struct seen_file *seen = seen_files;
-		seen_files = seen->next;
-		free(seen->filename);
-		free(seen);
+static void add_instance(interfaces_file *defn, interface_defn *range, const char *name, long i) {
+	interface_defn *iface = arena_alloc(sizeof *iface);
+	char number[24];
+
+	snprintf(number, sizeof number, "%ld", i);
+
+	iface->logical_iface = arena_strdup(name);
+	iface->address_family = range->address_family;
+	iface->method = range->method;
+
+	flatten_options(range, iface);
+
+	for (int j = 0; j < iface->n_options; j++)
+		iface->option[j].value = expand_index(iface->option[j].value, number);
+
+	/* instances are not stanzas of the file, and join the VLANs in find_vlans() */
+	index_interface(defn, iface);
+}
+
+/* Add the instances of all ranges that name is in, the first time it is looked up */
+static void add_instances(interfaces_file *defn, const char *name) {
+	size_t len = strlen(name);
+
+	if (hash_get(&defn->instantiated, name, len))
+		return;
+
+	hash_set(&defn->instantiated, intern(name, len), defn);
+
+	for (interface_defn *range = defn->ranges; range; range = range->next_range) {
+		name_range r;
+		long i;
+
+		parse_range(range->logical_iface, &r);
+
+		if (range_index(name, range->logical_iface, &r, strlen(r.suffix), &i))
+			add_instance(defn, range, name, i);
 	}
 }
 
-static interface_defn *get_interface(interfaces_file *defn, const char *iface, const char *addr_fam) {
-	for (interface_defn *currif = defn->ifaces; currif; currif = currif->next) {
-		if (strcmp(iface, currif->logical_iface) == 0) {
-			/* addr_fam == NULL matches any address family */
-			if ((addr_fam == NULL) || (strcmp(addr_fam, currif->address_family->name) == 0))
-				return currif;
+/* Append the stanzas of a range instance to the VLANs of its parent, unless they are already there */
+static void append_instance(interfaces_file *defn, struct vlan_list *vlans, const char *name) {
+	add_instances(defn, name);
+
+	interface_defn *first = lookup_interface(defn, name);
+
+	if (first && !first->next_vlan && first != vlans->last)
+		append_vlan(vlans, first);
+}
+
+/* Add the instances of a range that are VLANs of parent, in the order of their numbers */
+static void add_range_vlans(interfaces_file *defn, interface_defn *range, const char *parent, struct vlan_list *vlans) {
+	const char *pattern = range->logical_iface;
+	const char *dot;
+	name_range r;
+	long i;
+
+	parse_range(pattern, &r);
+
+	if ((dot = memchr(pattern, '.', r.prefix_len))) {
+		if (strncmpz(pattern, parent, dot - pattern) != 0)
+			return;
+
+		for (i = r.first; i <= r.last; i++) {
+			char *name = range_name(pattern, &r, i);
+			append_instance(defn, vlans, name);
+			free(name);
 		}
+	} else if ((dot = strchr(r.suffix, '.'))) {
+		if (!range_index(parent, pattern, &r, dot - r.suffix, &i))
+			return;
+
+		char *name = range_name(pattern, &r, i);
+		append_instance(defn, vlans, name);
+		free(name);
 	}
-	return NULL;
 }
 
-static interface_defn *copy_variables(interface_defn *destif, interface_defn *srcif) {
-	if (srcif->n_options > destif->max_options) {
-		variable *new_option;
-		new_option = realloc(destif->option, sizeof *new_option * srcif->n_options);
+/*
+ * Returns the first VLAN stanza of a parent interface, the others follow via
+ * next_vlan. Instances of ranges come after the explicit stanzas.
+ */
+interface_defn *find_vlans(interfaces_file *defn, const char *parent) {
+	size_t len = strlen(parent);
+	struct vlan_list *vlans;
 
-		if (new_option == NULL)
-			err(1, "realloc");
+	if (defn->ranges) {
+		vlans = get_vlans(defn, parent, len);
+
+		if (!vlans->ranges_added) {
+			vlans->ranges_added = true;
 
-		destif->option = new_option;
-		destif->max_options = srcif->n_options;
+			for (interface_defn *range = defn->ranges; range; range = range->next_range)
+				add_range_vlans(defn, range, parent, vlans);
+		}
+	} else {
+		vlans = hash_get(&defn->vlan_index, parent, len);
 	}
 
-	for (int i = 0; i < srcif->n_options; i++) {
-		destif->option[i].name = strdup(srcif->option[i].name);
-		if (!destif->option[i].name)
-			err(1, "strdup");
+	return vlans ? vlans->first : NULL;
+}
+
+/* Returns the first stanza for a logical interface, the others follow via next_same */
+interface_defn *find_interface(interfaces_file *defn, const char *name) {
+	if (defn->ranges)
+		add_instances(defn, name);
+
+	return lookup_interface(defn, name);
+}
 
-		destif->option[i].value = strdup(srcif->option[i].value);
-		if (!destif->option[i].value)
-			err(1, "strdup");
+void add_interface(interfaces_file *defn, interface_defn *iface) {
+	iface->next = NULL;
+
+	if (defn->last_iface)
+		defn->last_iface->next = iface;
+	else
+		defn->ifaces = iface;
+
+	defn->last_iface = iface;
+
+	name_range range;
+
+	/* Ranges are only instantiated for the names that are looked up */
+	if (parse_range(iface->logical_iface, &range)) {
+		iface->next_range = NULL;
+
+		if (defn->last_range)
+			defn->last_range->next_range = iface;
+		else
+			defn->ranges = iface;
+
+		defn->last_range = iface;
+		return;
 	}
-	destif->n_options = srcif->n_options;
 
-	return destif;
+	if (index_interface(defn, iface))
+		add_vlan(defn, iface);
+}
+
+void add_mapping(interfaces_file *defn, mapping_defn *map) {
+	map->next = NULL;
+
+	if (defn->last_mapping)
+		defn->last_mapping->next = map;
+	else
+		defn->mappings = map;
+
+	defn->last_mapping = map;
+}
+
+static interface_defn *get_interface(interfaces_file *defn, const char *iface, const char *addr_fam) {
+	for (interface_defn *currif = lookup_interface(defn, iface); currif; currif = currif->next_same) {
+		/* addr_fam == NULL matches any address family */
+		if ((addr_fam == NULL) || (strcmp(addr_fam, currif->address_family->name) == 0))
+			return currif;
+	}
+	return NULL;
 }
 
 static void add_to_list(char ***list, int *count, const char *item) {
@@ -378,39 +1066,165 @@ static void add_to_list(char ***list, int *count, const char *item) {
 		err(1, "strdup");
 }
 
+/* Returns false if name has a range with more than MAX_RANGE_NAMES names in it */
+static bool check_range(const char *filename, int line, const char *name) {
+	name_range range;
+
+	if (parse_range(name, &range) && range.last - range.first >= MAX_RANGE_NAMES) {
+		warnx("%s:%d: range with more than %d names", filename, line, MAX_RANGE_NAMES);
+		return false;
+	}
+
+	return true;
+}
+
+/*
+ * Move past the lines that get_line() would return as an option with a
+ * value, without copying them, for stanzas whose options are deferred.
+ * Anything else is left to get_line(), as are continued lines.
+ */
+static void skip_options(struct scanner *s) {
+	const char *end = s->data + s->size;
+
+	while (s->pos < end) {
+		const char *p = s->pos;
+		const char *nl = memchr(p, '\n', end - p);
+
+		if (!nl)
+			nl = end;
+
+		while (p < nl && isspace((unsigned char)*p))
+			p++;
+
+		if (p < nl && *p != '#') {
+			char word[32];
+			size_t len = 0;
+
+			while (p + len < nl && !isspace((unsigned char)p[len]))
+				len++;
+
+			const char *rest = p + len;
+
+			while (rest < nl && isspace((unsigned char)*rest))
+				rest++;
+
+			if (nl[-1] == '\\' || rest == nl || len >= sizeof word)
+				return;
+
+			memcpy(word, p, len);
+			word[len] = '\0';
+
+			if (get_stanza_word(word) != STANZA_NONE)
+				return;
+		}
+
+		s->pos = nl + 1;
+		s->line++;
+	}
+}
+
+/* A file to parse, opened and read by open_fragment() */
+struct fragment {
+	const char *filename;
+	bool opened;
+	int error;		/* errno of opening or reading the file, if that failed */
+	struct stat st;		/* from fstat(), once opened */
+	struct scanner s;	/* if opened and read */
+};
+
+static void open_fragment(struct fragment *f) {
+	int fd = open(f->filename, O_RDONLY | O_CLOEXEC);
+
+	if (fd == -1) {
+		f->error = errno;
+		return;
+	}
+
+	f->opened = true;
+
+	if (!open_scanner(&f->s, fd, &f->st))
+		f->error = errno;
+
+	close(fd);
+}
+
+static interfaces_file *parse_fragment(interfaces_file *defn, struct fragment *f);
+
+/* Read the files that a source or source-directory line expanded to */
+static void read_files(interfaces_file *defn, char **paths, int n_paths, bool may_be_absent) {
+	for (int i = 0; i < n_paths; i++) {
+		struct fragment f = { .filename = paths[i] };
+
+		open_fragment(&f);
+
+		if (may_be_absent && !f.opened && f.error == ENOENT) {
+			cache_depend(f.filename, DEPEND_ABSENT);
+			continue;
+		}
+
+		cache_depend_stat(f.filename, DEPEND_SOURCE, f.opened ? &f.st : NULL);
+
+		if (verbose)
+			warnx("parsing file %s", f.filename);
+
+		if (!parse_fragment(defn, &f))
+			cache_disable();
+	}
+}
+
 static interfaces_file *read_interfaces_defn(interfaces_file *defn, const char *filename) {
-	FILE *f;
-	int line;
-	char *buf = NULL;
-	size_t buf_len = 0;
+	struct fragment f = { .filename = filename };
+
+	open_fragment(&f);
+
+	return parse_fragment(defn, &f);
+}
+
+static interfaces_file *parse_fragment(interfaces_file *defn, struct fragment *f) {
+	const char *filename = f->filename;
+	struct scanner s = f->s;
+	char *buf;
 	interface_defn *currif = NULL;
 	mapping_defn *currmap = NULL;
 	enum { NONE, IFACE, MAPPING } currently_processing = NONE;
-	char firstword[80];
+	char *firstword;
 	char *rest;
+	bool deferred = false;
 
-	if(already_seen(filename))
-		return NULL;
+	if (already_seen(filename)) {
+		if (f->opened && !f->error)
+			close_scanner(&s);
 
-	f = fopen(filename, "r");
-	if (f == NULL) {
+		return defn;
+	}
+
+	if (!f->opened) {
+		errno = f->error;
 		warn("couldn't open interfaces file \"%s\"", filename);
+		cache_disable();
 		return defn;
 	}
 
-	line = 0;
+	if (f->error) {
+		errno = f->error;
+		warn("%s", filename);
+		return NULL;
+	}
+
+	/* options can only be parsed later from a file that stays mapped */
+	bool defer = lazy && s.mapped;
 
-	while (get_line(&buf, &buf_len, f, &line)) {
-		rest = next_word(buf, firstword, 80);
+	while ((buf = get_line(&s))) {
+		rest = next_word(buf, &firstword);
 		if (rest == NULL)
 			continue;	/* blank line */
 
-		if (strcmp(firstword, "mapping") == 0) {
-			currmap = calloc(1, sizeof *currmap);
-			if (currmap == NULL)
-				err(1, "calloc");
+		stanza_word word = get_stanza_word(firstword);
+
+		if (word == STANZA_MAPPING) {
+			currmap = arena_alloc(sizeof *currmap);
 
-			while ((rest = next_word(rest, firstword, 80))) {
+			while ((rest = next_word(rest, &firstword))) {
 				if (currmap->max_matches == currmap->n_matches) {
 					char **tmp;
 
@@ -421,19 +1235,13 @@ static interfaces_file *read_interfaces_defn(interfaces_file *defn, const char *
 					currmap->match = tmp;
 				}
 
-				currmap->match[currmap->n_matches++] = strdup(firstword);
+				currmap->match[currmap->n_matches++] = arena_strdup(firstword);
 			}
 
-			mapping_defn **where = &defn->mappings;
-
-			while (*where != NULL)
-				where = &(*where)->next;
-
-			*where = currmap;
-			currmap->next = NULL;
+			add_mapping(defn, currmap);
 
 			currently_processing = MAPPING;
-		} else if (strcmp(firstword, "source") == 0) {
+		} else if (word == STANZA_SOURCE) {
 			char *filename_dup = strdup(filename);
 			if (filename_dup == NULL)
 				err(1, "strdup");
@@ -468,34 +1276,21 @@ static interfaces_file *read_interfaces_defn(interfaces_file *defn, const char *
 			}
 
 			strcat(pattern, rest);
+			cache_depend_pattern(pattern);
 
 			wordexp_t p;
 			int fail = wordexp(pattern, &p, WRDE_NOCMD);
 
 			if (!fail) {
-				char **w = p.we_wordv;
-
-				for (size_t i = 0; i < p.we_wordc; i++) {
-					struct stat sb;
-
-					if (stat(w[i], &sb) == -1)
-						/* wordexp can't expand * in an empty dir */
-						if (errno == ENOENT)
-							continue;
-
-					if (verbose)
-						warnx("parsing file %s", w[i]);
-
-					read_interfaces_defn(defn, w[i]);
-				}
-
+				/* wordexp can't expand * in an empty dir, so the pattern itself may be absent */
+				read_files(defn, p.we_wordv, p.we_wordc, true);
 				wordfree(&p);
 			}
 
 			free(pattern);
 			free(dir);
 			currently_processing = NONE;
-		} else if (strlmatch(firstword, "source-dir") == 0) {
+		} else if (word == STANZA_SOURCE_DIRECTORY) {
 			char *filename_dup = strdup(filename);
 			if (filename_dup == NULL)
 				err(1, "strdup");
@@ -530,6 +1325,7 @@ static interfaces_file *read_interfaces_defn(interfaces_file *defn, const char *
 			}
 
 			strcat(pattern, rest);
+			cache_depend_pattern(pattern);
 
 			wordexp_t p;
 			int fail = wordexp(pattern, &p, WRDE_NOCMD);
@@ -540,30 +1336,44 @@ static interfaces_file *read_interfaces_defn(interfaces_file *defn, const char *
 					struct dirent **namelist;
 					int n = scandir(w[i], &namelist, directory_filter, alphasort);
 
+					if (n < 0) {
+						if (errno == ENOENT)
+							cache_depend(w[i], DEPEND_ABSENT);
+						else
+							cache_disable();
+					}
+
 					if (n >= 0) {
+						cache_depend(w[i], DEPEND_DIR);
+
 						if (verbose)
 							warnx("reading directory %s", w[i]);
 
 						size_t ll = strlen(w[i]);
+						char **names = malloc((n + 1) * sizeof *names);
+						if (names == NULL)
+							err(1, "malloc");
 
 						for (int j = 0; j < n; j++) {
 							size_t s = ll + strlen(namelist[j]->d_name) + 2;	/* + slash + NUL */
 
-							char *name = malloc(s);
-							if (name == NULL)
+							names[j] = malloc(s);
+							if (names[j] == NULL)
 								err(1, "malloc");
 
-							name[0] = '\0';
-							strcat(name, w[i]);
-							strcat(name, "/");
-							strcat(name, namelist[j]->d_name);
-
-							if (verbose)
-								warnx("parsing file %s", name);
-							read_interfaces_defn(defn, name);
-							free(name);
+							names[j][0] = '\0';
+							strcat(names[j], w[i]);
+							strcat(names[j], "/");
+							strcat(names[j], namelist[j]->d_name);
+							free(namelist[j]);
 						}
 
+						read_files(defn, names, n, false);
+
+						for (int j = 0; j < n; j++)
+							free(names[j]);
+
+						free(names);
 						free(namelist);
 					}
 				}
@@ -573,38 +1383,32 @@ static interfaces_file *read_interfaces_defn(interfaces_file *defn, const char *
 			free(pattern);
 			free(dir);
 			currently_processing = NONE;
-		} else if (strcmp(firstword, "iface") == 0) {
-			char iface_name[80];
-			char address_family_name[80];
-			char method_name[80];
-			char inherits[80];
+		} else if (word == STANZA_IFACE) {
+			char *iface_name;
+			char *address_family_name = NULL;
+			char *method_name = NULL;
+			char *inherits;
 			keyword kw = NIL;
 
-			currif = malloc(sizeof *currif);
-			if (!currif)
-				err(1, "malloc");
-
-			*currif = (interface_defn) {
-				.max_options = 0,
-				.n_options = 0,
-				.option = NULL,
-			};
+			currif = arena_alloc(sizeof *currif);
 
-			rest = next_word(rest, iface_name, 80);
+			rest = next_word(rest, &iface_name);
 			if (rest == NULL) {
-				warnx("%s:%d: too few parameters for iface line", filename, line);
-				free(currif);
+				warnx("%s:%d: too few parameters for iface line", filename, s.line);
 				return NULL;
 			}
 
-			rest = next_word(rest, address_family_name, 80);
+			if (!check_range(filename, s.line, iface_name))
+				return NULL;
+
+			rest = next_word(rest, &address_family_name);
 
 			if (rest != NULL) {
-				currif->address_family = get_address_family(addr_fams, address_family_name);
+				currif->address_family = get_address_family(address_family_name);
 				if (currif->address_family == NULL) {
 					kw = get_keyword(address_family_name);
 				} else {
-					rest = next_word(rest, method_name, 80);
+					rest = next_word(rest, &method_name);
 					if (rest != NULL) {
 						currif->method = get_method(currif->address_family, method_name);
 						if (currif->method == NULL) {
@@ -615,46 +1419,42 @@ static interfaces_file *read_interfaces_defn(interfaces_file *defn, const char *
 			}
 
 			if ((currif->address_family == NULL) && (kw == NIL)) {
-				warnx("%s:%d: unknown or no address type and no inherits keyword specified", filename, line);
-				free(currif);
+				warnx("%s:%d: unknown or no address type and no inherits keyword specified", filename, s.line);
 				return NULL;
 			}
 
 			if ((currif->method == NULL) && (kw == NIL)) {
-				warnx("%s:%d: unknown or no method and no inherits keyword specified", filename, line);
-				free(currif);
+				warnx("%s:%d: unknown or no method and no inherits keyword specified", filename, s.line);
 				return NULL;	/* FIXME */
 			}
 
 			if (kw == NIL) {
-				rest = next_word(rest, inherits, 80);
+				rest = next_word(rest, &inherits);
 				if (rest != NULL) {
 					kw = get_keyword(inherits);
 					if (kw == NIL) {
-						warnx("%s:%d: extra parameter for the iface line not understood and ignored: %s", filename, line, inherits);
+						warnx("%s:%d: extra parameter for the iface line not understood and ignored: %s", filename, s.line, inherits);
+						cache_disable();
 					}
 				}
 			}
 
 			if (kw != NIL) {
-				rest = next_word(rest, inherits, 80);
+				rest = next_word(rest, &inherits);
 				if (rest == NULL) {
-					warnx("%s:%d: '%s' keyword is missing a parameter", filename, line, keywords[kw]);
-					free(currif);
+					warnx("%s:%d: '%s' keyword is missing a parameter", filename, s.line, keywords[kw]);
 					return NULL;
 				}
 				if (kw == INHERITS) {
 					interface_defn *otherif = get_interface(defn, inherits, currif->address_family ? address_family_name : NULL);
 					if (otherif == NULL) {
-						warnx("%s:%d: unknown iface to inherit from: %s (%s)", filename, line, inherits, currif->address_family ? address_family_name : "*");
-						free(currif);
+						warnx("%s:%d: unknown iface to inherit from: %s (%s)", filename, s.line, inherits, currif->address_family ? address_family_name : "*");
 						return NULL;
 					}
 
-					if (copy_variables(currif, otherif) == NULL) {
-						free(currif);
-						return NULL;
-					}
+					currif->inherits = otherif;
+					currif->next_heir = otherif->heirs;
+					otherif->heirs = currif;
 
 					if (currif->address_family == NULL) {
 						currif->address_family = otherif->address_family;
@@ -666,107 +1466,109 @@ static interfaces_file *read_interfaces_defn(interfaces_file *defn, const char *
 				}
 			}
 
-			currif->logical_iface = strdup(iface_name);
-			if (!currif->logical_iface)
-				err(1, "strdup");
-
-			if (((!strcmp(address_family_name, "inet")) || (!strcmp(address_family_name, "inet6"))) && (!strcmp(method_name, "loopback")))
-				no_loopback = true;
-
-			interface_defn **where = &defn->ifaces;
+			currif->logical_iface = arena_strdup(iface_name);
 
-			while (*where != NULL) {
-				where = &(*where)->next;
+			if (defer) {
+				currif->body = arena_alloc(sizeof *currif->body);
+				*currif->body = (stanza_body) {
+					.start = s.pos,
+					.end = s.data + s.size,
+					.line = s.line,
+				};
+				deferred = true;
 			}
 
-			*where = currif;
-			currif->next = NULL;
+			if (address_family_name && method_name && ((!strcmp(address_family_name, "inet")) || (!strcmp(address_family_name, "inet6"))) && (!strcmp(method_name, "loopback")))
+				no_loopback = true;
+
+			add_interface(defn, currif);
 			currently_processing = IFACE;
-		} else if (strcmp(firstword, "auto") == 0) {
-			allowup_defn *auto_ups = get_allowup(&defn->allowups, "auto");
+
+			if (currif->body)
+				skip_options(&s);
+		} else if (word == STANZA_AUTO) {
+			allowup_defn *auto_ups = get_allowup(defn, "auto");
 
 			if ((!rest || !*rest) && currently_processing == IFACE) {
-				add_allow_up(filename, line, auto_ups, currif->logical_iface);
+				add_allow_up(filename, s.line, auto_ups, currif->logical_iface);
 			} else {
-				while ((rest = next_word(rest, firstword, 80)))
-					add_allow_up(filename, line, auto_ups, firstword);
+				while ((rest = next_word(rest, &firstword))) {
+					if (!check_range(filename, s.line, firstword))
+						return NULL;
+
+					add_allow_up(filename, s.line, auto_ups, firstword);
+				}
 
 				currently_processing = NONE;
 			}
-		} else if (strncmp(firstword, "allow-", 6) == 0 && strlen(firstword) > 6) {
-			allowup_defn *allow_ups = get_allowup(&defn->allowups, firstword + 6);
+		} else if (word == STANZA_ALLOW) {
+			allowup_defn *allow_ups = get_allowup(defn, firstword + 6);
 
 			if ((!rest || !*rest) && currently_processing == IFACE) {
-				add_allow_up(filename, line, allow_ups, currif->logical_iface);
+				add_allow_up(filename, s.line, allow_ups, currif->logical_iface);
 			} else {
-				while ((rest = next_word(rest, firstword, 80)))
-					add_allow_up(filename, line, allow_ups, firstword);
+				while ((rest = next_word(rest, &firstword))) {
+					if (!check_range(filename, s.line, firstword))
+						return NULL;
+
+					add_allow_up(filename, s.line, allow_ups, firstword);
+				}
 
 				currently_processing = NONE;
 			}
-		} else if (strcmp(firstword, "no-auto-down") == 0) {
+		} else if (word == STANZA_NO_AUTO_DOWN) {
 			if ((!rest || !*rest) && currently_processing == IFACE) {
 				add_to_list(&no_auto_down_int, &no_auto_down_ints, currif->logical_iface);
 			} else {
-				while ((rest = next_word(rest, firstword, 80)))
+				while ((rest = next_word(rest, &firstword))) {
+					if (!check_range(filename, s.line, firstword))
+						return NULL;
+
 					add_to_list(&no_auto_down_int, &no_auto_down_ints, firstword);
+				}
 
 				currently_processing = NONE;
 			}
-		} else if (strcmp(firstword, "no-scripts") == 0) {
+		} else if (word == STANZA_NO_SCRIPTS) {
 			if ((!rest || !*rest) && currently_processing == IFACE) {
 				add_to_list(&no_scripts_int, &no_scripts_ints, currif->logical_iface);
 			} else {
-				while ((rest = next_word(rest, firstword, 80)))
+				while ((rest = next_word(rest, &firstword))) {
+					if (!check_range(filename, s.line, firstword))
+						return NULL;
+
 					add_to_list(&no_scripts_int, &no_scripts_ints, firstword);
+				}
 
 				currently_processing = NONE;
 			}
-		} else if (strcmp(firstword, "rename") == 0) {
-			while ((rest = next_word(rest, firstword, 80)))
+		} else if (word == STANZA_RENAME) {
+			while ((rest = next_word(rest, &firstword)))
 				add_to_list(&rename_int, &rename_ints, firstword);
 
 			currently_processing = NONE;
 		} else {
 			switch (currently_processing) {
 			case IFACE:
-				if (strcmp(firstword, "post-up") == 0)
-					strcpy(firstword, "up");
-
-				if (strcmp(firstword, "pre-down") == 0)
-					strcpy(firstword, "down");
-
 				if (strlen(rest) == 0) {
-					warnx("%s:%d: option with empty value", filename, line);
+					warnx("%s:%d: option with empty value", filename, s.line);
 					return NULL;
 				}
 
-				if (strcmp(firstword, "pre-up") != 0 && strcmp(firstword, "up") != 0 && strcmp(firstword, "down") != 0 && strcmp(firstword, "post-down") != 0) {
-					for (int i = 0; i < currif->n_options; i++) {
-						if (strcmp(currif->option[i].name, firstword) == 0) {
-							size_t l = strlen(currif->option[i].value);
-
-							currif->option[i].value = realloc(currif->option[i].value, l + strlen(rest) + 2);	/* 2 for NL and NULL */
-							if (!currif->option[i].value)
-								err(1, "realloc");
-
-							currif->option[i].value[l] = '\n';
-							strcpy(&(currif->option[i].value[l + 1]), rest);
-							rest = currif->option[i].value;
-						}
-					}
-				}
-
-				set_variable(firstword, rest, &currif->option, &currif->n_options, &currif->max_options);
+				/* deferred options are checked, but parsed in load_options() */
+				if (currif->body)
+					skip_options(&s);
+				else
+					parse_option(currif, firstword, rest);
 				break;
 
 			case MAPPING:
 				if (strcmp(firstword, "script") == 0) {
 					if (currmap->script != NULL) {
-						warnx("%s:%d: duplicate script in mapping", filename, line);
+						warnx("%s:%d: duplicate script in mapping", filename, s.line);
 						return NULL;
 					} else {
-						currmap->script = strdup(rest);
+						currmap->script = arena_strdup(rest);
 					}
 				} else if (strcmp(firstword, "map") == 0) {
 					if (currmap->max_mappings == currmap->n_mappings) {
@@ -780,74 +1582,108 @@ static interfaces_file *read_interfaces_defn(interfaces_file *defn, const char *
 						currmap->mapping = opt;
 					}
 
-					currmap->mapping[currmap->n_mappings] = strdup(rest);
+					currmap->mapping[currmap->n_mappings] = arena_strdup(rest);
 					currmap->n_mappings++;
 				} else {
-					warnx("%s:%d: misplaced option", filename, line);
+					warnx("%s:%d: misplaced option", filename, s.line);
 					return NULL;
 				}
 				break;
 
 			case NONE:
 			default:
-				warnx("%s:%d: misplaced option", filename, line);
+				warnx("%s:%d: misplaced option", filename, s.line);
 				return NULL;
 			}
 		}
 	}
 
-	if (ferror(f) != 0) {
-		warn("%s", filename);
-		return NULL;
+	if (deferred) {
+		/* the deferred options still point into it */
+		arena_adopt((void *)s.data, s.size);
+		free(s.buf);
+	} else {
+		close_scanner(&s);
 	}
 
-	fclose(f);
-	line = -1;
-
-	free(buf);
-
 	return defn;
 }
 
-interfaces_file *read_interfaces(const char *filename) {
+/*
+ * With lazy set, the options of iface stanzas are only checked, and parsed
+ * once something needs them. That is much less work for runs that only
+ * use a few stanzas, but the result cannot be cached.
+ */
+interfaces_file *read_interfaces(const char *filename, const char *cachefile, bool lazy_options) {
 	interfaces_file *defn;
 
-	defn = calloc(1, sizeof *defn);
-	if (defn == NULL)
-		return NULL;
+	defn = cache_load(cachefile, filename);
+	if (defn)
+		return defn;
+
+	bool no_loopback_before = no_loopback;
+	int first_in_list[3] = { no_auto_down_ints, no_scripts_ints, rename_ints };
+
+	cache_begin();
+	cache_depend(filename, DEPEND_FILE);
+
+	lazy = lazy_options;
+
+	if (lazy)
+		cache_disable();
+
+	defn = arena_alloc(sizeof *defn);
 
 	if (!no_loopback)
-		add_allow_up(__FILE__, __LINE__, get_allowup(&defn->allowups, "auto"), LO_IFACE);
+		add_allow_up(__FILE__, __LINE__, get_allowup(defn, "auto"), LO_IFACE);
 
 	defn = read_interfaces_defn(defn, filename);
 	if (!defn)
 		return NULL;
 
 	if (!no_loopback) {
-		interface_defn *lo_if = malloc(sizeof *lo_if);
-
-		if (!lo_if)
-			err(1, "malloc");
+		interface_defn *lo_if = arena_alloc(sizeof *lo_if);
 
 		*lo_if = (interface_defn) {
-			.logical_iface = strdup(LO_IFACE),
+			.logical_iface = arena_strdup(LO_IFACE),
 			.address_family = &addr_inet,
 			.method = get_method(&addr_inet, "loopback"),
-			.next = defn->ifaces
+			.next = defn->ifaces,
+			.next_same = lookup_interface(defn, LO_IFACE),
 		};
 
 		defn->ifaces = lo_if;
+
+		if (!defn->last_iface)
+			defn->last_iface = lo_if;
+
+		hash_set(&defn->iface_index, lo_if->logical_iface, lo_if);
 	}
 
 	clear_seen();
 
+	cache_save(cachefile, filename, defn, no_loopback_before, first_in_list);
+
 	return defn;
 }
 
 allowup_defn *find_allowup(interfaces_file *defn, const char *name) {
-	for (allowup_defn *allowups = defn->allowups; allowups; allowups = allowups->next)
-		if (strcmp(allowups->when, name) == 0)
-			return allowups;
+	return hash_get(&defn->allowup_index, name, strlen(name));
+}
 
-	return NULL;
+/* Append a class to the list and index it, along with the names already in it */
+void add_allowup(interfaces_file *defn, allowup_defn *allowup) {
+	allowup_defn **where = &defn->allowups;
+
+	while (*where)
+		where = &(*where)->next;
+
+	*where = allowup;
+	allowup->next = NULL;
+
+	hash_set(&defn->allowup_index, allowup->when, allowup);
+
+	for (int i = 0; i < allowup->n_interfaces; i++)
+		if (!hash_get(&allowup->members, allowup->interfaces[i], strlen(allowup->interfaces[i])))
+			hash_set(&allowup->members, allowup->interfaces[i], allowup);
 }
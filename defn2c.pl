@@ -1,6 +1,9 @@
 #!/usr/bin/perl -w
 
 use strict;
+use FindBin;
+
+require "$FindBin::Bin/phash.pl";
 
 my $DEB_HOST_ARCH_OS = `dpkg-architecture -qDEB_HOST_ARCH_OS`;
 
@@ -13,6 +16,8 @@ my %ourmethods = ();
 my $line = "";
 my $arch = "";
 my $match = "";
+my %slot = ();          # the option slots of the method being read
+my @slots = ();
 
 # subroutines
 sub nextline {
@@ -59,12 +64,27 @@ sub get_architecture {
         }
         nextline;
 }
+# Number an option of the method, see struct option_slots
+sub add_slot {
+        my $option = $_[0];
+
+        return if ($option eq "iface" or exists $slot{$option});    # iface is special in get_var()
+
+        $slot{$option} = scalar(@slots);
+        push @slots, $option;
+}
+sub slot_of {
+        return exists $slot{$_[0]} ? $slot{$_[0]} : -1;
+}
 sub get_method {
         my $method = $_[0];
         my $indent = ($line =~ /(\s*)[^\s]/) ? $1 : "";
         my @options = ();
         my @variables = ();
 
+        %slot = ();
+        @slots = ();
+
         die "Duplicate method $method\n" if ($methods{$method}++);
 
         nextline;
@@ -82,6 +102,7 @@ sub get_method {
                                 my $optargs = $2;
                                 my $dsc = $3;
                                 push @variables, $opt;
+                                add_slot($opt);
                                 if ($4) {
                                         print "\t{ \"$opt\", \"$5\" },\n";
                                 }
@@ -115,27 +136,40 @@ sub get_method {
                                 $newoption =~ s/^=//;
                                 die "Duplicate option use: $newoption (from $method/$option)" if (grep $_ eq $newoption, @variables);
                                 push @variables, $newoption;
-                                print "\t{ \"$option\", \"$newoption\", $fn },\n";
+                                if ($option eq "iface") {
+                                        print "\t{ CONVERT_IFACE, NULL, 0, -1, \"$newoption\", $fn },\n";
+                                } else {
+                                        print "\t{ CONVERT_OPTION, \"$option\", " . length($option) . ", " . slot_of($option) . ", \"$newoption\", $fn },\n";
+                                }
+                                add_slot($newoption);
                         } else {
-                                print "\t{ \"$option\", NULL, $fn },\n";
+                                print "\t{ CONVERT_OPTION, \"$option\", " . length($option) . ", " . slot_of($option) . ", NULL, $fn },\n";
                         }
                 }
         }
-        print "\t\{ NULL, NULL, NULL, 0, NULL }\n";
+        print "\t\{ CONVERT_END, NULL, 0, -1, NULL, NULL, 0, NULL }\n";
         print "};\n";
+        print "static const char *const _${method}_slot_names[] = {\n";
+        print "\t\"$_\",\n" foreach (@slots);
+        print "\tNULL\n";
+        print "};\n";
+        print "static const option_slots _${method}_slots = { " . scalar(@slots) . ", _${method}_slot_names };\n";
         if (match($line, "up", $indent)) {
                 get_commands(${method}, "up");
         } else {
+                print "static const command_op _${method}_up_ops[] = { { COMMAND_END, 0, NULL, false, NULL, NULL } };\n";
                 print "static int _${method}_up(interface_defn *ifd, execfn *exec) { return 0; }\n"
         }
         if (match($line, "down", $indent)) {
                 get_commands(${method}, "down");
         } else {
+                print "static const command_op _${method}_down_ops[] = { { COMMAND_END, 0, NULL, false, NULL, NULL } };\n";
                 print "static int _${method}_down(interface_defn *ifd, execfn *exec) { return 0; }\n"
         }
         if (match($line, "rename", $indent)) {
                 get_commands(${method}, "rename");
         } else {
+                print "static const command_op _${method}_rename_ops[] = { { COMMAND_END, 0, NULL, false, NULL, NULL } };\n";
                 print "static int _${method}_rename(interface_defn *ifd, execfn *exec) { return 0; }\n"
         }
 }
@@ -153,31 +187,173 @@ sub quote_chars {
     $string =~ s/\n/\\\n/g;
     return $string;
 }
+sub c_string {
+    my $string = $_[0];
+    $string =~ s/\\/\\\\/g;
+    $string =~ s/"/\\"/g;
+    $string =~ s/\n/\\n/g;
+    $string =~ s/\t/\\t/g;
+    return "\"$string\"";
+}
+sub c_char {
+    my $char = $_[0];
+    return "'\\''" if ($char eq "'");
+    return "'\\\\'" if ($char eq "\\");
+    return "'$char'";
+}
+# Compile a command template into the ops that execute_template() renders,
+# following parse() in execute.c to the letter. Returns nothing if the
+# template is malformed, in which case parse() gets to report it.
+sub compile_template {
+        my $template = $_[0];
+        my $max_depth = 10;     # MAX_OPT_DEPTH in header.h
+        my @ops = ();
+        my $text = "";
+        my $depth = 1;
+        my $i = 0;
+
+        # the C string loses the newlines of continued lines
+        $template =~ s/\n//g;
+
+        my $flush = sub {
+                push @ops, "{ TEMPLATE_TEXT, " . c_string($text) . ", " . length($text) . ", -1, 0, 0 }" if ($text ne "");
+                $text = "";
+        };
+
+        while ($i < length($template)) {
+                my $c = substr($template, $i, 1);
+                my $next = substr($template, $i + 1, 1);
+
+                if ($c eq "\\") {
+                        if ($next ne "") {
+                                $text .= $next;
+                                $i += 2;
+                        } else {
+                                $text .= $c;
+                                $i++;
+                        }
+                } elsif ($c eq "[" and $next eq "[" and $depth < $max_depth) {
+                        &$flush;
+                        push @ops, "{ TEMPLATE_OPEN, NULL, 0, -1, 0, 0 }";
+                        $depth++;
+                        $i += 2;
+                } elsif ($c eq "]" and $next eq "]" and $depth > 1) {
+                        &$flush;
+                        push @ops, "{ TEMPLATE_CLOSE, NULL, 0, -1, 0, 0 }";
+                        $depth--;
+                        $i += 2;
+                } elsif ($c eq "%") {
+                        my $end = index($template, "%", $i + 1);
+                        return () if ($end < 0);
+                        my $name = substr($template, $i + 1, $end - $i - 1);
+                        my ($pat, $rep) = (0, 0);
+                        if ($end - 4 >= 0 and substr($template, $end - 4, 1) eq "/") {
+                                return () if (length($name) < 4);
+                                $pat = c_char(substr($template, $end - 3, 1));
+                                $rep = c_char(substr($template, $end - 1, 1));
+                                $name = substr($name, 0, -4);
+                        }
+                        &$flush;
+                        push @ops, "{ TEMPLATE_VAR, " . c_string($name) . ", " . length($name) . ", " . slot_of($name) . ", $pat, $rep }";
+                        $i = $end + 1;
+                } else {
+                        $text .= $c;
+                        $i++;
+                }
+        }
+
+        return () if ($depth > 1);
+
+        &$flush;
+        push @ops, "{ TEMPLATE_END, NULL, 0, -1, 0, 0 }";
+        return @ops;
+}
+# Tell what a command does from its leading text, see enum command_kind
+sub command_kind {
+        my $command = $_[0];
+        my $family = 0;
+
+        $command =~ s/^-//;
+        $command =~ s/^\[\[\s*//;
+
+        return ("COMMAND_SYSCTL", 0) if ($command =~ /^sysctl\s/);
+        return ("COMMAND_SHELL", 0) unless ($command =~ /^ip\s+(?:-([46])\s+)?(\w+)\s+(\w+)\s/);
+
+        my ($object, $verb) = ($2, $3);
+        $family = $1 if ($1);
+
+        my %kinds = (
+                "link set" => "COMMAND_LINK_SET",
+                "addr add" => "COMMAND_ADDR_ADD",
+                "addr del" => "COMMAND_ADDR_DEL",
+                "addr flush" => "COMMAND_ADDR_FLUSH",
+                "route add" => "COMMAND_ROUTE_ADD",
+                "route replace" => "COMMAND_ROUTE_REPLACE",
+                "route del" => "COMMAND_ROUTE_DEL",
+        );
+
+        $object = "addr" if ($object eq "address");
+
+        return ($kinds{"$object $verb"} || "COMMAND_IP", $family);
+}
+# Make a condition find the options the method declares by their slots
+sub slot_condition {
+        my ($method, $condition) = @_;
+
+        $condition =~ s/\bvar_(true|set)\("([^"]+)", ifd\)/exists $slot{$2} ? "var_$1_slot(&_${method}_slots, $slot{$2}, ifd)" : $&/ge;
+        $condition =~ s/\bvar_strcasecmp\("([^"]+)",/exists $slot{$1} ? "var_strcasecmp_slot(&_${method}_slots, $slot{$1}," : $&/ge;
+
+        return $condition;
+}
+# Emit the commands as a list of steps for execute_ops()
 sub get_commands {
         my $method = $_[0];
         my $mode = $_[1];
         my $function = "_${method}_${mode}";
         my $indent = ($line =~ /(\s*)[^\s]/) ? $1 : "";
-
-        print "static int ${function}(interface_defn *ifd, execfn *exec) {\n";
+        my @steps = ();
+        my $n = 0;
 
         while (nextline && match($line, "", $indent)) {
+                my ($command, $condition, $elsif);
+
                 if ( $match =~ /^(.*[^\s])\s+if\s*\((.*)\)\s*$/s ) {
-                        print "if ( $2 ) {\n";
-                        print "  if (!execute(\"".quote_chars($1)."\", ifd, exec) && !ignore_failures) return 0;\n";
-                        print "}\n";
+                        ($command, $condition, $elsif) = ($1, $2, "false");
                 } elsif ( $match =~ /^(.*[^\s])\s+elsif\s*\((.*)\)\s*$/s ) {
-                        print "else if ( $2 ) {\n";
-                        print "  if (!execute(\"".quote_chars($1)."\", ifd, exec) && !ignore_failures) return 0;\n";
-                        print "}\n";
+                        ($command, $condition, $elsif) = ($1, $2, "true");
                 } elsif ( $match =~ /^(.*[^\s])\s*$/s ) {
-                        print "{\n";
-                        print "  if (!execute(\"".quote_chars($1)."\", ifd, exec) && !ignore_failures) return 0;\n";
-                        print "}\n";
+                        ($command, $condition, $elsif) = ($1, undef, "false");
+                } else {
+                        next;
+                }
+
+                my ($kind, $family) = command_kind($command);
+                my @ops = compile_template($command);
+                my $test = "NULL";
+                my $program = "NULL";
+
+                if (defined($condition)) {
+                        $test = "${function}_if_$n";
+                        print "static bool $test(interface_defn *ifd) { return " . slot_condition($method, $condition) . "; }\n";
+                }
+
+                if (@ops) {
+                        $program = "${function}_$n";
+                        print "static const template_op ${program}[] = {\n";
+                        print "    $_,\n" foreach (@ops);
+                        print "};\n";
                 }
+
+                push @steps, "{ $kind, $family, $test, $elsif, $program, \"" . quote_chars($command) . "\" }";
+                $n++;
         }
 
-        print "return 1;\n";
+        print "static const command_op ${function}_ops[] = {\n";
+        print "\t$_,\n" foreach (@steps);
+        print "\t{ COMMAND_END, 0, NULL, false, NULL, NULL }\n";
+        print "};\n";
+        print "static int ${function}(interface_defn *ifd, execfn *exec) {\n";
+        print "\treturn execute_ops(${function}_ops, &_${method}_slots, ifd, exec);\n";
         print "}\n";
 }
 sub get_options {
@@ -223,15 +399,21 @@ foreach $method (sort keys %ourmethods) {
                 "$method",
                 _${method}_up, _${method}_down, _${method}_rename,
                 _${method}_conv, _${method}_default,
+                &_${method}_slots,
+                _${method}_up_ops, _${method}_down_ops, _${method}_rename_ops,
         },
 EOF
 }
 print "};\n\n";
 
+my $method_hash = print_perfect_hash("method_slots", sort keys %ourmethods);
+
 print <<EOF;
+
 address_family addr_${address_family} = {
         "$address_family",
         sizeof(methods)/sizeof(struct method),
-        methods
+        methods,
+        $method_hash
 };
 EOF
@@ -8,14 +8,26 @@
 #include <errno.h>
 #include <stdarg.h>
 #include <unistd.h>
+#include <fcntl.h>
+#include <spawn.h>
 #include <sys/wait.h>
+#include <sys/stat.h>
 #include <signal.h>
 #include <err.h>
 
 #include "header.h"
 
+/* posix_spawn_file_actions_addchdir_np() appeared in glibc 2.29 */
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 29))
+#define HAVE_SPAWN_CHDIR
+#endif
+
 extern char **environ;
 static char **localenv = NULL;
+static int localenv_serial = 0;
+
+/* The step execute_ops() is running, for doit() to know what kind of command it gets */
+static const command_op *current_op;
 
 static int check(const char *str) {
 	return str != NULL;
@@ -59,6 +71,8 @@ static void set_environ(interface_defn *iface, char *mode, char *phase) {
 		free(localenv);
 	}
 
+	localenv_serial++;
+
 	int n_recursion = 0;
 	for(char **envp = environ; *envp; envp++)
 		if(strncmp(*envp, "IFUPDOWN_", 9) == 0)
@@ -110,6 +124,780 @@ static void set_environ(interface_defn *iface, char *mode, char *phase) {
 	*ppch = NULL;
 }
 
+/* Shell builtins and keywords that split_command() lets through */
+static const char *shell_words[] = {
+	".", ":", "alias", "bg", "break", "case", "cd", "command", "continue",
+	"do", "done", "echo", "elif", "else", "esac", "eval", "exec", "exit",
+	"export", "false", "fc", "fg", "fi", "for", "getopts", "hash", "if",
+	"in", "jobs", "kill", "local", "printf", "pwd", "read", "readonly",
+	"return", "set", "shift", "test", "then", "times", "trap", "true",
+	"type", "ulimit", "umask", "unalias", "unset", "until", "wait", "while",
+};
+
+static int compare_words(const void *a, const void *b) {
+	return strcmp(*(const char **)a, *(const char **)b);
+}
+
+/* Where commands were found in $PATH, as long as it does not change */
+struct command_path {
+	char *name;
+	char *path;
+};
+
+static struct command_path *command_paths = NULL;
+static int n_command_paths = 0;
+static int max_command_paths = 0;
+static char *command_search_path = NULL;
+
+static const char *get_localenv(const char *name) {
+	size_t len = strlen(name);
+
+	for (char **ppch = localenv; ppch && *ppch; ppch++)
+		if (strncmp(*ppch, name, len) == 0 && (*ppch)[len] == '=')
+			return *ppch + len + 1;
+
+	return NULL;
+}
+
+static const char *find_command(const char *name) {
+	if (strchr(name, '/'))
+		return access(name, X_OK) == 0 ? name : NULL;
+
+	const char *search_path = get_localenv("PATH");
+	if (!search_path)
+		return NULL;
+
+	if (!command_search_path || strcmp(command_search_path, search_path)) {
+		for (int i = 0; i < n_command_paths; i++) {
+			free(command_paths[i].name);
+			free(command_paths[i].path);
+		}
+
+		n_command_paths = 0;
+		free(command_search_path);
+		command_search_path = strdup(search_path);
+		if (!command_search_path)
+			err(1, "strdup");
+	}
+
+	for (int i = 0; i < n_command_paths; i++)
+		if (strcmp(command_paths[i].name, name) == 0)
+			return command_paths[i].path;
+
+	const char *dir = search_path;
+
+	while (*dir) {
+		size_t len = strcspn(dir, ":");
+		char *path;
+		struct stat st;
+
+		if (asprintf(&path, "%.*s/%s", (int)len, len ? dir : ".", name) == -1)
+			err(1, "asprintf");
+
+		if (stat(path, &st) == 0 && S_ISREG(st.st_mode) && access(path, X_OK) == 0) {
+			if (n_command_paths == max_command_paths) {
+				max_command_paths = max_command_paths ? 2 * max_command_paths : 8;
+				command_paths = realloc(command_paths, max_command_paths * sizeof *command_paths);
+				if (!command_paths)
+					err(1, "realloc");
+			}
+
+			command_paths[n_command_paths].name = strdup(name);
+			command_paths[n_command_paths].path = path;
+			if (!command_paths[n_command_paths].name)
+				err(1, "strdup");
+
+			return command_paths[n_command_paths++].path;
+		}
+
+		free(path);
+		dir += len;
+
+		if (*dir == ':')
+			dir++;
+	}
+
+	return NULL;
+}
+
+/*
+ * Run a command without a shell if it consists of plain words and names a
+ * program in $PATH. Returns false if it should be left to the shell, which
+ * also covers any error, so the shell can report it the way it always did.
+ */
+static bool run_direct(const char *str, bool *okay) {
+	if (!localenv)
+		return false;
+
+	char **argv = split_command(str);
+	if (!argv)
+		return false;
+
+	const char *path = NULL;
+
+	if (!bsearch(&argv[0], shell_words, sizeof shell_words / sizeof *shell_words, sizeof *shell_words, compare_words))
+		path = find_command(argv[0]);
+
+	pid_t child;
+	int status;
+
+	if (path) {
+		fflush(NULL);
+		setpgid(0, 0);
+
+		if (posix_spawn(&child, path, NULL, NULL, argv, localenv))
+			path = NULL;
+	}
+
+	free(argv);
+
+	if (!path)
+		return false;
+
+	waitpid(child, &status, 0);
+	*okay = WIFEXITED(status) && WEXITSTATUS(status) == 0;
+
+	return true;
+}
+
+static bool run_shell(const char *str) {
+	char *argv[] = { "/bin/sh", "-c", (char *)str, NULL };
+	char *noenv[] = { NULL };
+	pid_t child;
+	int status;
+	bool okay;
+
+	if (run_direct(str, &okay))
+		return okay;
+
+	fflush(NULL);
+	setpgid(0, 0);
+
+	/* posix_spawn() does not copy our page tables like fork() does */
+	int error = posix_spawn(&child, argv[0], NULL, NULL, argv, localenv ? localenv : noenv);
+	if (error) {
+		errno = error;
+		warn("executing '%s' failed", str);
+		return false;
+	}
+
+	waitpid(child, &status, 0);
+
+	return WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+
+/*
+ * With the coproc executor, commands are sent to a /bin/sh that stays around
+ * until the environment changes, which happens once per phase. Each command
+ * runs in a subshell, so it cannot affect the ones after it, with the
+ * original stdin on fd 0. The exit status is written back on fd 9.
+ */
+static pid_t coproc_pid = 0;
+static pid_t coproc_owner = 0;
+static int coproc_serial = 0;
+static int coproc_fd = -1;
+static FILE *coproc_status = NULL;
+
+static void stop_coproc(void) {
+	if (!coproc_pid)
+		return;
+
+	close(coproc_fd);
+	fclose(coproc_status);
+
+	/* a forked child of ours has no business with the shell of its parent */
+	if (coproc_owner == getpid())
+		waitpid(coproc_pid, NULL, 0);
+
+	coproc_pid = 0;
+	coproc_fd = -1;
+	coproc_status = NULL;
+}
+
+static void start_coproc(void) {
+	int cmdfd[2], statusfd[2];
+
+	if (pipe(cmdfd) || pipe(statusfd))
+		err(1, "pipe");
+
+	fflush(NULL);
+	setpgid(0, 0);
+
+	switch (coproc_pid = fork()) {
+	case -1:	/* failure */
+		err(1, "fork");
+
+	case 0:	/* child */
+		/* get the pipes out of the way first */
+		cmdfd[0] = fcntl(cmdfd[0], F_DUPFD, 10);
+		statusfd[1] = fcntl(statusfd[1], F_DUPFD, 10);
+		close(cmdfd[1]);
+		close(statusfd[0]);
+
+		if (dup2(0, 8) == -1) {
+			int fd = open("/dev/null", O_RDONLY);
+			dup2(fd, 8);
+			close(fd);
+		}
+
+		dup2(cmdfd[0], 0);
+		dup2(statusfd[1], 9);
+		close(cmdfd[0]);
+		close(statusfd[1]);
+
+		execle("/bin/sh", "/bin/sh", NULL, localenv);
+		err(127, "executing '/bin/sh' failed");
+
+	default:	/* parent */
+		break;
+	}
+
+	close(cmdfd[0]);
+	close(statusfd[1]);
+	fcntl(cmdfd[1], F_SETFD, FD_CLOEXEC);
+	fcntl(statusfd[0], F_SETFD, FD_CLOEXEC);
+
+	coproc_fd = cmdfd[1];
+	coproc_status = fdopen(statusfd[0], "r");
+	if (!coproc_status)
+		err(1, "fdopen");
+
+	coproc_owner = getpid();
+	coproc_serial = localenv_serial;
+}
+
+static bool run_coproc(const char *str) {
+	if (coproc_pid && (coproc_owner != getpid() || coproc_serial != localenv_serial))
+		stop_coproc();
+
+	if (!coproc_pid)
+		start_coproc();
+
+	char *request = NULL;
+	size_t len = 0;
+	FILE *f = open_memstream(&request, &len);
+	if (!f)
+		err(1, "open_memstream");
+
+	fputs("( eval '", f);
+
+	for (const char *p = str; *p; p++) {
+		if (*p == '\'')
+			fputs("'\\''", f);
+		else
+			fputc(*p, f);
+	}
+
+	fputs("' ) 0<&8 8<&- 9>&-\necho $? >&9\n", f);
+	fclose(f);
+
+	fflush(NULL);
+	signal(SIGPIPE, SIG_IGN);
+
+	bool sent = true;
+
+	for (size_t done = 0; done < len && sent; ) {
+		ssize_t n = write(coproc_fd, request + done, len - done);
+
+		if (n > 0)
+			done += n;
+		else if (n == -1 && errno != EINTR)
+			sent = false;
+	}
+
+	signal(SIGPIPE, SIG_DFL);
+	free(request);
+
+	int status = -1;
+
+	if (!sent || fscanf(coproc_status, "%d", &status) != 1) {
+		warnx("shell exited unexpectedly while executing '%s'", str);
+		stop_coproc();
+		return false;
+	}
+
+	return status == 0;
+}
+
+/*
+ * With the batch executor, consecutive ip commands are not run one by one,
+ * but collected and fed to a single "ip -batch -" once a command comes along
+ * that is not an ip command, or at the end of each phase.
+ */
+struct batch_command {
+	char *line;
+	bool ignore_status;
+};
+
+static struct batch_command *batch = NULL;
+static int n_batch = 0;
+static int max_batch = 0;
+static char **batch_argv = NULL;
+
+/* Returns the number of words before the ip object, or 0 if it is not an ip command */
+static int ip_prefix(char **argv) {
+	if (strcmp(argv[0], "ip") && strcmp(argv[0], "/sbin/ip") && strcmp(argv[0], "/bin/ip"))
+		return 0;
+
+	int n = 1;
+
+	while (argv[n] && (strcmp(argv[n], "-4") == 0 || strcmp(argv[n], "-6") == 0))
+		n++;
+
+	if (!argv[n] || *argv[n] == '-')
+		return 0;
+
+	return n;
+}
+
+static bool same_prefix(char **a, char **b, int n) {
+	for (int i = 0; i < n; i++)
+		if (!a[i] || !b[i] || strcmp(a[i], b[i]))
+			return false;
+
+	return !b[n] || *b[n] != '-';
+}
+
+static void clear_batch(void) {
+	for (int i = 0; i < n_batch; i++)
+		free(batch[i].line);
+
+	n_batch = 0;
+	free(batch_argv);
+	batch_argv = NULL;
+}
+
+/*
+ * Run batch[first] onwards through ip -batch. Returns the index of the
+ * command that failed, or n_batch if all went well. If ip failed without
+ * telling which command was the culprit, returns -1.
+ */
+static int run_batch(int first) {
+	int prefix = ip_prefix(batch_argv);
+	const char *argv[prefix + 4];
+	int argc = 0;
+
+	for (int i = 0; i < prefix; i++)
+		argv[argc++] = batch_argv[i];
+
+	if (ignore_failures)
+		argv[argc++] = "-force";
+
+	argv[argc++] = "-batch";
+	argv[argc++] = "-";
+	argv[argc] = NULL;
+
+	FILE *in = tmpfile();
+	if (!in)
+		err(1, "tmpfile");
+
+	for (int i = first; i < n_batch; i++)
+		fprintf(in, "%s\n", batch[i].line);
+
+	if (fflush(in) || fseek(in, 0, SEEK_SET))
+		err(1, "writing batch");
+
+	int fds[2];
+	if (pipe(fds))
+		err(1, "pipe");
+
+	const char *path = find_command(argv[0]);
+	pid_t child;
+	int status;
+
+	posix_spawn_file_actions_t actions;
+	posix_spawn_file_actions_init(&actions);
+	posix_spawn_file_actions_adddup2(&actions, fileno(in), 0);
+	posix_spawn_file_actions_adddup2(&actions, fds[1], 2);
+	posix_spawn_file_actions_addclose(&actions, fds[0]);
+	posix_spawn_file_actions_addclose(&actions, fds[1]);
+
+	fflush(NULL);
+	setpgid(0, 0);
+
+	int error = path ? posix_spawn(&child, path, &actions, NULL, (char **)argv, localenv) : ENOENT;
+	posix_spawn_file_actions_destroy(&actions);
+
+	if (error) {
+		errno = error;
+		warn("executing '%s' failed", argv[0]);
+		close(fds[0]);
+		close(fds[1]);
+		fclose(in);
+		return -1;
+	}
+
+	close(fds[1]);
+	fclose(in);
+
+	/* pass on what ip says, except for its own bookkeeping */
+	FILE *errors = fdopen(fds[0], "r");
+	if (!errors)
+		err(1, "fdopen");
+
+	char *line = NULL;
+	size_t len = 0;
+	int failed = -1;
+
+	while (getline(&line, &len, errors) != -1) {
+		int lineno;
+
+		if (sscanf(line, "Command failed -:%d", &lineno) == 1) {
+			if (failed == -1 && lineno > 0 && lineno <= n_batch - first)
+				failed = first + lineno - 1;
+		} else {
+			fputs(line, stderr);
+		}
+	}
+
+	free(line);
+	fclose(errors);
+	waitpid(child, &status, 0);
+
+	if (WIFEXITED(status) && WEXITSTATUS(status) == 0)
+		return n_batch;
+
+	return failed;
+}
+
+int flush_commands(void) {
+	if (!n_batch)
+		return 1;
+
+	if (interrupted) {
+		clear_batch();
+		return 0;
+	}
+
+	int first = 0;
+	int result = 1;
+
+	/* without -force, ip stops at the first failure, so continue after ignored ones */
+	while (first < n_batch) {
+		int failed = run_batch(first);
+
+		if (failed == n_batch || ignore_failures)
+			break;
+
+		if (failed == -1 || !batch[failed].ignore_status) {
+			result = 0;
+			break;
+		}
+
+		first = failed + 1;
+	}
+
+	clear_batch();
+
+	return result;
+}
+
+/* Add a command to the batch if it is an ip command that does not need a shell */
+static int queue_command(const char *str, bool ignore_status) {
+	char **argv = split_command(str);
+	if (!argv)
+		return 0;
+
+	int prefix = ip_prefix(argv);
+	if (!prefix) {
+		free(argv);
+		return 0;
+	}
+
+	if (batch_argv && !same_prefix(batch_argv, argv, ip_prefix(batch_argv))) {
+		if (!flush_commands()) {
+			free(argv);
+			return -1;
+		}
+	}
+
+	if (n_batch == max_batch) {
+		max_batch = max_batch ? 2 * max_batch : 8;
+		batch = realloc(batch, max_batch * sizeof *batch);
+		if (!batch)
+			err(1, "realloc");
+	}
+
+	/* the words are separated by single spaces now */
+	char *line = NULL;
+	size_t len = 0;
+	FILE *f = open_memstream(&line, &len);
+	if (!f)
+		err(1, "open_memstream");
+
+	for (int i = prefix; argv[i]; i++)
+		fprintf(f, i == prefix ? "%s" : " %s", argv[i]);
+
+	fclose(f);
+
+	batch[n_batch].line = line;
+	batch[n_batch].ignore_status = ignore_status;
+	n_batch++;
+
+	if (batch_argv)
+		free(argv);
+	else
+		batch_argv = argv;
+
+	return 1;
+}
+
+/*
+ * What defn2c.pl knows about a command spares looking at its text for
+ * executors that cannot handle it. Commands that are not from a method's
+ * steps, like the up and down options, always get looked at.
+ */
+static bool may_be_ip(const command_op *op) {
+	return !op || (op->kind != COMMAND_SHELL && op->kind != COMMAND_SYSCTL);
+}
+
+static bool may_be_native(const command_op *op) {
+	if (!op)
+		return true;
+
+	switch (op->kind) {
+	case COMMAND_LINK_SET:
+	case COMMAND_ADDR_ADD:
+	case COMMAND_ADDR_DEL:
+	case COMMAND_ADDR_FLUSH:
+	case COMMAND_ROUTE_ADD:
+	case COMMAND_ROUTE_REPLACE:
+	case COMMAND_ROUTE_DEL:
+		return true;
+	default:
+		return false;
+	}
+}
+
+/*
+ * What the idempotent steps that ran so far have set up: links being up
+ * or down, their MTU and hardware address, and sysctl values. With
+ * --skip-redundant, a step that would only set up what is in here again
+ * is not run. Any other step of a method that names the link or sysctl
+ * of a setting might have undone it, so the setting is forgotten before
+ * that step runs. Options, hook scripts and run-parts can change anything
+ * without naming it, so everything is forgotten before those.
+ */
+struct setting {
+	const char *subject;	/* the link, or the sysctl */
+	const char *name;	/* "state", "mtu" or "address", or "" for a sysctl */
+	const char *value;
+};
+
+#define MAX_SETTINGS 8
+
+static struct applied {
+	char *subject;
+	char *name;
+	char *value;
+} *applied;
+
+static int n_applied;
+static int max_applied;
+static int skipped_commands;
+
+static bool is_ip(const char *word) {
+	return !strcmp(word, "ip") || !strcmp(word, "/sbin/ip") || !strcmp(word, "/bin/ip");
+}
+
+/*
+ * Get the settings a command consisting of plain words makes, if it is
+ * "ip link set [dev] NAME" with only up or down, mtu and address, or "sysctl -w"
+ * with only assignments. Returns how many there are, or 0 if the command
+ * does anything else.
+ */
+static int get_settings(char **argv, struct setting *setting) {
+	int n = 0;
+
+	if (is_ip(*argv)) {
+		const char *name = NULL;
+
+		while (*++argv && **argv == '-')
+			if (strcmp(*argv, "-4") && strcmp(*argv, "-6"))
+				return 0;
+
+		if (!argv[0] || strcmp(argv[0], "link") || !argv[1] || strcmp(argv[1], "set"))
+			return 0;
+
+		for (argv += 2; *argv; argv++) {
+			if (!strcmp(*argv, "dev") && argv[1] && !name) {
+				name = *++argv;
+			} else if (!strcmp(*argv, "up") || !strcmp(*argv, "down")) {
+				setting[n++] = (struct setting){ NULL, "state", *argv };
+			} else if ((!strcmp(*argv, "mtu") || !strcmp(*argv, "address")) && argv[1]) {
+				setting[n++] = (struct setting){ NULL, argv[0], argv[1] };
+				argv++;
+			} else if (!name) {
+				name = *argv;
+			} else {
+				return 0;
+			}
+
+			if (n == MAX_SETTINGS)
+				return 0;
+		}
+
+		if (!name)
+			return 0;
+
+		for (int i = 0; i < n; i++)
+			setting[i].subject = name;
+	} else if (!strcmp(*argv, "sysctl")) {
+		bool write = false;
+
+		for (argv++; *argv && **argv == '-'; argv++) {
+			if (!strcmp(*argv, "-w"))
+				write = true;
+			else if (strcmp(*argv, "-q") && strcmp(*argv, "-e"))
+				return 0;
+		}
+
+		for (; *argv; argv++) {
+			char *eq = strchr(*argv, '=');
+
+			if (!eq || eq == *argv || n == MAX_SETTINGS)
+				return 0;
+
+			*eq = 0;
+			setting[n++] = (struct setting){ *argv, "", eq + 1 };
+		}
+
+		if (!write)
+			return 0;
+	}
+
+	return n;
+}
+
+static int find_applied(const struct setting *setting) {
+	for (int i = 0; i < n_applied; i++)
+		if (!strcmp(applied[i].subject, setting->subject) && !strcmp(applied[i].name, setting->name))
+			return i;
+
+	return -1;
+}
+
+/* Whether the command names the link or sysctl as a word of its own */
+static bool names(const char *command, const char *subject) {
+	size_t len = strlen(subject);
+
+	for (const char *p = strstr(command, subject); p; p = strstr(p + 1, subject)) {
+		bool start = p == command || !(isalnum((unsigned char)p[-1]) || strchr("-_.:@", p[-1]));
+		bool end = !(isalnum((unsigned char)p[len]) || (p[len] && strchr("-_.:@", p[len])));
+
+		if (start && end)
+			return true;
+	}
+
+	return false;
+}
+
+/* Addresses and routes do not change links or sysctls */
+static bool may_undo_settings(const command_op *op) {
+	if (!op)
+		return true;
+
+	switch (op->kind) {
+	case COMMAND_ADDR_ADD:
+	case COMMAND_ADDR_DEL:
+	case COMMAND_ADDR_FLUSH:
+	case COMMAND_ROUTE_ADD:
+	case COMMAND_ROUTE_REPLACE:
+	case COMMAND_ROUTE_DEL:
+		return false;
+	default:
+		return true;
+	}
+}
+
+/*
+ * Check whether the command only makes settings that are already applied,
+ * or else forget the settings it might undo. Shell commands are never
+ * considered redundant, since split_command() does not split them.
+ */
+static bool redundant(const char *command) {
+	struct setting setting[MAX_SETTINGS];
+	int n = 0;
+	char **argv = NULL;
+
+	if (current_op && (current_op->kind == COMMAND_LINK_SET || current_op->kind == COMMAND_SYSCTL))
+		argv = split_command(command);
+
+	if (argv)
+		n = get_settings(argv, setting);
+
+	bool done = n > 0;
+
+	for (int i = 0; i < n; i++) {
+		int j = find_applied(&setting[i]);
+
+		if (j == -1 || strcmp(applied[j].value, setting[i].value))
+			done = false;
+	}
+
+	free(argv);
+
+	if (n || !may_undo_settings(current_op))
+		return done;
+
+	for (int i = 0; i < n_applied; i++) {
+		if (!current_op || names(command, applied[i].subject)) {
+			free(applied[i].subject);
+			free(applied[i].name);
+			free(applied[i].value);
+			applied[i--] = applied[--n_applied];
+		}
+	}
+
+	return false;
+}
+
+/* Take note of the settings a command that did not fail made */
+static void apply_settings(const char *command) {
+	struct setting setting[MAX_SETTINGS];
+	int n = 0;
+	char **argv = NULL;
+
+	if (current_op && (current_op->kind == COMMAND_LINK_SET || current_op->kind == COMMAND_SYSCTL))
+		argv = split_command(command);
+
+	if (argv)
+		n = get_settings(argv, setting);
+
+	for (int i = 0; i < n; i++) {
+		int j = find_applied(&setting[i]);
+
+		if (j == -1) {
+			if (n_applied == max_applied) {
+				max_applied = max_applied ? 2 * max_applied : 16;
+				applied = realloc(applied, max_applied * sizeof *applied);
+				if (!applied)
+					err(1, "realloc");
+			}
+
+			j = n_applied++;
+			applied[j].subject = strdup(setting[i].subject);
+			applied[j].name = strdup(setting[i].name);
+			applied[j].value = NULL;
+
+			if (!applied[j].subject || !applied[j].name)
+				err(1, "strdup");
+		}
+
+		free(applied[j].value);
+		applied[j].value = strdup(setting[i].value);
+		if (!applied[j].value)
+			err(1, "strdup");
+	}
+
+	free(argv);
+}
+
+void report_skipped_commands(void) {
+	if (verbose && skipped_commands)
+		warnx("skipped %d redundant command%s", skipped_commands, skipped_commands == 1 ? "" : "s");
+}
+
 int doit(const char *str) {
 	if (interrupted)
 		return 0;
@@ -122,50 +910,115 @@ int doit(const char *str) {
 		str++;
 	}
 
-	if (verbose || no_act)
-		fprintf(stderr, "%s\n", str);
+	if (skip_redundant && !no_act_commands && redundant(str)) {
+		if (verbose)
+			warnx("not running \"%s\" again", str);
 
-	if (!no_act_commands) {
-		pid_t child;
-		int status;
+		skipped_commands++;
+		return 1;
+	}
 
-		fflush(NULL);
-		setpgid(0, 0);
+	if (executor == EXECUTOR_BATCH && !no_act_commands) {
+		int queued = may_be_ip(current_op) ? queue_command(str, ignore_status) : 0;
+
+		if (queued == -1 || (queued == 0 && !flush_commands()))
+			return 0;
 
-		switch (child = fork()) {
-		case -1:	/* failure */
-			err(1, "fork");
+		if (queued) {
+			if (verbose || no_act)
+				fprintf(stderr, "%s\n", str);
 
-		case 0:	/* child */
-			execle("/bin/sh", "/bin/sh", "-c", str, NULL, localenv);
-			err(127, "executing '%s' failed", str);
+			/* a failure stops the run when the batch is flushed */
+			if (skip_redundant && !ignore_status && !ignore_failures)
+				apply_settings(str);
 
-		default:	/* parent */
-			break;
+			return 1;
 		}
+	}
+
+	if (verbose || no_act)
+		fprintf(stderr, "%s\n", str);
+
+	if (!no_act_commands) {
+		bool okay;
 
-		waitpid(child, &status, 0);
+#ifdef __linux__
+		if (executor != EXECUTOR_NETLINK || !may_be_native(current_op) || !netlink_execute(str, &okay))
+#endif
+			okay = executor == EXECUTOR_COPROC ? run_coproc(str) : run_shell(str);
+
+		if (okay && skip_redundant)
+			apply_settings(str);
 
 		if (ignore_status || ignore_failures)
 			return 1;
 
-		if (!WIFEXITED(status) || WEXITSTATUS(status) != 0)
+		if (!okay)
 			return 0;
 	}
 
 	return 1;
 }
 
+/*
+ * Split a command into words if it consists of plain words only, meaning
+ * a shell would not interpret it in any way other than splitting it at
+ * whitespace. Returns a NULL-terminated array that can be freed in one go,
+ * or NULL if the command needs a shell.
+ */
+char **split_command(const char *command) {
+	size_t len = strlen(command);
+	int n_words = 0;
+	bool in_word = false;
+
+	for (const char *p = command; *p; p++) {
+		if (*p == ' ' || *p == '\t') {
+			in_word = false;
+			continue;
+		}
+
+		if (!isalnum((unsigned char)*p) && !strchr("-_./:,+@%=^", *p))
+			return NULL;
+
+		/* variable assignments */
+		if (*p == '=' && n_words == 1)
+			return NULL;
+
+		if (!in_word)
+			n_words++;
+
+		in_word = true;
+	}
+
+	if (!n_words)
+		return NULL;
+
+	char **argv = malloc((n_words + 1) * sizeof *argv + len + 1);
+	if (!argv)
+		err(1, "malloc");
+
+	char *buf = strcpy((char *)(argv + n_words + 1), command);
+	int argc = 0;
+
+	for (char *word = strtok(buf, " \t"); word; word = strtok(NULL, " \t"))
+		argv[argc++] = word;
+
+	argv[argc] = NULL;
+
+	return argv;
+}
+
 static int execute_options(interface_defn *ifd, execfn *exec, char *opt) {
-	for (int i = 0; i < ifd->n_options; i++)
-		if (strcmp(ifd->option[i].name, opt) == 0)
-			if (interrupted || !(*exec) (ifd->option[i].value))
-				if (!ignore_failures)
-					return 0;
+	for (int i = find_option(ifd, opt, strlen(opt)); i != -1; i = next_option(ifd, i))
+		if (interrupted || !(*exec) (ifd->option[i].value))
+			if (!ignore_failures)
+				return 0;
 
 	return 1;
 }
 
+static matcher no_scripts;
+
 static int execute_scripts(interface_defn *ifd, execfn *exec, char *opt) {
 	if (interrupted)
 		return 1;
@@ -173,7 +1026,7 @@ static int execute_scripts(interface_defn *ifd, execfn *exec, char *opt) {
 	if (!run_scripts)
 		return 1;
 
-	if (no_scripts_ints && match_patterns(ifd->logical_iface, no_scripts_ints, no_scripts_int))
+	if (no_scripts_ints && matcher_match(&no_scripts, ifd->logical_iface, no_scripts_ints, no_scripts_int))
 		return 1;
 
 
@@ -200,7 +1053,7 @@ int iface_preup(interface_defn *iface) {
 	if (!execute_scripts(iface, doit, "pre-up"))
 		return 0;
 
-	return 1;
+	return flush_commands();
 }
 
 int iface_postup(interface_defn *iface) {
@@ -215,7 +1068,7 @@ int iface_postup(interface_defn *iface) {
 	if (!execute_scripts(iface, doit, "up"))
 		return 0;
 
-	return 1;
+	return flush_commands();
 }
 
 int iface_up(interface_defn *iface) {
@@ -261,7 +1114,7 @@ int iface_predown(interface_defn *iface) {
 	if (!execute_options(iface, doit, "down"))
 		return 0;
 
-	return 1;
+	return flush_commands();
 }
 
 int iface_postdown(interface_defn *iface) {
@@ -276,7 +1129,7 @@ int iface_postdown(interface_defn *iface) {
 	if (!execute_options(iface, doit, "post-down"))
 		return 0;
 
-	return 1;
+	return flush_commands();
 }
 
 int iface_down(interface_defn *iface) {
@@ -380,7 +1233,7 @@ static char *parse(const char *command, interface_defn *ifd) {
 				char *nextpercent;
 				size_t namelen;
 				char pat = 0, rep = 0;
-				char *varvalue;
+				const char *varvalue;
 
 				command++;
 				nextpercent = strchr(command, '%');
@@ -402,12 +1255,13 @@ static char *parse(const char *command, interface_defn *ifd) {
 				varvalue = get_var(command, namelen, ifd);
 
 				if (varvalue) {
-					for (char *position = varvalue; *position; position++)
-						if (*position == pat)
-							*position = rep;
+					size_t start = pos;
 
 					addstr(&result, &len, &pos, varvalue, strlen(varvalue));
-					free(varvalue);
+
+					for (char *position = result + start; *position; position++)
+						if (*position == pat)
+							*position = rep;
 				} else {
 					if (opt_depth == 1)
 						warnx("missing required variable: %.*s", (int)namelen, command);
@@ -451,6 +1305,200 @@ int execute(const char *command, interface_defn *ifd, execfn *exec) {
 	return ret;
 }
 
+/*
+ * Render a template that defn2c.pl compiled from the same syntax parse()
+ * handles, with the same result. All variables are looked up first, so the
+ * result can be written in one go into a buffer of the right size.
+ */
+static char *render(const template_op *program, const option_slots *slots, interface_defn *ifd) {
+	size_t n_ops = 0;
+
+	while (program[n_ops].opcode != TEMPLATE_END)
+		n_ops++;
+
+	const char *values[n_ops + 1];
+	size_t size = 1;
+	bool appended = false;
+
+	for (size_t i = 0; i < n_ops; i++) {
+		values[i] = NULL;
+
+		if (program[i].opcode == TEMPLATE_TEXT) {
+			size += program[i].len;
+			appended = true;
+		} else if (program[i].opcode == TEMPLATE_VAR) {
+			if (program[i].slot >= 0)
+				values[i] = get_slot_var(slots, program[i].slot, ifd);
+			else
+				values[i] = get_var(program[i].str, program[i].len, ifd);
+
+			if (values[i]) {
+				size += strlen(values[i]);
+				appended = true;
+			}
+		}
+	}
+
+	char *result = malloc(size);
+	if (!result)
+		err(1, "malloc");
+
+	size_t pos = 0;
+	size_t old_pos[MAX_OPT_DEPTH] = { 0 };
+	bool okay[MAX_OPT_DEPTH] = { true };
+	int opt_depth = 1;
+
+	for (size_t i = 0; i < n_ops; i++) {
+		const template_op *op = &program[i];
+
+		switch (op->opcode) {
+		case TEMPLATE_TEXT:
+			memcpy(result + pos, op->str, op->len);
+			pos += op->len;
+			break;
+
+		case TEMPLATE_VAR:
+			if (values[i]) {
+				for (const char *p = values[i]; *p; p++)
+					result[pos++] = op->pat && *p == op->pat ? op->rep : *p;
+			} else {
+				if (opt_depth == 1)
+					warnx("missing required variable: %.*s", (int)op->len, op->str);
+
+				okay[opt_depth - 1] = false;
+			}
+			break;
+
+		case TEMPLATE_OPEN:
+			old_pos[opt_depth] = pos;
+			okay[opt_depth] = true;
+			opt_depth++;
+			break;
+
+		case TEMPLATE_CLOSE:
+			opt_depth--;
+			if (!okay[opt_depth])
+				pos = old_pos[opt_depth];
+			break;
+
+		case TEMPLATE_END:
+			break;
+		}
+	}
+
+	result[pos] = '\0';
+
+	if (!okay[0]) {
+		errno = EUNDEFVAR;
+		free(result);
+		return NULL;
+	}
+
+	/* like parse(), which never allocates a buffer for nothing */
+	if (!appended) {
+		free(result);
+		return NULL;
+	}
+
+	return result;
+}
+
+/*
+ * Whether render() would succeed, with the same warnings, but without
+ * building the command. This is all that iface_preup() and iface_predown()
+ * need to know before the hooks run; the commands are rendered after them.
+ */
+static bool renders(const template_op *program, const option_slots *slots, interface_defn *ifd) {
+	bool okay[MAX_OPT_DEPTH] = { true };
+	int opt_depth = 1;
+	bool appended = false;
+
+	for (const template_op *op = program; op->opcode != TEMPLATE_END; op++) {
+		switch (op->opcode) {
+		case TEMPLATE_TEXT:
+			appended = true;
+			break;
+
+		case TEMPLATE_VAR:
+			if (op->slot >= 0 ? get_slot_var(slots, op->slot, ifd) : get_var(op->str, op->len, ifd)) {
+				appended = true;
+				break;
+			}
+
+			if (opt_depth == 1)
+				warnx("missing required variable: %.*s", (int)op->len, op->str);
+
+			okay[opt_depth - 1] = false;
+			break;
+
+		case TEMPLATE_OPEN:
+			okay[opt_depth] = true;
+			opt_depth++;
+			break;
+
+		case TEMPLATE_CLOSE:
+			opt_depth--;
+			break;
+
+		default:
+			break;
+		}
+	}
+
+	if (!okay[0])
+		errno = EUNDEFVAR;
+
+	return okay[0] && appended;
+}
+
+int execute_template(const template_op *program, const option_slots *slots, interface_defn *ifd, execfn *exec) {
+	char *out;
+	int ret;
+
+	if (exec == check)
+		return renders(program, slots, ifd);
+
+	out = render(program, slots, ifd);
+	if (!out)
+		return 0;
+
+	ret = (*exec) (out);
+	free(out);
+
+	return ret;
+}
+
+/*
+ * Run the steps of a method's up, down or rename commands, the way the
+ * code defn2c.pl used to generate for them did.
+ */
+int execute_ops(const command_op *ops, const option_slots *slots, interface_defn *ifd, execfn *exec) {
+	bool matched = false;	/* a condition of the current if ... elsif chain held */
+
+	for (const command_op *op = ops; op->kind != COMMAND_END; op++) {
+		if (op->elsif && matched)
+			continue;
+
+		if (op->condition) {
+			matched = op->condition(ifd);
+
+			if (!matched)
+				continue;
+		}
+
+		current_op = op;
+
+		int okay = op->program ? execute_template(op->program, slots, ifd, exec) : execute(op->command, ifd, exec);
+
+		current_op = NULL;
+
+		if (!okay && !ignore_failures)
+			return 0;
+	}
+
+	return 1;
+}
+
 int strncmpz(const char *l, const char *r, size_t llen) {
 	int i = strncmp(l, r, llen);
 
@@ -460,62 +1508,58 @@ int strncmpz(const char *l, const char *r, size_t llen) {
 		return i;
 }
 
-char *get_var(const char *id, size_t idlen, interface_defn *ifd) {
+/* The value of a variable, or NULL if it is unset or empty. The value is not copied. */
+const char *get_var(const char *id, size_t idlen, interface_defn *ifd) {
 	if (strncmpz(id, "iface", idlen) == 0)
-		return strdup(ifd->real_iface);
+		return ifd->real_iface;
 
-	for (int i = 0; i < ifd->n_options; i++) {
-		if (strncmpz(id, ifd->option[i].name, idlen) == 0) {
-			if (!ifd->option[i].value)
-				return NULL;
+	int i = find_option(ifd, id, idlen);
 
-			if (strlen(ifd->option[i].value) > 0)
-				return strdup(ifd->option[i].value);
-			else
-				return NULL;
-		}
-	}
+	if (i == -1 || !ifd->option[i].value || !*ifd->option[i].value)
+		return NULL;
 
-	return NULL;
+	return ifd->option[i].value;
 }
 
-bool var_true(const char *id, interface_defn *ifd) {
-	char *varvalue = get_var(id, strlen(id), ifd);
+/* Like get_var(), for an option the method declares */
+const char *get_slot_var(const option_slots *slots, int slot, interface_defn *ifd) {
+	int i = find_option_slot(ifd, slots, slot);
 
-	if (varvalue) {
-		if (atoi(varvalue) || strcasecmp(varvalue, "on") == 0 || strcasecmp(varvalue, "true") == 0 || strcasecmp(varvalue, "yes") == 0) {
-			free(varvalue);
-			return true;
-		} else {
-			free(varvalue);
-			return false;
-		}
-	} else {
+	if (i == -1 || !ifd->option[i].value || !*ifd->option[i].value)
+		return NULL;
+
+	return ifd->option[i].value;
+}
+
+static bool is_true(const char *varvalue) {
+	if (!varvalue)
 		return false;
-	}
+
+	return atoi(varvalue) || strcasecmp(varvalue, "on") == 0 || strcasecmp(varvalue, "true") == 0 || strcasecmp(varvalue, "yes") == 0;
+}
+
+bool var_true(const char *id, interface_defn *ifd) {
+	return is_true(get_var(id, strlen(id), ifd));
 }
 
 bool var_set(const char *id, interface_defn *ifd) {
-	char *varvalue = get_var(id, strlen(id), ifd);
+	return get_var(id, strlen(id), ifd) != NULL;
+}
 
-	if (varvalue) {
-		free(varvalue);
-		return true;
-	} else {
-		return false;
-	}
+bool var_true_slot(const option_slots *slots, int slot, interface_defn *ifd) {
+	return is_true(get_slot_var(slots, slot, ifd));
+}
+
+bool var_set_slot(const option_slots *slots, int slot, interface_defn *ifd) {
+	return get_slot_var(slots, slot, ifd) != NULL;
 }
 
 bool var_set_anywhere(const char *id, interface_defn *ifd) {
-	for (interface_defn *currif = defn->ifaces; currif; currif = currif->next) {
-		if (strcmp(ifd->logical_iface, currif->logical_iface) == 0) {
-			char *varvalue = get_var(id, strlen(id), currif);
+	for (interface_defn *currif = find_interface(defn, ifd->logical_iface); currif; currif = currif->next_same) {
+		resolve_options(currif);
 
-			if (varvalue) {
-				free(varvalue);
-				return true;
-			}
-		}
+		if (get_var(id, strlen(id), currif))
+			return true;
 	}
 
 	return false;
@@ -546,40 +1590,57 @@ static int popen2(FILE **in, FILE **out, char *command, ...) {
 		return 0;
 	}
 
+	posix_spawn_file_actions_t actions;
+	posix_spawn_file_actions_init(&actions);
+
+	/* release the current directory */
+#ifdef HAVE_SPAWN_CHDIR
+	posix_spawn_file_actions_addchdir_np(&actions, "/");
+#else
+	/* by changing ours while spawning, if we can get back to it */
+	int cwd = open(".", O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+
+	if (cwd != -1 && chdir("/") == -1) {
+		close(cwd);
+		cwd = -1;
+	}
+#endif
+
+	posix_spawn_file_actions_adddup2(&actions, infd[0], 0);
+	posix_spawn_file_actions_adddup2(&actions, outfd[1], 1);
+	posix_spawn_file_actions_addclose(&actions, infd[0]);
+	posix_spawn_file_actions_addclose(&actions, infd[1]);
+	posix_spawn_file_actions_addclose(&actions, outfd[0]);
+	posix_spawn_file_actions_addclose(&actions, outfd[1]);
+
 	fflush(NULL);
 
-	switch (pid = fork()) {
-	case -1:		/* failure */
-		close(infd[0]);
-		close(infd[1]);
-		close(outfd[0]);
-		close(outfd[1]);
-		return 0;
+	int error = posix_spawnp(&pid, command, &actions, NULL, argv, environ);
+	posix_spawn_file_actions_destroy(&actions);
+
+#ifndef HAVE_SPAWN_CHDIR
+	if (cwd != -1) {
+		if (fchdir(cwd) == -1)
+			err(1, "could not return to the current directory");
 
-	case 0:		/* child */
-		/* release the current directory */
-		if(chdir("/") == -1)
-			// VERY unlikely, but if this fails we probably don't want to continue anyway.
-			err(127, "could not chdir to /");
+		close(cwd);
+	}
+#endif
 
-		dup2(infd[0], 0);
-		dup2(outfd[1], 1);
+	if (error) {
 		close(infd[0]);
 		close(infd[1]);
 		close(outfd[0]);
 		close(outfd[1]);
-		execvp(command, argv);
-		err(127, "executing \"%s\" failed", command);
-
-	default:		/* parent */
-		*in = fdopen(infd[1], "w");
-		*out = fdopen(outfd[0], "r");
-		close(infd[0]);
-		close(outfd[1]);
-		return pid;
+		errno = error;
+		return 0;
 	}
 
-	/* unreached */
+	*in = fdopen(infd[1], "w");
+	*out = fdopen(outfd[0], "r");
+	close(infd[0]);
+	close(outfd[1]);
+	return pid;
 }
 
 bool run_mapping(const char *physical, char *logical, int len, mapping_defn *map) {
@@ -0,0 +1,126 @@
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <err.h>
+
+#include "header.h"
+
+/*
+ * A table of string keys, chained per bucket. The keys are not copied, so
+ * they have to stay around for as long as the table does.
+ */
+
+struct hash_entry {
+	hash_entry *next;
+	const char *key;
+	uint32_t hash;
+	void *value;
+};
+
+uint32_t hash_string(const char *key, size_t len) {
+	/* FNV-1a */
+	uint32_t hash = 2166136261U;
+
+	for (size_t i = 0; i < len; i++) {
+		hash ^= (unsigned char)key[i];
+		hash *= 16777619U;
+	}
+
+	return hash;
+}
+
+/*
+ * The index that a table made by phash.pl has for key, or -1 if there is
+ * none; the name at that index still has to be compared with key. The
+ * hash must stay the same as phash_string() there.
+ */
+int perfect_hash_find(const perfect_hash *table, const char *key) {
+	uint32_t hash = table->seed;
+
+	for (; *key; key++) {
+		hash ^= (unsigned char)*key;
+		hash *= 16777619U;
+	}
+
+	return table->slot[(hash ^ hash >> 16) & table->mask];
+}
+
+static hash_entry *find_entry(const hash_table *table, const char *key, size_t len, uint32_t hash) {
+	if (!table->n_buckets)
+		return NULL;
+
+	for (hash_entry *entry = table->buckets[hash & (table->n_buckets - 1)]; entry; entry = entry->next)
+		if (entry->hash == hash && strncmpz(key, entry->key, len) == 0)
+			return entry;
+
+	return NULL;
+}
+
+void *hash_get(const hash_table *table, const char *key, size_t len) {
+	hash_entry *entry = find_entry(table, key, len, hash_string(key, len));
+
+	return entry ? entry->value : NULL;
+}
+
+static void grow(hash_table *table) {
+	size_t n_buckets = table->n_buckets ? table->n_buckets * 2 : 64;
+	hash_entry **buckets = calloc(n_buckets, sizeof *buckets);
+	if (!buckets)
+		err(1, "calloc");
+
+	for (size_t i = 0; i < table->n_buckets; i++) {
+		hash_entry *next;
+
+		for (hash_entry *entry = table->buckets[i]; entry; entry = next) {
+			next = entry->next;
+			entry->next = buckets[entry->hash & (n_buckets - 1)];
+			buckets[entry->hash & (n_buckets - 1)] = entry;
+		}
+	}
+
+	free(table->buckets);
+	table->buckets = buckets;
+	table->n_buckets = n_buckets;
+}
+
+void hash_set(hash_table *table, const char *key, void *value) {
+	size_t len = strlen(key);
+	uint32_t hash = hash_string(key, len);
+	hash_entry *entry = find_entry(table, key, len, hash);
+
+	if (entry) {
+		entry->value = value;
+		return;
+	}
+
+	if (table->n_entries >= table->n_buckets)
+		grow(table);
+
+	entry = malloc(sizeof *entry);
+	if (!entry)
+		err(1, "malloc");
+
+	*entry = (hash_entry) {
+		.next = table->buckets[hash & (table->n_buckets - 1)],
+		.key = key,
+		.hash = hash,
+		.value = value,
+	};
+
+	table->buckets[hash & (table->n_buckets - 1)] = entry;
+	table->n_entries++;
+}
+
+void hash_clear(hash_table *table) {
+	for (size_t i = 0; i < table->n_buckets; i++) {
+		hash_entry *next;
+
+		for (hash_entry *entry = table->buckets[i]; entry; entry = next) {
+			next = entry->next;
+			free(entry);
+		}
+	}
+
+	free(table->buckets);
+	*table = (hash_table) { NULL, 0, 0 };
+}
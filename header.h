@@ -2,25 +2,68 @@
 #define HEADER_H
 
 #include <stdbool.h>
+#include <stdint.h>
 #include <string.h>
 #include <ifaddrs.h>
+#include <sys/stat.h>
 
 typedef struct address_family address_family;
 typedef struct method method;
 typedef struct conversion conversion;
+typedef enum conversion_source conversion_source;
 typedef struct option_default option_default;
 typedef struct interfaces_file interfaces_file;
 typedef struct allowup_defn allowup_defn;
 typedef struct interface_defn interface_defn;
 typedef struct variable variable;
 typedef struct mapping_defn mapping_defn;
+typedef enum executor executor_type;
+typedef struct template_op template_op;
+typedef enum dependency dependency;
+typedef struct hash_table hash_table;
+typedef struct option_slot option_slot;
+typedef struct hash_entry hash_entry;
+typedef struct matcher matcher;
+typedef struct trie_node trie_node;
+typedef struct name_range name_range;
+typedef struct stanza_body stanza_body;
+typedef struct perfect_hash perfect_hash;
+typedef struct option_slots option_slots;
+typedef struct command_op command_op;
+typedef enum command_kind command_kind;
+typedef enum stanza_word stanza_word;
 typedef int (execfn) (const char *command);
 typedef int (command_set) (interface_defn *ifd, execfn *e);
 
+/* A collision-free table for a fixed set of names, made at build time by phash.pl */
+struct perfect_hash {
+	uint32_t seed;
+	uint32_t mask;			/* the number of slots - 1 */
+	const signed char *slot;	/* the index of the name that hashes here, or -1 */
+};
+
 struct address_family {
 	char *name;
 	int n_methods;
 	method *method;
+	perfect_hash method_hash;
+};
+
+/*
+ * The words that start something other than an option line. keywords.pl
+ * makes a perfect hash of the quoted words; the others match by prefix.
+ */
+enum stanza_word {
+	STANZA_NONE = -1,
+	STANZA_MAPPING,			/* "mapping" */
+	STANZA_SOURCE,			/* "source" */
+	STANZA_SOURCE_DIRECTORY,	/* "source-directory", or anything starting with source-dir */
+	STANZA_IFACE,			/* "iface" */
+	STANZA_AUTO,			/* "auto" */
+	STANZA_ALLOW,			/* anything longer starting with allow- */
+	STANZA_NO_AUTO_DOWN,		/* "no-auto-down" */
+	STANZA_NO_SCRIPTS,		/* "no-scripts" */
+	STANZA_RENAME,			/* "rename" */
 };
 
 struct method {
@@ -28,11 +71,33 @@ struct method {
 	command_set *up, *down, *rename;
 	conversion *conversions;
 	option_default *defaults;
+	const option_slots *slots;
+	const command_op *up_ops, *down_ops, *rename_ops;	/* what up, down and rename run */
+};
+
+/*
+ * The options a method declares in its .defn, numbered by defn2c.pl, so
+ * that its commands and conversions can find them without comparing names.
+ */
+struct option_slots {
+	int n_slots;
+	const char *const *name;
+};
+
+/* Where the values a conversion starts from come from */
+enum conversion_source {
+	CONVERT_END,		/* the end of the plan */
+	CONVERT_OPTION,		/* every value of option */
+	CONVERT_IFACE,		/* the name of the interface */
 };
 
+/* A step of the conversion plan of a method, as emitted by defn2c.pl */
 struct conversion {
+	conversion_source source;
 	char *option;
-	char *newoption;
+	size_t option_len;
+	int slot;		/* of option in the method's option_slots, or -1 */
+	char *newoption;	/* NULL to convert the values in place */
 	void (*fn) (interface_defn *, char **, int, char **);
 	int argc;
 	char **argv;
@@ -43,10 +108,37 @@ struct option_default {
 	char *value;
 };
 
+struct hash_table {
+	hash_entry **buckets;
+	size_t n_buckets;
+	size_t n_entries;
+};
+
+struct matcher {
+	int flags;		/* for fnmatch() */
+	int n_patterns;		/* number of patterns compiled so far */
+	hash_table literals;
+	trie_node *prefixes;	/* patterns of the form "prefix*" */
+	int n_complex;
+	char **complex;		/* everything else, for fnmatch() */
+	int n_ranges;
+	char **ranges;		/* patterns with a {FIRST..LAST} range, see in_range() */
+};
+
 struct interfaces_file {
 	allowup_defn *allowups;
 	interface_defn *ifaces;
 	mapping_defn *mappings;
+
+	interface_defn *last_iface;
+	mapping_defn *last_mapping;
+	hash_table iface_index;		/* logical name -> first stanza with that name */
+	hash_table allowup_index;	/* class name -> allowup_defn */
+	hash_table vlan_index;		/* parent name -> its VLANs */
+
+	interface_defn *ranges;		/* stanzas with a range in their name */
+	interface_defn *last_range;
+	hash_table instantiated;	/* names the ranges have been instantiated for */
 };
 
 struct allowup_defn {
@@ -56,10 +148,15 @@ struct allowup_defn {
 	int max_interfaces;
 	int n_interfaces;
 	char **interfaces;
+
+	hash_table members;		/* the entries of interfaces, for de-duplication */
 };
 
 struct interface_defn {
 	interface_defn *next;
+	interface_defn *next_same;	/* next stanza with the same logical name */
+	interface_defn *next_vlan;	/* next VLAN with the same parent, first stanzas only */
+	interface_defn *next_range;	/* next stanza with a range in its name */
 
 	char *logical_iface;
 	char *real_iface;
@@ -70,11 +167,51 @@ struct interface_defn {
 	int max_options;
 	int n_options;
 	variable *option;
+
+	option_slot *option_index;	/* built once a stanza has OPTION_INDEX_MIN options */
+	int n_slots;
+
+	const option_slots *slotted;	/* what slot_option is for, or NULL if it has to be rebuilt */
+	int *slot_option;		/* for each slot, the index of its first option, or -1 */
+
+	interface_defn *inherits;	/* until resolve_options(), options not set here come from here */
+	interface_defn *heirs;		/* stanzas inheriting from this one */
+	interface_defn *next_heir;
+
+	stanza_body *body;		/* options not parsed yet, see load_options() */
+	const char *prepared_for;	/* interned interface name the options were converted for */
+};
+
+/* Where the option lines of a stanza are in a mapped interfaces file */
+struct stanza_body {
+	const char *start;
+	const char *end;	/* of the file */
+	int line;		/* of the iface line */
+};
+
+/* A name with a {FIRST..LAST} range of numbers in it, like eth0.{100..199} */
+struct name_range {
+	size_t prefix_len;	/* up to the '{' */
+	const char *suffix;	/* after the '}' */
+	long first;
+	long last;
 };
 
+/* The most names a range may have, as ifup -a and the command line write them all out */
+#define MAX_RANGE_NAMES 65536
+
 struct variable {
-	char *name;
+	char *name;		/* interned */
 	char *value;
+	int next_same;		/* next option with the same name, while option_index is valid */
+};
+
+#define OPTION_INDEX_MIN 8
+
+struct option_slot {
+	uint32_t hash;
+	int first;		/* -1 if the slot is empty */
+	int last;
 };
 
 struct mapping_defn {
@@ -83,6 +220,7 @@ struct mapping_defn {
 	int max_matches;
 	int n_matches;
 	char **match;
+	matcher compiled;	/* match, compiled for lookups */
 
 	char *script;
 
@@ -91,6 +229,68 @@ struct mapping_defn {
 	char **mapping;
 };
 
+enum executor {
+	EXECUTOR_SHELL,
+	EXECUTOR_COPROC,
+	EXECUTOR_NETLINK,
+	EXECUTOR_BATCH,
+};
+
+/* A command template as compiled by defn2c.pl */
+enum template_opcode {
+	TEMPLATE_END,
+	TEMPLATE_TEXT,
+	TEMPLATE_VAR,
+	TEMPLATE_OPEN,
+	TEMPLATE_CLOSE,
+};
+
+struct template_op {
+	enum template_opcode opcode;
+	const char *str;
+	size_t len;
+	int slot;		/* of a variable in the method's option_slots, or -1 */
+	char pat, rep;
+};
+
+/* What a command of a method does, as far as defn2c.pl can tell from its text */
+enum command_kind {
+	COMMAND_END,		/* the end of the steps */
+	COMMAND_SHELL,		/* anything not below; needs a shell */
+	COMMAND_IP,		/* another ip command */
+	COMMAND_LINK_SET,	/* ip link set */
+	COMMAND_ADDR_ADD,	/* ip addr add */
+	COMMAND_ADDR_DEL,	/* ip addr del */
+	COMMAND_ADDR_FLUSH,	/* ip addr flush */
+	COMMAND_ROUTE_ADD,	/* ip route add */
+	COMMAND_ROUTE_REPLACE,	/* ip route replace */
+	COMMAND_ROUTE_DEL,	/* ip route del */
+	COMMAND_SYSCTL,		/* sysctl */
+};
+
+/*
+ * A step of the up, down or rename commands of a method, as emitted by
+ * defn2c.pl. The step runs if its condition holds; an elsif step only if
+ * no earlier condition of its if ... elsif chain did.
+ */
+struct command_op {
+	command_kind kind;
+	int family;		/* 4 or 6 for ip -4 or ip -6, 0 otherwise */
+	bool (*condition)(interface_defn *ifd);	/* NULL to run always */
+	bool elsif;
+	const template_op *program;	/* NULL if the command could not be compiled */
+	const char *command;	/* as written in the .defn, for execute() */
+};
+
+/* What a cached configuration depends on, see cache.c */
+enum dependency {
+	DEPEND_FILE,	/* the interfaces file itself */
+	DEPEND_SOURCE,	/* a file read because of source or source-dir */
+	DEPEND_DIR,	/* a directory read because of source-dir */
+	DEPEND_GLOB,	/* a directory that a wildcard was matched against */
+	DEPEND_ABSENT,	/* a path that has to stay absent */
+};
+
 #define MAX_OPT_DEPTH 10
 #define EUNBALBRACK 10001
 #define EUNDEFVAR   10002
@@ -105,14 +305,61 @@ struct mapping_defn {
 #endif
 
 extern address_family *addr_fams[];
+extern const perfect_hash addr_fam_hash;
+extern const char *const stanza_words[];
+extern const perfect_hash stanza_word_hash;
 extern struct ifaddrs *ifap;
 
-variable *set_variable(const char *name, const char *value, variable **var, int *n_vars, int *max_vars);
-void convert_variables(conversion *conversions, interface_defn *ifd);
-interfaces_file *read_interfaces(const char *filename);
+address_family *get_address_family(const char *name);
+method *get_method(const address_family *af, const char *name);
+variable *set_option(interface_defn *ifd, const char *name, const char *value);
+int find_option(interface_defn *ifd, const char *name, size_t len);
+int find_option_slot(interface_defn *ifd, const option_slots *slots, int slot);
+int next_option(interface_defn *ifd, int i);
+void remove_option(interface_defn *ifd, int i);
+void clear_option_index(interface_defn *ifd);
+void flatten_options(interface_defn *ifd, interface_defn *flat);
+void resolve_options(interface_defn *ifd);
+bool multi_valued(const char *name);
+void convert_variables(const method *meth, interface_defn *ifd);
+interfaces_file *read_interfaces(const char *filename, const char *cachefile, bool lazy_options);
+void add_interface(interfaces_file *defn, interface_defn *iface);
+void add_mapping(interfaces_file *defn, mapping_defn *map);
+interface_defn *find_interface(interfaces_file *defn, const char *name);
+size_t vlan_parent_len(const char *iface);
+bool parse_range(const char *name, name_range *range);
+char *range_name(const char *name, const name_range *range, long i);
+bool in_range(const char *pattern, const char *name);
+interface_defn *find_vlans(interfaces_file *defn, const char *parent);
+void *arena_alloc(size_t size);
+char *arena_strndup(const char *str, size_t len);
+char *arena_strdup(const char *str);
+void arena_adopt(void *start, size_t size);
+bool arena_owns(const void *ptr);
+void arena_free(void);
+char *intern(const char *str, size_t len);
+void release_string(char *str);
+char *resize_string(char *str, size_t size);
+uint32_t hash_string(const char *key, size_t len);
+void *hash_get(const hash_table *table, const char *key, size_t len);
+void hash_set(hash_table *table, const char *key, void *value);
+void hash_clear(hash_table *table);
+int perfect_hash_find(const perfect_hash *table, const char *key);
+void cache_begin(void);
+void cache_disable(void);
+void cache_depend(const char *path, dependency kind);
+void cache_depend_stat(const char *path, dependency kind, const struct stat *st);
+void cache_depend_pattern(const char *pattern);
+void cache_save(const char *cachefile, const char *filename, interfaces_file *defn, bool no_loopback_before, int first_in_list[3]);
+interfaces_file *cache_load(const char *cachefile, const char *filename);
 allowup_defn *find_allowup(interfaces_file *defn, const char *name);
-bool match_patterns(const char *string, int argc, char *argv[]);
+void add_allowup(interfaces_file *defn, allowup_defn *allowup);
+bool matcher_match(matcher *m, const char *string, int n_patterns, char *patterns[]);
 int doit(const char *str);
+int flush_commands(void);
+void report_skipped_commands(void);
+char **split_command(const char *command);
+bool netlink_execute(const char *command, bool *okay);
 int iface_preup(interface_defn *iface);
 int iface_postup(interface_defn *iface);
 int iface_up(interface_defn *iface);
@@ -122,13 +369,18 @@ int iface_down(interface_defn *iface);
 int iface_list(interface_defn *iface);
 int iface_query(interface_defn *iface);
 int execute(const char *command, interface_defn *ifd, execfn *exec);
+int execute_template(const template_op *program, const option_slots *slots, interface_defn *ifd, execfn *exec);
+int execute_ops(const command_op *ops, const option_slots *slots, interface_defn *ifd, execfn *exec);
 int strncmpz(const char *l, const char *r, size_t llen);
 
 #define strlmatch(l,r) strncmp(l,r,strlen(r))
 
-char *get_var(const char *id, size_t idlen, interface_defn *ifd);
+const char *get_var(const char *id, size_t idlen, interface_defn *ifd);
 bool var_true(const char *id, interface_defn *ifd);
 bool var_set(const char *id, interface_defn *ifd);
+const char *get_slot_var(const option_slots *slots, int slot, interface_defn *ifd);
+bool var_true_slot(const option_slots *slots, int slot, interface_defn *ifd);
+bool var_set_slot(const option_slots *slots, int slot, interface_defn *ifd);
 bool var_set_anywhere(const char *id, interface_defn *ifd);
 bool run_mapping(const char *physical, char *logical, int len, mapping_defn *map);
 void sanitize_env_name(char *name);
@@ -141,6 +393,8 @@ extern bool verbose;
 extern bool run_scripts;
 extern bool no_loopback;
 extern bool ignore_failures;
+extern bool skip_redundant;
+extern executor_type executor;
 extern volatile bool interrupted;
 extern interfaces_file *defn;
 extern address_family addr_link;
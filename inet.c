@@ -0,0 +1,820 @@
+#include <stddef.h>
+#include "header.h"
+
+
+#include "archcommon.h"
+#include "archlinux.h"
+
+
+static option_default _loopback_default[] = {
+	{ NULL, NULL }
+};
+static conversion _loopback_conv[] = {
+	{ CONVERT_END, NULL, 0, -1, NULL, NULL, 0, NULL }
+};
+static const char *const _loopback_slot_names[] = {
+	NULL
+};
+static const option_slots _loopback_slots = { 0, _loopback_slot_names };
+static bool _loopback_up_if_0(interface_defn *ifd) { return !iface_is_lo(); }
+static const template_op _loopback_up_0[] = {
+    { TEMPLATE_TEXT, "ip link set dev ", 16, -1, 0, 0 },
+    { TEMPLATE_VAR, "iface", 5, -1, 0, 0 },
+    { TEMPLATE_TEXT, " up", 3, -1, 0, 0 },
+    { TEMPLATE_END, NULL, 0, -1, 0, 0 },
+};
+static const command_op _loopback_up_ops[] = {
+	{ COMMAND_LINK_SET, 0, _loopback_up_if_0, false, _loopback_up_0, "ip link set dev %iface% up" },
+	{ COMMAND_END, 0, NULL, false, NULL, NULL }
+};
+static int _loopback_up(interface_defn *ifd, execfn *exec) {
+	return execute_ops(_loopback_up_ops, &_loopback_slots, ifd, exec);
+}
+static bool _loopback_down_if_0(interface_defn *ifd) { return !iface_is_lo(); }
+static const template_op _loopback_down_0[] = {
+    { TEMPLATE_TEXT, "ip link set dev ", 16, -1, 0, 0 },
+    { TEMPLATE_VAR, "iface", 5, -1, 0, 0 },
+    { TEMPLATE_TEXT, " down", 5, -1, 0, 0 },
+    { TEMPLATE_END, NULL, 0, -1, 0, 0 },
+};
+static const command_op _loopback_down_ops[] = {
+	{ COMMAND_LINK_SET, 0, _loopback_down_if_0, false, _loopback_down_0, "ip link set dev %iface% down" },
+	{ COMMAND_END, 0, NULL, false, NULL, NULL }
+};
+static int _loopback_down(interface_defn *ifd, execfn *exec) {
+	return execute_ops(_loopback_down_ops, &_loopback_slots, ifd, exec);
+}
+static const command_op _loopback_rename_ops[] = { { COMMAND_END, 0, NULL, false, NULL, NULL } };
+static int _loopback_rename(interface_defn *ifd, execfn *exec) { return 0; }
+static option_default _static_default[] = {
+	{ "broadcast", "+" },
+	{ NULL, NULL }
+};
+static conversion _static_conv[] = {
+	{ CONVERT_OPTION, "hwaddress", 9, 6, NULL, cleanup_hwaddress, 0, NULL },
+	{ CONVERT_OPTION, "address", 7, 0, "netmask?", compute_v4_mask, 0, NULL },
+	{ CONVERT_OPTION, "address", 7, 0, NULL, compute_v4_addr, 0, NULL },
+	{ CONVERT_OPTION, "broadcast", 9, 2, NULL, compute_v4_broadcast, 0, NULL },
+	{ CONVERT_END, NULL, 0, -1, NULL, NULL, 0, NULL }
+};
+static const char *const _static_slot_names[] = {
+	"address",
+	"netmask",
+	"broadcast",
+	"metric",
+	"gateway",
+	"pointopoint",
+	"hwaddress",
+	"mtu",
+	"scope",
+	"netmask?",
+	NULL
+};
+static const option_slots _static_slots = { 10, _static_slot_names };
+static const template_op _static_up_0[] = {
+    { TEMPLATE_TEXT, "ip addr add ", 12, -1, 0, 0 },
+    { TEMPLATE_VAR, "address", 7, 0, 0, 0 },
+    { TEMPLATE_OPEN, NULL, 0, -1, 0, 0 },
+    { TEMPLATE_TEXT, "/", 1, -1, 0, 0 },
+    { TEMPLATE_VAR, "netmask", 7, 1, 0, 0 },
+    { TEMPLATE_CLOSE, NULL, 0, -1, 0, 0 },
+    { TEMPLATE_TEXT, " ", 1, -1, 0, 0 },
+    { TEMPLATE_OPEN, NULL, 0, -1, 0, 0 },
+    { TEMPLATE_TEXT, "broadcast ", 10, -1, 0, 0 },
+    { TEMPLATE_VAR, "broadcast", 9, 2, 0, 0 },
+    { TEMPLATE_CLOSE, NULL, 0, -1, 0, 0 },
+    { TEMPLATE_TEXT, " \t", 2, -1, 0, 0 },
+    { TEMPLATE_OPEN, NULL, 0, -1, 0, 0 },
+    { TEMPLATE_TEXT, "peer ", 5, -1, 0, 0 },
+    { TEMPLATE_VAR, "pointopoint", 11, 5, 0, 0 },
+    { TEMPLATE_CLOSE, NULL, 0, -1, 0, 0 },
+    { TEMPLATE_TEXT, " ", 1, -1, 0, 0 },
+    { TEMPLATE_OPEN, NULL, 0, -1, 0, 0 },
+    { TEMPLATE_TEXT, "scope ", 6, -1, 0, 0 },
+    { TEMPLATE_VAR, "scope", 5, 8, 0, 0 },
+    { TEMPLATE_CLOSE, NULL, 0, -1, 0, 0 },
+    { TEMPLATE_TEXT, " dev ", 5, -1, 0, 0 },
+    { TEMPLATE_VAR, "iface", 5, -1, 0, 0 },
+    { TEMPLATE_TEXT, " label ", 7, -1, 0, 0 },
+    { TEMPLATE_VAR, "iface", 5, -1, 0, 0 },
+    { TEMPLATE_END, NULL, 0, -1, 0, 0 },
+};
+static const template_op _static_up_1[] = {
+    { TEMPLATE_TEXT, "ip link set dev ", 16, -1, 0, 0 },
+    { TEMPLATE_VAR, "iface", 5, -1, 0, 0 },
+    { TEMPLATE_TEXT, " ", 1, -1, 0, 0 },
+    { TEMPLATE_OPEN, NULL, 0, -1, 0, 0 },
+    { TEMPLATE_TEXT, "mtu ", 4, -1, 0, 0 },
+    { TEMPLATE_VAR, "mtu", 3, 7, 0, 0 },
+    { TEMPLATE_CLOSE, NULL, 0, -1, 0, 0 },
+    { TEMPLATE_TEXT, " ", 1, -1, 0, 0 },
+    { TEMPLATE_OPEN, NULL, 0, -1, 0, 0 },
+    { TEMPLATE_TEXT, "address ", 8, -1, 0, 0 },
+    { TEMPLATE_VAR, "hwaddress", 9, 6, 0, 0 },
+    { TEMPLATE_CLOSE, NULL, 0, -1, 0, 0 },
+    { TEMPLATE_TEXT, " up", 3, -1, 0, 0 },
+    { TEMPLATE_END, NULL, 0, -1, 0, 0 },
+};
+static const template_op _static_up_2[] = {
+    { TEMPLATE_OPEN, NULL, 0, -1, 0, 0 },
+    { TEMPLATE_TEXT, " ip route add default via ", 26, -1, 0, 0 },
+    { TEMPLATE_VAR, "gateway", 7, 4, 0, 0 },
+    { TEMPLATE_TEXT, " ", 1, -1, 0, 0 },
+    { TEMPLATE_OPEN, NULL, 0, -1, 0, 0 },
+    { TEMPLATE_TEXT, "metric ", 7, -1, 0, 0 },
+    { TEMPLATE_VAR, "metric", 6, 3, 0, 0 },
+    { TEMPLATE_CLOSE, NULL, 0, -1, 0, 0 },
+    { TEMPLATE_TEXT, " dev ", 5, -1, 0, 0 },
+    { TEMPLATE_VAR, "iface", 5, -1, 0, 0 },
+    { TEMPLATE_TEXT, " onlink ", 8, -1, 0, 0 },
+    { TEMPLATE_CLOSE, NULL, 0, -1, 0, 0 },
+    { TEMPLATE_END, NULL, 0, -1, 0, 0 },
+};
+static const command_op _static_up_ops[] = {
+	{ COMMAND_ADDR_ADD, 0, NULL, false, _static_up_0, "ip addr add %address%[[/%netmask%]] [[broadcast %broadcast%]] \
+	[[peer %pointopoint%]] [[scope %scope%]] dev %iface% label %iface%" },
+	{ COMMAND_LINK_SET, 0, NULL, false, _static_up_1, "ip link set dev %iface% [[mtu %mtu%]] [[address %hwaddress%]] up" },
+	{ COMMAND_ROUTE_ADD, 0, NULL, false, _static_up_2, "[[ ip route add default via %gateway% [[metric %metric%]] dev %iface% onlink ]]" },
+	{ COMMAND_END, 0, NULL, false, NULL, NULL }
+};
+static int _static_up(interface_defn *ifd, execfn *exec) {
+	return execute_ops(_static_up_ops, &_static_slots, ifd, exec);
+}
+static const template_op _static_down_0[] = {
+    { TEMPLATE_OPEN, NULL, 0, -1, 0, 0 },
+    { TEMPLATE_TEXT, " ip route del default via ", 26, -1, 0, 0 },
+    { TEMPLATE_VAR, "gateway", 7, 4, 0, 0 },
+    { TEMPLATE_TEXT, " ", 1, -1, 0, 0 },
+    { TEMPLATE_OPEN, NULL, 0, -1, 0, 0 },
+    { TEMPLATE_TEXT, "metric ", 7, -1, 0, 0 },
+    { TEMPLATE_VAR, "metric", 6, 3, 0, 0 },
+    { TEMPLATE_CLOSE, NULL, 0, -1, 0, 0 },
+    { TEMPLATE_TEXT, " dev ", 5, -1, 0, 0 },
+    { TEMPLATE_VAR, "iface", 5, -1, 0, 0 },
+    { TEMPLATE_TEXT, " 2>&1 1>/dev/null || true ", 26, -1, 0, 0 },
+    { TEMPLATE_CLOSE, NULL, 0, -1, 0, 0 },
+    { TEMPLATE_END, NULL, 0, -1, 0, 0 },
+};
+static const template_op _static_down_1[] = {
+    { TEMPLATE_TEXT, "ip addr del ", 12, -1, 0, 0 },
+    { TEMPLATE_VAR, "address", 7, 0, 0, 0 },
+    { TEMPLATE_OPEN, NULL, 0, -1, 0, 0 },
+    { TEMPLATE_TEXT, "/", 1, -1, 0, 0 },
+    { TEMPLATE_VAR, "netmask", 7, 1, 0, 0 },
+    { TEMPLATE_CLOSE, NULL, 0, -1, 0, 0 },
+    { TEMPLATE_TEXT, " ", 1, -1, 0, 0 },
+    { TEMPLATE_OPEN, NULL, 0, -1, 0, 0 },
+    { TEMPLATE_TEXT, "broadcast ", 10, -1, 0, 0 },
+    { TEMPLATE_VAR, "broadcast", 9, 2, 0, 0 },
+    { TEMPLATE_CLOSE, NULL, 0, -1, 0, 0 },
+    { TEMPLATE_TEXT, " \t", 2, -1, 0, 0 },
+    { TEMPLATE_OPEN, NULL, 0, -1, 0, 0 },
+    { TEMPLATE_TEXT, "peer ", 5, -1, 0, 0 },
+    { TEMPLATE_VAR, "pointopoint", 11, 5, 0, 0 },
+    { TEMPLATE_CLOSE, NULL, 0, -1, 0, 0 },
+    { TEMPLATE_TEXT, " ", 1, -1, 0, 0 },
+    { TEMPLATE_OPEN, NULL, 0, -1, 0, 0 },
+    { TEMPLATE_TEXT, "scope ", 6, -1, 0, 0 },
+    { TEMPLATE_VAR, "scope", 5, 8, 0, 0 },
+    { TEMPLATE_CLOSE, NULL, 0, -1, 0, 0 },
+    { TEMPLATE_TEXT, " dev ", 5, -1, 0, 0 },
+    { TEMPLATE_VAR, "iface", 5, -1, 0, 0 },
+    { TEMPLATE_TEXT, " label ", 7, -1, 0, 0 },
+    { TEMPLATE_VAR, "iface", 5, -1, 0, 0 },
+    { TEMPLATE_END, NULL, 0, -1, 0, 0 },
+};
+static bool _static_down_if_2(interface_defn *ifd) { return iface_is_link(); }
+static const template_op _static_down_2[] = {
+    { TEMPLATE_TEXT, "ip -4 addr flush dev ", 21, -1, 0, 0 },
+    { TEMPLATE_VAR, "iface", 5, -1, 0, 0 },
+    { TEMPLATE_END, NULL, 0, -1, 0, 0 },
+};
+static bool _static_down_if_3(interface_defn *ifd) { return iface_is_link(); }
+static const template_op _static_down_3[] = {
+    { TEMPLATE_TEXT, "ip link set dev ", 16, -1, 0, 0 },
+    { TEMPLATE_VAR, "iface", 5, -1, 0, 0 },
+    { TEMPLATE_TEXT, " down", 5, -1, 0, 0 },
+    { TEMPLATE_END, NULL, 0, -1, 0, 0 },
+};
+static const command_op _static_down_ops[] = {
+	{ COMMAND_ROUTE_DEL, 0, NULL, false, _static_down_0, "[[ ip route del default via %gateway% [[metric %metric%]] dev %iface% 2>&1 1>/dev/null || true ]]" },
+	{ COMMAND_ADDR_DEL, 0, NULL, false, _static_down_1, "ip addr del %address%[[/%netmask%]] [[broadcast %broadcast%]] \
+	[[peer %pointopoint%]] [[scope %scope%]] dev %iface% label %iface%" },
+	{ COMMAND_ADDR_FLUSH, 4, _static_down_if_2, false, _static_down_2, "ip -4 addr flush dev %iface%" },
+	{ COMMAND_LINK_SET, 0, _static_down_if_3, false, _static_down_3, "ip link set dev %iface% down" },
+	{ COMMAND_END, 0, NULL, false, NULL, NULL }
+};
+static int _static_down(interface_defn *ifd, execfn *exec) {
+	return execute_ops(_static_down_ops, &_static_slots, ifd, exec);
+}
+static const command_op _static_rename_ops[] = { { COMMAND_END, 0, NULL, false, NULL, NULL } };
+static int _static_rename(interface_defn *ifd, execfn *exec) { return 0; }
+static option_default _manual_default[] = {
+	{ NULL, NULL }
+};
+static conversion _manual_conv[] = {
+	{ CONVERT_OPTION, "hwaddress", 9, 0, NULL, cleanup_hwaddress, 0, NULL },
+	{ CONVERT_END, NULL, 0, -1, NULL, NULL, 0, NULL }
+};
+static const char *const _manual_slot_names[] = {
+	"hwaddress",
+	"mtu",
+	NULL
+};
+static const option_slots _manual_slots = { 2, _manual_slot_names };
+static const template_op _manual_up_0[] = {
+    { TEMPLATE_OPEN, NULL, 0, -1, 0, 0 },
+    { TEMPLATE_TEXT, "ip link set dev ", 16, -1, 0, 0 },
+    { TEMPLATE_VAR, "iface", 5, -1, 0, 0 },
+    { TEMPLATE_TEXT, " mtu ", 5, -1, 0, 0 },
+    { TEMPLATE_VAR, "mtu", 3, 1, 0, 0 },
+    { TEMPLATE_CLOSE, NULL, 0, -1, 0, 0 },
+    { TEMPLATE_END, NULL, 0, -1, 0, 0 },
+};
+static const template_op _manual_up_1[] = {
+    { TEMPLATE_OPEN, NULL, 0, -1, 0, 0 },
+    { TEMPLATE_TEXT, "ip link set dev ", 16, -1, 0, 0 },
+    { TEMPLATE_VAR, "iface", 5, -1, 0, 0 },
+    { TEMPLATE_TEXT, " address ", 9, -1, 0, 0 },
+    { TEMPLATE_VAR, "hwaddress", 9, 0, 0, 0 },
+    { TEMPLATE_CLOSE, NULL, 0, -1, 0, 0 },
+    { TEMPLATE_END, NULL, 0, -1, 0, 0 },
+};
+static const template_op _manual_up_2[] = {
+    { TEMPLATE_TEXT, "ip link set dev ", 16, -1, 0, 0 },
+    { TEMPLATE_VAR, "iface", 5, -1, 0, 0 },
+    { TEMPLATE_TEXT, " up 2>/dev/null || true", 23, -1, 0, 0 },
+    { TEMPLATE_END, NULL, 0, -1, 0, 0 },
+};
+static const command_op _manual_up_ops[] = {
+	{ COMMAND_LINK_SET, 0, NULL, false, _manual_up_0, "[[ip link set dev %iface% mtu %mtu%]]" },
+	{ COMMAND_LINK_SET, 0, NULL, false, _manual_up_1, "[[ip link set dev %iface% address %hwaddress%]]" },
+	{ COMMAND_LINK_SET, 0, NULL, false, _manual_up_2, "ip link set dev %iface% up 2>/dev/null || true" },
+	{ COMMAND_END, 0, NULL, false, NULL, NULL }
+};
+static int _manual_up(interface_defn *ifd, execfn *exec) {
+	return execute_ops(_manual_up_ops, &_manual_slots, ifd, exec);
+}
+static bool _manual_down_if_0(interface_defn *ifd) { return iface_is_link(); }
+static const template_op _manual_down_0[] = {
+    { TEMPLATE_TEXT, "ip -4 addr flush dev ", 21, -1, 0, 0 },
+    { TEMPLATE_VAR, "iface", 5, -1, 0, 0 },
+    { TEMPLATE_TEXT, " 2>/dev/null || true", 20, -1, 0, 0 },
+    { TEMPLATE_END, NULL, 0, -1, 0, 0 },
+};
+static bool _manual_down_if_1(interface_defn *ifd) { return iface_is_link() && !do_all; }
+static const template_op _manual_down_1[] = {
+    { TEMPLATE_TEXT, "ip link set dev ", 16, -1, 0, 0 },
+    { TEMPLATE_VAR, "iface", 5, -1, 0, 0 },
+    { TEMPLATE_TEXT, " down 2>/dev/null || true", 25, -1, 0, 0 },
+    { TEMPLATE_END, NULL, 0, -1, 0, 0 },
+};
+static const command_op _manual_down_ops[] = {
+	{ COMMAND_ADDR_FLUSH, 4, _manual_down_if_0, false, _manual_down_0, "ip -4 addr flush dev %iface% 2>/dev/null || true" },
+	{ COMMAND_LINK_SET, 0, _manual_down_if_1, false, _manual_down_1, "ip link set dev %iface% down 2>/dev/null || true" },
+	{ COMMAND_END, 0, NULL, false, NULL, NULL }
+};
+static int _manual_down(interface_defn *ifd, execfn *exec) {
+	return execute_ops(_manual_down_ops, &_manual_slots, ifd, exec);
+}
+static const command_op _manual_rename_ops[] = { { COMMAND_END, 0, NULL, false, NULL, NULL } };
+static int _manual_rename(interface_defn *ifd, execfn *exec) { return 0; }
+static option_default _dhcp_default[] = {
+	{ NULL, NULL }
+};
+static conversion _dhcp_conv[] = {
+	{ CONVERT_OPTION, "hwaddress", 9, 5, NULL, cleanup_hwaddress, 0, NULL },
+	{ CONVERT_END, NULL, 0, -1, NULL, NULL, 0, NULL }
+};
+static const char *const _dhcp_slot_names[] = {
+	"hostname",
+	"metric",
+	"leasetime",
+	"vendor",
+	"client",
+	"hwaddress",
+	NULL
+};
+static const option_slots _dhcp_slots = { 6, _dhcp_slot_names };
+static const template_op _dhcp_up_0[] = {
+    { TEMPLATE_OPEN, NULL, 0, -1, 0, 0 },
+    { TEMPLATE_TEXT, "ip link set dev ", 16, -1, 0, 0 },
+    { TEMPLATE_VAR, "iface", 5, -1, 0, 0 },
+    { TEMPLATE_TEXT, " address ", 9, -1, 0, 0 },
+    { TEMPLATE_VAR, "hwaddress", 9, 5, 0, 0 },
+    { TEMPLATE_CLOSE, NULL, 0, -1, 0, 0 },
+    { TEMPLATE_END, NULL, 0, -1, 0, 0 },
+};
+static bool _dhcp_up_if_1(interface_defn *ifd) { return execable("dhclient"); }
+static const template_op _dhcp_up_1[] = {
+    { TEMPLATE_TEXT, "CLIENT=\"-i\"; ", 13, -1, 0, 0 },
+    { TEMPLATE_OPEN, NULL, 0, -1, 0, 0 },
+    { TEMPLATE_TEXT, "[ \"", 3, -1, 0, 0 },
+    { TEMPLATE_VAR, "client", 6, 4, 0, 0 },
+    { TEMPLATE_TEXT, "\" = no ] && CLIENT=\"\";", 22, -1, 0, 0 },
+    { TEMPLATE_CLOSE, NULL, 0, -1, 0, 0 },
+    { TEMPLATE_TEXT, " dhclient -4 -v $CLIENT -pf /run/dhclient.", 42, -1, 0, 0 },
+    { TEMPLATE_VAR, "iface", 5, -1, 0, 0 },
+    { TEMPLATE_TEXT, ".pid -lf /var/lib/dhcp/dhclient.", 32, -1, 0, 0 },
+    { TEMPLATE_VAR, "iface", 5, -1, 0, 0 },
+    { TEMPLATE_TEXT, ".leases -I -df /var/lib/dhcp/dhclient6.", 39, -1, 0, 0 },
+    { TEMPLATE_VAR, "iface", 5, -1, 0, 0 },
+    { TEMPLATE_TEXT, ".leases ", 8, -1, 0, 0 },
+    { TEMPLATE_VAR, "iface", 5, -1, 0, 0 },
+    { TEMPLATE_TEXT, " \t", 2, -1, 0, 0 },
+    { TEMPLATE_OPEN, NULL, 0, -1, 0, 0 },
+    { TEMPLATE_TEXT, "-e IF_METRIC=", 13, -1, 0, 0 },
+    { TEMPLATE_VAR, "metric", 6, 1, 0, 0 },
+    { TEMPLATE_CLOSE, NULL, 0, -1, 0, 0 },
+    { TEMPLATE_END, NULL, 0, -1, 0, 0 },
+};
+static bool _dhcp_up_if_2(interface_defn *ifd) { return execable("udhcpc"); }
+static const template_op _dhcp_up_2[] = {
+    { TEMPLATE_TEXT, "udhcpc -n -p /run/udhcpc.", 25, -1, 0, 0 },
+    { TEMPLATE_VAR, "iface", 5, -1, 0, 0 },
+    { TEMPLATE_TEXT, ".pid -i ", 8, -1, 0, 0 },
+    { TEMPLATE_VAR, "iface", 5, -1, 0, 0 },
+    { TEMPLATE_TEXT, " ", 1, -1, 0, 0 },
+    { TEMPLATE_OPEN, NULL, 0, -1, 0, 0 },
+    { TEMPLATE_TEXT, "-x hostname:", 12, -1, 0, 0 },
+    { TEMPLATE_VAR, "hostname", 8, 0, 0, 0 },
+    { TEMPLATE_CLOSE, NULL, 0, -1, 0, 0 },
+    { TEMPLATE_END, NULL, 0, -1, 0, 0 },
+};
+static bool _dhcp_up_if_3(interface_defn *ifd) { return execable("dhcpcd"); }
+static const template_op _dhcp_up_3[] = {
+    { TEMPLATE_TEXT, "dhcpcd ", 7, -1, 0, 0 },
+    { TEMPLATE_OPEN, NULL, 0, -1, 0, 0 },
+    { TEMPLATE_TEXT, "-h ", 3, -1, 0, 0 },
+    { TEMPLATE_VAR, "hostname", 8, 0, 0, 0 },
+    { TEMPLATE_CLOSE, NULL, 0, -1, 0, 0 },
+    { TEMPLATE_TEXT, " ", 1, -1, 0, 0 },
+    { TEMPLATE_OPEN, NULL, 0, -1, 0, 0 },
+    { TEMPLATE_TEXT, "-i ", 3, -1, 0, 0 },
+    { TEMPLATE_VAR, "vendor", 6, 3, 0, 0 },
+    { TEMPLATE_CLOSE, NULL, 0, -1, 0, 0 },
+    { TEMPLATE_TEXT, " ", 1, -1, 0, 0 },
+    { TEMPLATE_OPEN, NULL, 0, -1, 0, 0 },
+    { TEMPLATE_TEXT, "-I ", 3, -1, 0, 0 },
+    { TEMPLATE_VAR, "client", 6, 4, 0, 0 },
+    { TEMPLATE_CLOSE, NULL, 0, -1, 0, 0 },
+    { TEMPLATE_TEXT, "            ", 12, -1, 0, 0 },
+    { TEMPLATE_OPEN, NULL, 0, -1, 0, 0 },
+    { TEMPLATE_TEXT, "-l ", 3, -1, 0, 0 },
+    { TEMPLATE_VAR, "leasetime", 9, 2, 0, 0 },
+    { TEMPLATE_CLOSE, NULL, 0, -1, 0, 0 },
+    { TEMPLATE_TEXT, " ", 1, -1, 0, 0 },
+    { TEMPLATE_OPEN, NULL, 0, -1, 0, 0 },
+    { TEMPLATE_TEXT, "-m ", 3, -1, 0, 0 },
+    { TEMPLATE_VAR, "metric", 6, 1, 0, 0 },
+    { TEMPLATE_CLOSE, NULL, 0, -1, 0, 0 },
+    { TEMPLATE_TEXT, " ", 1, -1, 0, 0 },
+    { TEMPLATE_VAR, "iface", 5, -1, 0, 0 },
+    { TEMPLATE_END, NULL, 0, -1, 0, 0 },
+};
+static bool _dhcp_up_if_4(interface_defn *ifd) { return 1; }
+static const template_op _dhcp_up_4[] = {
+    { TEMPLATE_TEXT, "echo 'No DHCP client software found!' >&2; false", 48, -1, 0, 0 },
+    { TEMPLATE_END, NULL, 0, -1, 0, 0 },
+};
+static const command_op _dhcp_up_ops[] = {
+	{ COMMAND_LINK_SET, 0, NULL, false, _dhcp_up_0, "[[ip link set dev %iface% address %hwaddress%]]" },
+	{ COMMAND_SHELL, 0, _dhcp_up_if_1, false, _dhcp_up_1, "CLIENT=\"-i\"; [[[ \"%client%\" = no ] && CLIENT=\"\";]] dhclient -4 -v $CLIENT -pf /run/dhclient.%iface%.pid -lf /var/lib/dhcp/dhclient.%iface%.leases -I -df /var/lib/dhcp/dhclient6.%iface%.leases %iface% \
+	[[-e IF_METRIC=%metric%]]" },
+	{ COMMAND_SHELL, 0, _dhcp_up_if_2, true, _dhcp_up_2, "udhcpc -n -p /run/udhcpc.%iface%.pid -i %iface% [[-x hostname:%hostname%]]" },
+	{ COMMAND_SHELL, 0, _dhcp_up_if_3, true, _dhcp_up_3, "dhcpcd [[-h %hostname%]] [[-i %vendor%]] [[-I %client%]] \
+           [[-l %leasetime%]] [[-m %metric%]] %iface%" },
+	{ COMMAND_SHELL, 0, _dhcp_up_if_4, true, _dhcp_up_4, "echo 'No DHCP client software found!' >&2; false" },
+	{ COMMAND_END, 0, NULL, false, NULL, NULL }
+};
+static int _dhcp_up(interface_defn *ifd, execfn *exec) {
+	return execute_ops(_dhcp_up_ops, &_dhcp_slots, ifd, exec);
+}
+static bool _dhcp_down_if_0(interface_defn *ifd) { return execable("dhclient"); }
+static const template_op _dhcp_down_0[] = {
+    { TEMPLATE_TEXT, "CLIENT=\"-i\"; ", 13, -1, 0, 0 },
+    { TEMPLATE_OPEN, NULL, 0, -1, 0, 0 },
+    { TEMPLATE_TEXT, "[ \"", 3, -1, 0, 0 },
+    { TEMPLATE_VAR, "client", 6, 4, 0, 0 },
+    { TEMPLATE_TEXT, "\" = no ] && CLIENT=\"\";", 22, -1, 0, 0 },
+    { TEMPLATE_CLOSE, NULL, 0, -1, 0, 0 },
+    { TEMPLATE_TEXT, " dhclient -4 -v $CLIENT -r -pf /run/dhclient.", 45, -1, 0, 0 },
+    { TEMPLATE_VAR, "iface", 5, -1, 0, 0 },
+    { TEMPLATE_TEXT, ".pid -lf /var/lib/dhcp/dhclient.", 32, -1, 0, 0 },
+    { TEMPLATE_VAR, "iface", 5, -1, 0, 0 },
+    { TEMPLATE_TEXT, ".leases -I -df /var/lib/dhcp/dhclient6.", 39, -1, 0, 0 },
+    { TEMPLATE_VAR, "iface", 5, -1, 0, 0 },
+    { TEMPLATE_TEXT, ".leases ", 8, -1, 0, 0 },
+    { TEMPLATE_VAR, "iface", 5, -1, 0, 0 },
+    { TEMPLATE_END, NULL, 0, -1, 0, 0 },
+};
+static bool _dhcp_down_if_1(interface_defn *ifd) { return execable("udhcpc"); }
+static const template_op _dhcp_down_1[] = {
+    { TEMPLATE_TEXT, "if test -f /run/udhcpc.", 23, -1, 0, 0 },
+    { TEMPLATE_VAR, "iface", 5, -1, 0, 0 },
+    { TEMPLATE_TEXT, ".pid; then kill -USR2 $(cat /run/udhcpc.", 40, -1, 0, 0 },
+    { TEMPLATE_VAR, "iface", 5, -1, 0, 0 },
+    { TEMPLATE_TEXT, ".pid); kill -TERM $(cat /run/udhcpc.", 36, -1, 0, 0 },
+    { TEMPLATE_VAR, "iface", 5, -1, 0, 0 },
+    { TEMPLATE_TEXT, ".pid); fi", 9, -1, 0, 0 },
+    { TEMPLATE_END, NULL, 0, -1, 0, 0 },
+};
+static bool _dhcp_down_if_2(interface_defn *ifd) { return execable("dhcpcd"); }
+static const template_op _dhcp_down_2[] = {
+    { TEMPLATE_TEXT, "dhcpcd -k ", 10, -1, 0, 0 },
+    { TEMPLATE_VAR, "iface", 5, -1, 0, 0 },
+    { TEMPLATE_END, NULL, 0, -1, 0, 0 },
+};
+static bool _dhcp_down_if_3(interface_defn *ifd) { return 1; }
+static const template_op _dhcp_down_3[] = {
+    { TEMPLATE_TEXT, "echo 'No DHCP client software found!' >&2; false", 48, -1, 0, 0 },
+    { TEMPLATE_END, NULL, 0, -1, 0, 0 },
+};
+static bool _dhcp_down_if_4(interface_defn *ifd) { return iface_is_link(); }
+static const template_op _dhcp_down_4[] = {
+    { TEMPLATE_TEXT, "ip link set dev ", 16, -1, 0, 0 },
+    { TEMPLATE_VAR, "iface", 5, -1, 0, 0 },
+    { TEMPLATE_TEXT, " down", 5, -1, 0, 0 },
+    { TEMPLATE_END, NULL, 0, -1, 0, 0 },
+};
+static const command_op _dhcp_down_ops[] = {
+	{ COMMAND_SHELL, 0, _dhcp_down_if_0, false, _dhcp_down_0, "CLIENT=\"-i\"; [[[ \"%client%\" = no ] && CLIENT=\"\";]] dhclient -4 -v $CLIENT -r -pf /run/dhclient.%iface%.pid -lf /var/lib/dhcp/dhclient.%iface%.leases -I -df /var/lib/dhcp/dhclient6.%iface%.leases %iface%" },
+	{ COMMAND_SHELL, 0, _dhcp_down_if_1, true, _dhcp_down_1, "if test -f /run/udhcpc.%iface%.pid; then kill -USR2 $(cat /run/udhcpc.%iface%.pid); kill -TERM $(cat /run/udhcpc.%iface%.pid); fi" },
+	{ COMMAND_SHELL, 0, _dhcp_down_if_2, true, _dhcp_down_2, "dhcpcd -k %iface%" },
+	{ COMMAND_SHELL, 0, _dhcp_down_if_3, true, _dhcp_down_3, "echo 'No DHCP client software found!' >&2; false" },
+	{ COMMAND_LINK_SET, 0, _dhcp_down_if_4, false, _dhcp_down_4, "ip link set dev %iface% down" },
+	{ COMMAND_END, 0, NULL, false, NULL, NULL }
+};
+static int _dhcp_down(interface_defn *ifd, execfn *exec) {
+	return execute_ops(_dhcp_down_ops, &_dhcp_slots, ifd, exec);
+}
+static const command_op _dhcp_rename_ops[] = { { COMMAND_END, 0, NULL, false, NULL, NULL } };
+static int _dhcp_rename(interface_defn *ifd, execfn *exec) { return 0; }
+static option_default _bootp_default[] = {
+	{ NULL, NULL }
+};
+static conversion _bootp_conv[] = {
+	{ CONVERT_END, NULL, 0, -1, NULL, NULL, 0, NULL }
+};
+static const char *const _bootp_slot_names[] = {
+	"bootfile",
+	"server",
+	"hwaddr",
+	NULL
+};
+static const option_slots _bootp_slots = { 3, _bootp_slot_names };
+static const template_op _bootp_up_0[] = {
+    { TEMPLATE_TEXT, "bootpc ", 7, -1, 0, 0 },
+    { TEMPLATE_OPEN, NULL, 0, -1, 0, 0 },
+    { TEMPLATE_TEXT, "--bootfile ", 11, -1, 0, 0 },
+    { TEMPLATE_VAR, "bootfile", 8, 0, 0, 0 },
+    { TEMPLATE_CLOSE, NULL, 0, -1, 0, 0 },
+    { TEMPLATE_TEXT, " --dev ", 7, -1, 0, 0 },
+    { TEMPLATE_VAR, "iface", 5, -1, 0, 0 },
+    { TEMPLATE_TEXT, " ", 1, -1, 0, 0 },
+    { TEMPLATE_OPEN, NULL, 0, -1, 0, 0 },
+    { TEMPLATE_TEXT, "--server ", 9, -1, 0, 0 },
+    { TEMPLATE_VAR, "server", 6, 1, 0, 0 },
+    { TEMPLATE_CLOSE, NULL, 0, -1, 0, 0 },
+    { TEMPLATE_TEXT, "            ", 12, -1, 0, 0 },
+    { TEMPLATE_OPEN, NULL, 0, -1, 0, 0 },
+    { TEMPLATE_TEXT, "--hwaddr ", 9, -1, 0, 0 },
+    { TEMPLATE_VAR, "hwaddr", 6, 2, 0, 0 },
+    { TEMPLATE_CLOSE, NULL, 0, -1, 0, 0 },
+    { TEMPLATE_TEXT, " --returniffail --serverbcast", 29, -1, 0, 0 },
+    { TEMPLATE_END, NULL, 0, -1, 0, 0 },
+};
+static const command_op _bootp_up_ops[] = {
+	{ COMMAND_SHELL, 0, NULL, false, _bootp_up_0, "bootpc [[--bootfile %bootfile%]] --dev %iface% [[--server %server%]] \
+           [[--hwaddr %hwaddr%]] --returniffail --serverbcast" },
+	{ COMMAND_END, 0, NULL, false, NULL, NULL }
+};
+static int _bootp_up(interface_defn *ifd, execfn *exec) {
+	return execute_ops(_bootp_up_ops, &_bootp_slots, ifd, exec);
+}
+static bool _bootp_down_if_0(interface_defn *ifd) { return iface_is_link(); }
+static const template_op _bootp_down_0[] = {
+    { TEMPLATE_TEXT, "ip link set dev ", 16, -1, 0, 0 },
+    { TEMPLATE_VAR, "iface", 5, -1, 0, 0 },
+    { TEMPLATE_TEXT, " down", 5, -1, 0, 0 },
+    { TEMPLATE_END, NULL, 0, -1, 0, 0 },
+};
+static const command_op _bootp_down_ops[] = {
+	{ COMMAND_LINK_SET, 0, _bootp_down_if_0, false, _bootp_down_0, "ip link set dev %iface% down" },
+	{ COMMAND_END, 0, NULL, false, NULL, NULL }
+};
+static int _bootp_down(interface_defn *ifd, execfn *exec) {
+	return execute_ops(_bootp_down_ops, &_bootp_slots, ifd, exec);
+}
+static const command_op _bootp_rename_ops[] = { { COMMAND_END, 0, NULL, false, NULL, NULL } };
+static int _bootp_rename(interface_defn *ifd, execfn *exec) { return 0; }
+static option_default _tunnel_default[] = {
+	{ NULL, NULL }
+};
+static conversion _tunnel_conv[] = {
+	{ CONVERT_END, NULL, 0, -1, NULL, NULL, 0, NULL }
+};
+static const char *const _tunnel_slot_names[] = {
+	"address",
+	"mode",
+	"endpoint",
+	"dstaddr",
+	"local",
+	"metric",
+	"gateway",
+	"ttl",
+	"mtu",
+	NULL
+};
+static const option_slots _tunnel_slots = { 9, _tunnel_slot_names };
+static const template_op _tunnel_up_0[] = {
+    { TEMPLATE_TEXT, "ip tunnel add ", 14, -1, 0, 0 },
+    { TEMPLATE_VAR, "iface", 5, -1, 0, 0 },
+    { TEMPLATE_TEXT, " mode ", 6, -1, 0, 0 },
+    { TEMPLATE_VAR, "mode", 4, 1, 0, 0 },
+    { TEMPLATE_TEXT, " remote ", 8, -1, 0, 0 },
+    { TEMPLATE_VAR, "endpoint", 8, 2, 0, 0 },
+    { TEMPLATE_TEXT, " ", 1, -1, 0, 0 },
+    { TEMPLATE_OPEN, NULL, 0, -1, 0, 0 },
+    { TEMPLATE_TEXT, "local ", 6, -1, 0, 0 },
+    { TEMPLATE_VAR, "local", 5, 4, 0, 0 },
+    { TEMPLATE_CLOSE, NULL, 0, -1, 0, 0 },
+    { TEMPLATE_TEXT, "        ", 8, -1, 0, 0 },
+    { TEMPLATE_OPEN, NULL, 0, -1, 0, 0 },
+    { TEMPLATE_TEXT, "ttl ", 4, -1, 0, 0 },
+    { TEMPLATE_VAR, "ttl", 3, 7, 0, 0 },
+    { TEMPLATE_CLOSE, NULL, 0, -1, 0, 0 },
+    { TEMPLATE_END, NULL, 0, -1, 0, 0 },
+};
+static const template_op _tunnel_up_1[] = {
+    { TEMPLATE_TEXT, "ip link set ", 12, -1, 0, 0 },
+    { TEMPLATE_VAR, "iface", 5, -1, 0, 0 },
+    { TEMPLATE_TEXT, " up ", 4, -1, 0, 0 },
+    { TEMPLATE_OPEN, NULL, 0, -1, 0, 0 },
+    { TEMPLATE_TEXT, "mtu ", 4, -1, 0, 0 },
+    { TEMPLATE_VAR, "mtu", 3, 8, 0, 0 },
+    { TEMPLATE_CLOSE, NULL, 0, -1, 0, 0 },
+    { TEMPLATE_END, NULL, 0, -1, 0, 0 },
+};
+static const template_op _tunnel_up_2[] = {
+    { TEMPLATE_TEXT, "ip addr add ", 12, -1, 0, 0 },
+    { TEMPLATE_VAR, "address", 7, 0, 0, 0 },
+    { TEMPLATE_TEXT, "/", 1, -1, 0, 0 },
+    { TEMPLATE_VAR, "netmask", 7, -1, 0, 0 },
+    { TEMPLATE_TEXT, " dev ", 5, -1, 0, 0 },
+    { TEMPLATE_VAR, "iface", 5, -1, 0, 0 },
+    { TEMPLATE_TEXT, " ", 1, -1, 0, 0 },
+    { TEMPLATE_OPEN, NULL, 0, -1, 0, 0 },
+    { TEMPLATE_TEXT, "peer ", 5, -1, 0, 0 },
+    { TEMPLATE_VAR, "dstaddr", 7, 3, 0, 0 },
+    { TEMPLATE_CLOSE, NULL, 0, -1, 0, 0 },
+    { TEMPLATE_END, NULL, 0, -1, 0, 0 },
+};
+static const template_op _tunnel_up_3[] = {
+    { TEMPLATE_OPEN, NULL, 0, -1, 0, 0 },
+    { TEMPLATE_TEXT, " ip route add default via ", 26, -1, 0, 0 },
+    { TEMPLATE_VAR, "gateway", 7, 6, 0, 0 },
+    { TEMPLATE_TEXT, " ", 1, -1, 0, 0 },
+    { TEMPLATE_OPEN, NULL, 0, -1, 0, 0 },
+    { TEMPLATE_TEXT, "metric ", 7, -1, 0, 0 },
+    { TEMPLATE_VAR, "metric", 6, 5, 0, 0 },
+    { TEMPLATE_CLOSE, NULL, 0, -1, 0, 0 },
+    { TEMPLATE_TEXT, " dev ", 5, -1, 0, 0 },
+    { TEMPLATE_VAR, "iface", 5, -1, 0, 0 },
+    { TEMPLATE_TEXT, " onlink ", 8, -1, 0, 0 },
+    { TEMPLATE_CLOSE, NULL, 0, -1, 0, 0 },
+    { TEMPLATE_END, NULL, 0, -1, 0, 0 },
+};
+static const command_op _tunnel_up_ops[] = {
+	{ COMMAND_IP, 0, NULL, false, _tunnel_up_0, "ip tunnel add %iface% mode %mode% remote %endpoint% [[local %local%]] \
+       [[ttl %ttl%]]" },
+	{ COMMAND_LINK_SET, 0, NULL, false, _tunnel_up_1, "ip link set %iface% up [[mtu %mtu%]]" },
+	{ COMMAND_ADDR_ADD, 0, NULL, false, _tunnel_up_2, "ip addr add %address%/%netmask% dev %iface% [[peer %dstaddr%]]" },
+	{ COMMAND_ROUTE_ADD, 0, NULL, false, _tunnel_up_3, "[[ ip route add default via %gateway% [[metric %metric%]] dev %iface% onlink ]]" },
+	{ COMMAND_END, 0, NULL, false, NULL, NULL }
+};
+static int _tunnel_up(interface_defn *ifd, execfn *exec) {
+	return execute_ops(_tunnel_up_ops, &_tunnel_slots, ifd, exec);
+}
+static const template_op _tunnel_down_0[] = {
+    { TEMPLATE_TEXT, "ip tunnel del ", 14, -1, 0, 0 },
+    { TEMPLATE_VAR, "iface", 5, -1, 0, 0 },
+    { TEMPLATE_END, NULL, 0, -1, 0, 0 },
+};
+static const command_op _tunnel_down_ops[] = {
+	{ COMMAND_IP, 0, NULL, false, _tunnel_down_0, "ip tunnel del %iface%" },
+	{ COMMAND_END, 0, NULL, false, NULL, NULL }
+};
+static int _tunnel_down(interface_defn *ifd, execfn *exec) {
+	return execute_ops(_tunnel_down_ops, &_tunnel_slots, ifd, exec);
+}
+static const command_op _tunnel_rename_ops[] = { { COMMAND_END, 0, NULL, false, NULL, NULL } };
+static int _tunnel_rename(interface_defn *ifd, execfn *exec) { return 0; }
+static option_default _ppp_default[] = {
+	{ NULL, NULL }
+};
+static conversion _ppp_conv[] = {
+	{ CONVERT_END, NULL, 0, -1, NULL, NULL, 0, NULL }
+};
+static const char *const _ppp_slot_names[] = {
+	"provider",
+	"unit",
+	"options",
+	NULL
+};
+static const option_slots _ppp_slots = { 3, _ppp_slot_names };
+static const template_op _ppp_up_0[] = {
+    { TEMPLATE_TEXT, "pon ", 4, -1, 0, 0 },
+    { TEMPLATE_OPEN, NULL, 0, -1, 0, 0 },
+    { TEMPLATE_VAR, "provider", 8, 0, 0, 0 },
+    { TEMPLATE_CLOSE, NULL, 0, -1, 0, 0 },
+    { TEMPLATE_TEXT, " ", 1, -1, 0, 0 },
+    { TEMPLATE_OPEN, NULL, 0, -1, 0, 0 },
+    { TEMPLATE_TEXT, "unit ", 5, -1, 0, 0 },
+    { TEMPLATE_VAR, "unit", 4, 1, 0, 0 },
+    { TEMPLATE_CLOSE, NULL, 0, -1, 0, 0 },
+    { TEMPLATE_TEXT, " ", 1, -1, 0, 0 },
+    { TEMPLATE_OPEN, NULL, 0, -1, 0, 0 },
+    { TEMPLATE_VAR, "options", 7, 2, 0, 0 },
+    { TEMPLATE_CLOSE, NULL, 0, -1, 0, 0 },
+    { TEMPLATE_END, NULL, 0, -1, 0, 0 },
+};
+static const command_op _ppp_up_ops[] = {
+	{ COMMAND_SHELL, 0, NULL, false, _ppp_up_0, "pon [[%provider%]] [[unit %unit%]] [[%options%]]" },
+	{ COMMAND_END, 0, NULL, false, NULL, NULL }
+};
+static int _ppp_up(interface_defn *ifd, execfn *exec) {
+	return execute_ops(_ppp_up_ops, &_ppp_slots, ifd, exec);
+}
+static const template_op _ppp_down_0[] = {
+    { TEMPLATE_TEXT, "poff ", 5, -1, 0, 0 },
+    { TEMPLATE_OPEN, NULL, 0, -1, 0, 0 },
+    { TEMPLATE_VAR, "provider", 8, 0, 0, 0 },
+    { TEMPLATE_CLOSE, NULL, 0, -1, 0, 0 },
+    { TEMPLATE_END, NULL, 0, -1, 0, 0 },
+};
+static const command_op _ppp_down_ops[] = {
+	{ COMMAND_SHELL, 0, NULL, false, _ppp_down_0, "poff [[%provider%]]" },
+	{ COMMAND_END, 0, NULL, false, NULL, NULL }
+};
+static int _ppp_down(interface_defn *ifd, execfn *exec) {
+	return execute_ops(_ppp_down_ops, &_ppp_slots, ifd, exec);
+}
+static const command_op _ppp_rename_ops[] = { { COMMAND_END, 0, NULL, false, NULL, NULL } };
+static int _ppp_rename(interface_defn *ifd, execfn *exec) { return 0; }
+static option_default _wvdial_default[] = {
+	{ NULL, NULL }
+};
+static conversion _wvdial_conv[] = {
+	{ CONVERT_END, NULL, 0, -1, NULL, NULL, 0, NULL }
+};
+static const char *const _wvdial_slot_names[] = {
+	"provider",
+	NULL
+};
+static const option_slots _wvdial_slots = { 1, _wvdial_slot_names };
+static const template_op _wvdial_up_0[] = {
+    { TEMPLATE_TEXT, "start-stop-daemon --start -x /usr/bin/wvdial                       -p /run/wvdial.", 82, -1, 0, 0 },
+    { TEMPLATE_VAR, "iface", 5, -1, 0, 0 },
+    { TEMPLATE_TEXT, ".pid -b -m -- ", 14, -1, 0, 0 },
+    { TEMPLATE_OPEN, NULL, 0, -1, 0, 0 },
+    { TEMPLATE_TEXT, " ", 1, -1, 0, 0 },
+    { TEMPLATE_VAR, "provider", 8, 0, 0, 0 },
+    { TEMPLATE_TEXT, " ", 1, -1, 0, 0 },
+    { TEMPLATE_CLOSE, NULL, 0, -1, 0, 0 },
+    { TEMPLATE_END, NULL, 0, -1, 0, 0 },
+};
+static const command_op _wvdial_up_ops[] = {
+	{ COMMAND_SHELL, 0, NULL, false, _wvdial_up_0, "start-stop-daemon --start -x /usr/bin/wvdial \
+                      -p /run/wvdial.%iface%.pid -b -m -- [[ %provider% ]]" },
+	{ COMMAND_END, 0, NULL, false, NULL, NULL }
+};
+static int _wvdial_up(interface_defn *ifd, execfn *exec) {
+	return execute_ops(_wvdial_up_ops, &_wvdial_slots, ifd, exec);
+}
+static const template_op _wvdial_down_0[] = {
+    { TEMPLATE_TEXT, "start-stop-daemon --stop -x /usr/bin/wvdial                       -p /run/wvdial.", 81, -1, 0, 0 },
+    { TEMPLATE_VAR, "iface", 5, -1, 0, 0 },
+    { TEMPLATE_TEXT, ".pid -s 2", 9, -1, 0, 0 },
+    { TEMPLATE_END, NULL, 0, -1, 0, 0 },
+};
+static const command_op _wvdial_down_ops[] = {
+	{ COMMAND_SHELL, 0, NULL, false, _wvdial_down_0, "start-stop-daemon --stop -x /usr/bin/wvdial \
+                      -p /run/wvdial.%iface%.pid -s 2" },
+	{ COMMAND_END, 0, NULL, false, NULL, NULL }
+};
+static int _wvdial_down(interface_defn *ifd, execfn *exec) {
+	return execute_ops(_wvdial_down_ops, &_wvdial_slots, ifd, exec);
+}
+static const command_op _wvdial_rename_ops[] = { { COMMAND_END, 0, NULL, false, NULL, NULL } };
+static int _wvdial_rename(interface_defn *ifd, execfn *exec) { return 0; }
+static option_default _ipv4ll_default[] = {
+	{ NULL, NULL }
+};
+static conversion _ipv4ll_conv[] = {
+	{ CONVERT_END, NULL, 0, -1, NULL, NULL, 0, NULL }
+};
+static const char *const _ipv4ll_slot_names[] = {
+	NULL
+};
+static const option_slots _ipv4ll_slots = { 0, _ipv4ll_slot_names };
+static const template_op _ipv4ll_up_0[] = {
+    { TEMPLATE_TEXT, "avahi-autoipd -D ", 17, -1, 0, 0 },
+    { TEMPLATE_VAR, "iface", 5, -1, 0, 0 },
+    { TEMPLATE_END, NULL, 0, -1, 0, 0 },
+};
+static const command_op _ipv4ll_up_ops[] = {
+	{ COMMAND_SHELL, 0, NULL, false, _ipv4ll_up_0, "avahi-autoipd -D %iface%" },
+	{ COMMAND_END, 0, NULL, false, NULL, NULL }
+};
+static int _ipv4ll_up(interface_defn *ifd, execfn *exec) {
+	return execute_ops(_ipv4ll_up_ops, &_ipv4ll_slots, ifd, exec);
+}
+static const template_op _ipv4ll_down_0[] = {
+    { TEMPLATE_TEXT, "avahi-autoipd --kill ", 21, -1, 0, 0 },
+    { TEMPLATE_VAR, "iface", 5, -1, 0, 0 },
+    { TEMPLATE_END, NULL, 0, -1, 0, 0 },
+};
+static const command_op _ipv4ll_down_ops[] = {
+	{ COMMAND_SHELL, 0, NULL, false, _ipv4ll_down_0, "avahi-autoipd --kill %iface%" },
+	{ COMMAND_END, 0, NULL, false, NULL, NULL }
+};
+static int _ipv4ll_down(interface_defn *ifd, execfn *exec) {
+	return execute_ops(_ipv4ll_down_ops, &_ipv4ll_slots, ifd, exec);
+}
+static const command_op _ipv4ll_rename_ops[] = { { COMMAND_END, 0, NULL, false, NULL, NULL } };
+static int _ipv4ll_rename(interface_defn *ifd, execfn *exec) { return 0; }
+static method methods[] = {
+        {
+                "bootp",
+                _bootp_up, _bootp_down, _bootp_rename,
+                _bootp_conv, _bootp_default,
+                &_bootp_slots,
+                _bootp_up_ops, _bootp_down_ops, _bootp_rename_ops,
+        },
+        {
+                "dhcp",
+                _dhcp_up, _dhcp_down, _dhcp_rename,
+                _dhcp_conv, _dhcp_default,
+                &_dhcp_slots,
+                _dhcp_up_ops, _dhcp_down_ops, _dhcp_rename_ops,
+        },
+        {
+                "ipv4ll",
+                _ipv4ll_up, _ipv4ll_down, _ipv4ll_rename,
+                _ipv4ll_conv, _ipv4ll_default,
+                &_ipv4ll_slots,
+                _ipv4ll_up_ops, _ipv4ll_down_ops, _ipv4ll_rename_ops,
+        },
+        {
+                "loopback",
+                _loopback_up, _loopback_down, _loopback_rename,
+                _loopback_conv, _loopback_default,
+                &_loopback_slots,
+                _loopback_up_ops, _loopback_down_ops, _loopback_rename_ops,
+        },
+        {
+                "manual",
+                _manual_up, _manual_down, _manual_rename,
+                _manual_conv, _manual_default,
+                &_manual_slots,
+                _manual_up_ops, _manual_down_ops, _manual_rename_ops,
+        },
+        {
+                "ppp",
+                _ppp_up, _ppp_down, _ppp_rename,
+                _ppp_conv, _ppp_default,
+                &_ppp_slots,
+                _ppp_up_ops, _ppp_down_ops, _ppp_rename_ops,
+        },
+        {
+                "static",
+                _static_up, _static_down, _static_rename,
+                _static_conv, _static_default,
+                &_static_slots,
+                _static_up_ops, _static_down_ops, _static_rename_ops,
+        },
+        {
+                "tunnel",
+                _tunnel_up, _tunnel_down, _tunnel_rename,
+                _tunnel_conv, _tunnel_default,
+                &_tunnel_slots,
+                _tunnel_up_ops, _tunnel_down_ops, _tunnel_rename_ops,
+        },
+        {
+                "wvdial",
+                _wvdial_up, _wvdial_down, _wvdial_rename,
+                _wvdial_conv, _wvdial_default,
+                &_wvdial_slots,
+                _wvdial_up_ops, _wvdial_down_ops, _wvdial_rename_ops,
+        },
+};
+
+static const signed char method_slots[] = { -1, 1, -1, 4, -1, -1, 2, 3, -1, -1, 5, -1, 0, 8, 6, 7 };
+
+address_family addr_inet = {
+        "inet",
+        sizeof(methods)/sizeof(struct method),
+        methods,
+        { 31, 15, method_slots }
+};
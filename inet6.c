@@ -0,0 +1,1133 @@
+#include <stddef.h>
+#include "header.h"
+
+
+#include "archcommon.h"
+#include "archlinux.h"
+
+
+static option_default _auto_default[] = {
+	{ "accept_ra", "2" },
+	{ "request_prefix", "0" },
+	{ "ll-attempts", "60" },
+	{ "ll-interval", "0.1" },
+	{ NULL, NULL }
+};
+static conversion _auto_conv[] = {
+	{ CONVERT_END, NULL, 0, -1, NULL, NULL, 0, NULL }
+};
+static const char *const _auto_slot_names[] = {
+	"privext",
+	"accept_ra",
+	"dhcp",
+	"request_prefix",
+	"ll-attempts",
+	"ll-interval",
+	NULL
+};
+static const option_slots _auto_slots = { 6, _auto_slot_names };
+static const template_op _auto_up_0[] = {
+    { TEMPLATE_TEXT, "modprobe -q net-pf-10 > /dev/null 2>&1 || true # ignore failure.", 64, -1, 0, 0 },
+    { TEMPLATE_END, NULL, 0, -1, 0, 0 },
+};
+static const template_op _auto_up_1[] = {
+    { TEMPLATE_TEXT, "-", 1, -1, 0, 0 },
+    { TEMPLATE_OPEN, NULL, 0, -1, 0, 0 },
+    { TEMPLATE_TEXT, "sysctl -q -e -w net.ipv6.conf.", 30, -1, 0, 0 },
+    { TEMPLATE_VAR, "iface", 5, -1, '.', '/' },
+    { TEMPLATE_TEXT, ".use_tempaddr=", 14, -1, 0, 0 },
+    { TEMPLATE_VAR, "privext", 7, 0, 0, 0 },
+    { TEMPLATE_CLOSE, NULL, 0, -1, 0, 0 },
+    { TEMPLATE_END, NULL, 0, -1, 0, 0 },
+};
+static const template_op _auto_up_2[] = {
+    { TEMPLATE_TEXT, "-sysctl -q -e -w net.ipv6.conf.", 31, -1, 0, 0 },
+    { TEMPLATE_VAR, "iface", 5, -1, '.', '/' },
+    { TEMPLATE_TEXT, ".accept_ra=", 11, -1, 0, 0 },
+    { TEMPLATE_VAR, "accept_ra", 9, 1, 0, 0 },
+    { TEMPLATE_END, NULL, 0, -1, 0, 0 },
+};
+static const template_op _auto_up_3[] = {
+    { TEMPLATE_TEXT, "-sysctl -q -e -w net.ipv6.conf.", 31, -1, 0, 0 },
+    { TEMPLATE_VAR, "iface", 5, -1, '.', '/' },
+    { TEMPLATE_TEXT, ".autoconf=1", 11, -1, 0, 0 },
+    { TEMPLATE_END, NULL, 0, -1, 0, 0 },
+};
+static bool _auto_up_if_4(interface_defn *ifd) { return var_set_slot(&_auto_slots, 1, ifd) && !var_true_slot(&_auto_slots, 1, ifd); }
+static const template_op _auto_up_4[] = {
+    { TEMPLATE_TEXT, "ip addr flush dev ", 18, -1, 0, 0 },
+    { TEMPLATE_VAR, "iface", 5, -1, 0, 0 },
+    { TEMPLATE_TEXT, " mngtmpaddr", 11, -1, 0, 0 },
+    { TEMPLATE_END, NULL, 0, -1, 0, 0 },
+};
+static const template_op _auto_up_5[] = {
+    { TEMPLATE_TEXT, "ip link set dev ", 16, -1, 0, 0 },
+    { TEMPLATE_VAR, "iface", 5, -1, 0, 0 },
+    { TEMPLATE_TEXT, " up", 3, -1, 0, 0 },
+    { TEMPLATE_END, NULL, 0, -1, 0, 0 },
+};
+static bool _auto_up_if_6(interface_defn *ifd) { return var_true_slot(&_auto_slots, 2, ifd) && execable("/lib/ifupdown/wait-for-ll6.sh"); }
+static const template_op _auto_up_6[] = {
+    { TEMPLATE_TEXT, "/lib/ifupdown/wait-for-ll6.sh", 29, -1, 0, 0 },
+    { TEMPLATE_END, NULL, 0, -1, 0, 0 },
+};
+static bool _auto_up_if_7(interface_defn *ifd) { return var_true_slot(&_auto_slots, 2, ifd) && execable("dhclient") && var_true_slot(&_auto_slots, 3, ifd); }
+static const template_op _auto_up_7[] = {
+    { TEMPLATE_TEXT, "dhclient -6 -v -P -pf /run/dhclient6.", 37, -1, 0, 0 },
+    { TEMPLATE_VAR, "iface", 5, -1, 0, 0 },
+    { TEMPLATE_TEXT, ".pid -lf /var/lib/dhcp/dhclient6.", 33, -1, 0, 0 },
+    { TEMPLATE_VAR, "iface", 5, -1, 0, 0 },
+    { TEMPLATE_TEXT, ".leases -I -df /var/lib/dhcp/dhclient.", 38, -1, 0, 0 },
+    { TEMPLATE_VAR, "iface", 5, -1, 0, 0 },
+    { TEMPLATE_TEXT, ".leases ", 8, -1, 0, 0 },
+    { TEMPLATE_VAR, "iface", 5, -1, 0, 0 },
+    { TEMPLATE_END, NULL, 0, -1, 0, 0 },
+};
+static bool _auto_up_if_8(interface_defn *ifd) { return var_true_slot(&_auto_slots, 2, ifd) && execable("dhclient"); }
+static const template_op _auto_up_8[] = {
+    { TEMPLATE_TEXT, "dhclient -6 -1 -v -S -pf /run/dhclient6.", 40, -1, 0, 0 },
+    { TEMPLATE_VAR, "iface", 5, -1, 0, 0 },
+    { TEMPLATE_TEXT, ".pid -lf /var/lib/dhcp/dhclient6.", 33, -1, 0, 0 },
+    { TEMPLATE_VAR, "iface", 5, -1, 0, 0 },
+    { TEMPLATE_TEXT, ".leases -I -df /var/lib/dhcp/dhclient.", 38, -1, 0, 0 },
+    { TEMPLATE_VAR, "iface", 5, -1, 0, 0 },
+    { TEMPLATE_TEXT, ".leases ", 8, -1, 0, 0 },
+    { TEMPLATE_VAR, "iface", 5, -1, 0, 0 },
+    { TEMPLATE_END, NULL, 0, -1, 0, 0 },
+};
+static bool _auto_up_if_9(interface_defn *ifd) { return var_true_slot(&_auto_slots, 2, ifd); }
+static const template_op _auto_up_9[] = {
+    { TEMPLATE_TEXT, "echo 'No DHCPv6 client software found!' >&2; false", 50, -1, 0, 0 },
+    { TEMPLATE_END, NULL, 0, -1, 0, 0 },
+};
+static const command_op _auto_up_ops[] = {
+	{ COMMAND_SHELL, 0, NULL, false, _auto_up_0, "modprobe -q net-pf-10 > /dev/null 2>&1 || true # ignore failure." },
+	{ COMMAND_SYSCTL, 0, NULL, false, _auto_up_1, "-[[sysctl -q -e -w net.ipv6.conf.%iface/.//%.use_tempaddr=%privext%]]" },
+	{ COMMAND_SYSCTL, 0, NULL, false, _auto_up_2, "-sysctl -q -e -w net.ipv6.conf.%iface/.//%.accept_ra=%accept_ra%" },
+	{ COMMAND_SYSCTL, 0, NULL, false, _auto_up_3, "-sysctl -q -e -w net.ipv6.conf.%iface/.//%.autoconf=1" },
+	{ COMMAND_ADDR_FLUSH, 0, _auto_up_if_4, false, _auto_up_4, "ip addr flush dev %iface% mngtmpaddr" },
+	{ COMMAND_LINK_SET, 0, NULL, false, _auto_up_5, "ip link set dev %iface% up" },
+	{ COMMAND_SHELL, 0, _auto_up_if_6, false, _auto_up_6, "/lib/ifupdown/wait-for-ll6.sh" },
+	{ COMMAND_SHELL, 0, _auto_up_if_7, false, _auto_up_7, "dhclient -6 -v -P -pf /run/dhclient6.%iface%.pid -lf /var/lib/dhcp/dhclient6.%iface%.leases -I -df /var/lib/dhcp/dhclient.%iface%.leases %iface%" },
+	{ COMMAND_SHELL, 0, _auto_up_if_8, true, _auto_up_8, "dhclient -6 -1 -v -S -pf /run/dhclient6.%iface%.pid -lf /var/lib/dhcp/dhclient6.%iface%.leases -I -df /var/lib/dhcp/dhclient.%iface%.leases %iface%" },
+	{ COMMAND_SHELL, 0, _auto_up_if_9, true, _auto_up_9, "echo 'No DHCPv6 client software found!' >&2; false" },
+	{ COMMAND_END, 0, NULL, false, NULL, NULL }
+};
+static int _auto_up(interface_defn *ifd, execfn *exec) {
+	return execute_ops(_auto_up_ops, &_auto_slots, ifd, exec);
+}
+static bool _auto_down_if_0(interface_defn *ifd) { return var_true_slot(&_auto_slots, 2, ifd) && execable("dhclient"); }
+static const template_op _auto_down_0[] = {
+    { TEMPLATE_TEXT, "dhclient -6 -v -r -pf /run/dhclient6.", 37, -1, 0, 0 },
+    { TEMPLATE_VAR, "iface", 5, -1, 0, 0 },
+    { TEMPLATE_TEXT, ".pid -lf /var/lib/dhcp/dhclient6.", 33, -1, 0, 0 },
+    { TEMPLATE_VAR, "iface", 5, -1, 0, 0 },
+    { TEMPLATE_TEXT, ".leases -I -df /var/lib/dhcp/dhclient.", 38, -1, 0, 0 },
+    { TEMPLATE_VAR, "iface", 5, -1, 0, 0 },
+    { TEMPLATE_TEXT, ".leases ", 8, -1, 0, 0 },
+    { TEMPLATE_VAR, "iface", 5, -1, 0, 0 },
+    { TEMPLATE_END, NULL, 0, -1, 0, 0 },
+};
+static bool _auto_down_if_1(interface_defn *ifd) { return var_true_slot(&_auto_slots, 2, ifd); }
+static const template_op _auto_down_1[] = {
+    { TEMPLATE_TEXT, "echo 'No DHCPv6 client software found!' >&2; false", 50, -1, 0, 0 },
+    { TEMPLATE_END, NULL, 0, -1, 0, 0 },
+};
+static const template_op _auto_down_2[] = {
+    { TEMPLATE_TEXT, "ip -6 addr flush dev ", 21, -1, 0, 0 },
+    { TEMPLATE_VAR, "iface", 5, -1, 0, 0 },
+    { TEMPLATE_TEXT, " scope global", 13, -1, 0, 0 },
+    { TEMPLATE_END, NULL, 0, -1, 0, 0 },
+};
+static bool _auto_down_if_3(interface_defn *ifd) { return iface_is_link(); }
+static const template_op _auto_down_3[] = {
+    { TEMPLATE_TEXT, "ip link set dev ", 16, -1, 0, 0 },
+    { TEMPLATE_VAR, "iface", 5, -1, 0, 0 },
+    { TEMPLATE_TEXT, " down", 5, -1, 0, 0 },
+    { TEMPLATE_END, NULL, 0, -1, 0, 0 },
+};
+static const command_op _auto_down_ops[] = {
+	{ COMMAND_SHELL, 0, _auto_down_if_0, false, _auto_down_0, "dhclient -6 -v -r -pf /run/dhclient6.%iface%.pid -lf /var/lib/dhcp/dhclient6.%iface%.leases -I -df /var/lib/dhcp/dhclient.%iface%.leases %iface%" },
+	{ COMMAND_SHELL, 0, _auto_down_if_1, true, _auto_down_1, "echo 'No DHCPv6 client software found!' >&2; false" },
+	{ COMMAND_ADDR_FLUSH, 6, NULL, false, _auto_down_2, "ip -6 addr flush dev %iface% scope global" },
+	{ COMMAND_LINK_SET, 0, _auto_down_if_3, false, _auto_down_3, "ip link set dev %iface% down" },
+	{ COMMAND_END, 0, NULL, false, NULL, NULL }
+};
+static int _auto_down(interface_defn *ifd, execfn *exec) {
+	return execute_ops(_auto_down_ops, &_auto_slots, ifd, exec);
+}
+static const command_op _auto_rename_ops[] = { { COMMAND_END, 0, NULL, false, NULL, NULL } };
+static int _auto_rename(interface_defn *ifd, execfn *exec) { return 0; }
+static option_default _loopback_default[] = {
+	{ NULL, NULL }
+};
+static conversion _loopback_conv[] = {
+	{ CONVERT_END, NULL, 0, -1, NULL, NULL, 0, NULL }
+};
+static const char *const _loopback_slot_names[] = {
+	NULL
+};
+static const option_slots _loopback_slots = { 0, _loopback_slot_names };
+static bool _loopback_up_if_0(interface_defn *ifd) { return !iface_is_lo(); }
+static const template_op _loopback_up_0[] = {
+    { TEMPLATE_TEXT, "-ip link set dev ", 17, -1, 0, 0 },
+    { TEMPLATE_VAR, "iface", 5, -1, 0, 0 },
+    { TEMPLATE_TEXT, " up 2>/dev/null", 15, -1, 0, 0 },
+    { TEMPLATE_END, NULL, 0, -1, 0, 0 },
+};
+static bool _loopback_up_if_1(interface_defn *ifd) { return !iface_is_lo(); }
+static const template_op _loopback_up_1[] = {
+    { TEMPLATE_TEXT, "-ip addr add dev ", 17, -1, 0, 0 },
+    { TEMPLATE_VAR, "iface", 5, -1, 0, 0 },
+    { TEMPLATE_TEXT, " ::1 2>/dev/null", 16, -1, 0, 0 },
+    { TEMPLATE_END, NULL, 0, -1, 0, 0 },
+};
+static const command_op _loopback_up_ops[] = {
+	{ COMMAND_LINK_SET, 0, _loopback_up_if_0, false, _loopback_up_0, "-ip link set dev %iface% up 2>/dev/null" },
+	{ COMMAND_ADDR_ADD, 0, _loopback_up_if_1, false, _loopback_up_1, "-ip addr add dev %iface% ::1 2>/dev/null" },
+	{ COMMAND_END, 0, NULL, false, NULL, NULL }
+};
+static int _loopback_up(interface_defn *ifd, execfn *exec) {
+	return execute_ops(_loopback_up_ops, &_loopback_slots, ifd, exec);
+}
+static bool _loopback_down_if_0(interface_defn *ifd) { return !iface_is_lo(); }
+static const template_op _loopback_down_0[] = {
+    { TEMPLATE_TEXT, "-ip addr del dev ", 17, -1, 0, 0 },
+    { TEMPLATE_VAR, "iface", 5, -1, 0, 0 },
+    { TEMPLATE_TEXT, " ::1 2>/dev/null", 16, -1, 0, 0 },
+    { TEMPLATE_END, NULL, 0, -1, 0, 0 },
+};
+static bool _loopback_down_if_1(interface_defn *ifd) { return !iface_is_lo(); }
+static const template_op _loopback_down_1[] = {
+    { TEMPLATE_TEXT, "-ip link set dev ", 17, -1, 0, 0 },
+    { TEMPLATE_VAR, "iface", 5, -1, 0, 0 },
+    { TEMPLATE_TEXT, " down 2>/dev/null", 17, -1, 0, 0 },
+    { TEMPLATE_END, NULL, 0, -1, 0, 0 },
+};
+static const command_op _loopback_down_ops[] = {
+	{ COMMAND_ADDR_DEL, 0, _loopback_down_if_0, false, _loopback_down_0, "-ip addr del dev %iface% ::1 2>/dev/null" },
+	{ COMMAND_LINK_SET, 0, _loopback_down_if_1, false, _loopback_down_1, "-ip link set dev %iface% down 2>/dev/null" },
+	{ COMMAND_END, 0, NULL, false, NULL, NULL }
+};
+static int _loopback_down(interface_defn *ifd, execfn *exec) {
+	return execute_ops(_loopback_down_ops, &_loopback_slots, ifd, exec);
+}
+static const command_op _loopback_rename_ops[] = { { COMMAND_END, 0, NULL, false, NULL, NULL } };
+static int _loopback_rename(interface_defn *ifd, execfn *exec) { return 0; }
+static option_default _static_default[] = {
+	{ "autoconf", "0" },
+	{ "preferred-lifetime", "" },
+	{ "dad-attempts", "60" },
+	{ "dad-interval", "0.1" },
+	{ NULL, NULL }
+};
+static conversion _static_conv[] = {
+	{ CONVERT_OPTION, "hwaddress", 9, 5, NULL, cleanup_hwaddress, 0, NULL },
+	{ CONVERT_OPTION, "preferred-lifetime", 18, 11, NULL, set_preferred_lft, 0, NULL },
+	{ CONVERT_OPTION, "address", 7, 0, "netmask?", get_token, 3, (char * []){"/", "1", ""} },
+	{ CONVERT_OPTION, "address", 7, 0, NULL, get_token, 3, (char * []){"/", "0", ""} },
+	{ CONVERT_OPTION, "gateway", 7, 3, "accept_ra?", if_set, 1, (char * []){"0"} },
+	{ CONVERT_END, NULL, 0, -1, NULL, NULL, 0, NULL }
+};
+static const char *const _static_slot_names[] = {
+	"address",
+	"netmask",
+	"metric",
+	"gateway",
+	"media",
+	"hwaddress",
+	"mtu",
+	"accept_ra",
+	"autoconf",
+	"privext",
+	"scope",
+	"preferred-lifetime",
+	"dad-attempts",
+	"dad-interval",
+	"netmask?",
+	"accept_ra?",
+	NULL
+};
+static const option_slots _static_slots = { 16, _static_slot_names };
+static const template_op _static_up_0[] = {
+    { TEMPLATE_TEXT, "modprobe -q net-pf-10 > /dev/null 2>&1 || true # ignore failure.", 64, -1, 0, 0 },
+    { TEMPLATE_END, NULL, 0, -1, 0, 0 },
+};
+static const template_op _static_up_1[] = {
+    { TEMPLATE_TEXT, "-", 1, -1, 0, 0 },
+    { TEMPLATE_OPEN, NULL, 0, -1, 0, 0 },
+    { TEMPLATE_TEXT, "sysctl -q -e -w net.ipv6.conf.", 30, -1, 0, 0 },
+    { TEMPLATE_VAR, "iface", 5, -1, '.', '/' },
+    { TEMPLATE_TEXT, ".use_tempaddr=", 14, -1, 0, 0 },
+    { TEMPLATE_VAR, "privext", 7, 9, 0, 0 },
+    { TEMPLATE_CLOSE, NULL, 0, -1, 0, 0 },
+    { TEMPLATE_END, NULL, 0, -1, 0, 0 },
+};
+static const template_op _static_up_2[] = {
+    { TEMPLATE_TEXT, "-", 1, -1, 0, 0 },
+    { TEMPLATE_OPEN, NULL, 0, -1, 0, 0 },
+    { TEMPLATE_TEXT, "sysctl -q -e -w net.ipv6.conf.", 30, -1, 0, 0 },
+    { TEMPLATE_VAR, "iface", 5, -1, '.', '/' },
+    { TEMPLATE_TEXT, ".accept_ra=", 11, -1, 0, 0 },
+    { TEMPLATE_VAR, "accept_ra", 9, 7, 0, 0 },
+    { TEMPLATE_CLOSE, NULL, 0, -1, 0, 0 },
+    { TEMPLATE_END, NULL, 0, -1, 0, 0 },
+};
+static const template_op _static_up_3[] = {
+    { TEMPLATE_TEXT, "-", 1, -1, 0, 0 },
+    { TEMPLATE_OPEN, NULL, 0, -1, 0, 0 },
+    { TEMPLATE_TEXT, "sysctl -q -e -w net.ipv6.conf.", 30, -1, 0, 0 },
+    { TEMPLATE_VAR, "iface", 5, -1, '.', '/' },
+    { TEMPLATE_TEXT, ".autoconf=", 10, -1, 0, 0 },
+    { TEMPLATE_VAR, "autoconf", 8, 8, 0, 0 },
+    { TEMPLATE_CLOSE, NULL, 0, -1, 0, 0 },
+    { TEMPLATE_END, NULL, 0, -1, 0, 0 },
+};
+static const template_op _static_up_4[] = {
+    { TEMPLATE_TEXT, "-", 1, -1, 0, 0 },
+    { TEMPLATE_OPEN, NULL, 0, -1, 0, 0 },
+    { TEMPLATE_TEXT, "if [ \"$(cat /sys/class/net/", 27, -1, 0, 0 },
+    { TEMPLATE_VAR, "iface", 5, -1, 0, 0 },
+    { TEMPLATE_TEXT, "/mtu)\" -lt ", 11, -1, 0, 0 },
+    { TEMPLATE_VAR, "mtu", 3, 6, 0, 0 },
+    { TEMPLATE_TEXT, " ]; then ip link set dev ", 25, -1, 0, 0 },
+    { TEMPLATE_VAR, "iface", 5, -1, 0, 0 },
+    { TEMPLATE_TEXT, " mtu ", 5, -1, 0, 0 },
+    { TEMPLATE_VAR, "mtu", 3, 6, 0, 0 },
+    { TEMPLATE_TEXT, "; else sysctl -q -e -w net.ipv6.conf.", 37, -1, 0, 0 },
+    { TEMPLATE_VAR, "iface", 5, -1, '.', '/' },
+    { TEMPLATE_TEXT, ".mtu=", 5, -1, 0, 0 },
+    { TEMPLATE_VAR, "mtu", 3, 6, 0, 0 },
+    { TEMPLATE_TEXT, "; fi", 4, -1, 0, 0 },
+    { TEMPLATE_CLOSE, NULL, 0, -1, 0, 0 },
+    { TEMPLATE_END, NULL, 0, -1, 0, 0 },
+};
+static bool _static_up_if_5(interface_defn *ifd) { return var_set_slot(&_static_slots, 7, ifd) && !var_true_slot(&_static_slots, 7, ifd); }
+static const template_op _static_up_5[] = {
+    { TEMPLATE_TEXT, "ip addr flush dev ", 18, -1, 0, 0 },
+    { TEMPLATE_VAR, "iface", 5, -1, 0, 0 },
+    { TEMPLATE_TEXT, " mngtmpaddr", 11, -1, 0, 0 },
+    { TEMPLATE_END, NULL, 0, -1, 0, 0 },
+};
+static const template_op _static_up_6[] = {
+    { TEMPLATE_TEXT, "ip link set dev ", 16, -1, 0, 0 },
+    { TEMPLATE_VAR, "iface", 5, -1, 0, 0 },
+    { TEMPLATE_TEXT, " ", 1, -1, 0, 0 },
+    { TEMPLATE_OPEN, NULL, 0, -1, 0, 0 },
+    { TEMPLATE_TEXT, "address ", 8, -1, 0, 0 },
+    { TEMPLATE_VAR, "hwaddress", 9, 5, 0, 0 },
+    { TEMPLATE_CLOSE, NULL, 0, -1, 0, 0 },
+    { TEMPLATE_TEXT, " up", 3, -1, 0, 0 },
+    { TEMPLATE_END, NULL, 0, -1, 0, 0 },
+};
+static bool _static_up_if_7(interface_defn *ifd) { return !var_set_slot(&_static_slots, 12, ifd) || var_true_slot(&_static_slots, 12, ifd); }
+static const template_op _static_up_7[] = {
+    { TEMPLATE_TEXT, "ip -6 addr add ", 15, -1, 0, 0 },
+    { TEMPLATE_VAR, "address", 7, 0, 0, 0 },
+    { TEMPLATE_OPEN, NULL, 0, -1, 0, 0 },
+    { TEMPLATE_TEXT, "/", 1, -1, 0, 0 },
+    { TEMPLATE_VAR, "netmask", 7, 1, 0, 0 },
+    { TEMPLATE_CLOSE, NULL, 0, -1, 0, 0 },
+    { TEMPLATE_TEXT, " ", 1, -1, 0, 0 },
+    { TEMPLATE_OPEN, NULL, 0, -1, 0, 0 },
+    { TEMPLATE_TEXT, "scope ", 6, -1, 0, 0 },
+    { TEMPLATE_VAR, "scope", 5, 10, 0, 0 },
+    { TEMPLATE_CLOSE, NULL, 0, -1, 0, 0 },
+    { TEMPLATE_TEXT, " dev ", 5, -1, 0, 0 },
+    { TEMPLATE_VAR, "iface", 5, -1, 0, 0 },
+    { TEMPLATE_TEXT, " ", 1, -1, 0, 0 },
+    { TEMPLATE_OPEN, NULL, 0, -1, 0, 0 },
+    { TEMPLATE_TEXT, "preferred_lft ", 14, -1, 0, 0 },
+    { TEMPLATE_VAR, "preferred-lifetime", 18, 11, 0, 0 },
+    { TEMPLATE_CLOSE, NULL, 0, -1, 0, 0 },
+    { TEMPLATE_END, NULL, 0, -1, 0, 0 },
+};
+static bool _static_up_if_8(interface_defn *ifd) { return var_set_slot(&_static_slots, 12, ifd) && !var_true_slot(&_static_slots, 12, ifd); }
+static const template_op _static_up_8[] = {
+    { TEMPLATE_TEXT, "ip -6 addr add ", 15, -1, 0, 0 },
+    { TEMPLATE_VAR, "address", 7, 0, 0, 0 },
+    { TEMPLATE_OPEN, NULL, 0, -1, 0, 0 },
+    { TEMPLATE_TEXT, "/", 1, -1, 0, 0 },
+    { TEMPLATE_VAR, "netmask", 7, 1, 0, 0 },
+    { TEMPLATE_CLOSE, NULL, 0, -1, 0, 0 },
+    { TEMPLATE_TEXT, " ", 1, -1, 0, 0 },
+    { TEMPLATE_OPEN, NULL, 0, -1, 0, 0 },
+    { TEMPLATE_TEXT, "scope ", 6, -1, 0, 0 },
+    { TEMPLATE_VAR, "scope", 5, 10, 0, 0 },
+    { TEMPLATE_CLOSE, NULL, 0, -1, 0, 0 },
+    { TEMPLATE_TEXT, " dev ", 5, -1, 0, 0 },
+    { TEMPLATE_VAR, "iface", 5, -1, 0, 0 },
+    { TEMPLATE_TEXT, " ", 1, -1, 0, 0 },
+    { TEMPLATE_OPEN, NULL, 0, -1, 0, 0 },
+    { TEMPLATE_TEXT, "preferred_lft ", 14, -1, 0, 0 },
+    { TEMPLATE_VAR, "preferred-lifetime", 18, 11, 0, 0 },
+    { TEMPLATE_CLOSE, NULL, 0, -1, 0, 0 },
+    { TEMPLATE_TEXT, " nodad", 6, -1, 0, 0 },
+    { TEMPLATE_END, NULL, 0, -1, 0, 0 },
+};
+static const template_op _static_up_9[] = {
+    { TEMPLATE_OPEN, NULL, 0, -1, 0, 0 },
+    { TEMPLATE_TEXT, " ip -6 route replace default via ", 33, -1, 0, 0 },
+    { TEMPLATE_VAR, "gateway", 7, 3, 0, 0 },
+    { TEMPLATE_TEXT, " ", 1, -1, 0, 0 },
+    { TEMPLATE_OPEN, NULL, 0, -1, 0, 0 },
+    { TEMPLATE_TEXT, "metric ", 7, -1, 0, 0 },
+    { TEMPLATE_VAR, "metric", 6, 2, 0, 0 },
+    { TEMPLATE_CLOSE, NULL, 0, -1, 0, 0 },
+    { TEMPLATE_TEXT, " dev ", 5, -1, 0, 0 },
+    { TEMPLATE_VAR, "iface", 5, -1, 0, 0 },
+    { TEMPLATE_TEXT, " onlink ", 8, -1, 0, 0 },
+    { TEMPLATE_CLOSE, NULL, 0, -1, 0, 0 },
+    { TEMPLATE_END, NULL, 0, -1, 0, 0 },
+};
+static bool _static_up_if_10(interface_defn *ifd) { return !no_act_commands && execable("/lib/ifupdown/settle-dad.sh") && (var_true_slot(&_static_slots, 12, ifd)); }
+static const template_op _static_up_10[] = {
+    { TEMPLATE_TEXT, "/lib/ifupdown/settle-dad.sh", 27, -1, 0, 0 },
+    { TEMPLATE_END, NULL, 0, -1, 0, 0 },
+};
+static const command_op _static_up_ops[] = {
+	{ COMMAND_SHELL, 0, NULL, false, _static_up_0, "modprobe -q net-pf-10 > /dev/null 2>&1 || true # ignore failure." },
+	{ COMMAND_SYSCTL, 0, NULL, false, _static_up_1, "-[[sysctl -q -e -w net.ipv6.conf.%iface/.//%.use_tempaddr=%privext%]]" },
+	{ COMMAND_SYSCTL, 0, NULL, false, _static_up_2, "-[[sysctl -q -e -w net.ipv6.conf.%iface/.//%.accept_ra=%accept_ra%]]" },
+	{ COMMAND_SYSCTL, 0, NULL, false, _static_up_3, "-[[sysctl -q -e -w net.ipv6.conf.%iface/.//%.autoconf=%autoconf%]]" },
+	{ COMMAND_SHELL, 0, NULL, false, _static_up_4, "-[[if [ \"$(cat /sys/class/net/%iface%/mtu)\" -lt %mtu% ]; then ip link set dev %iface% mtu %mtu%; else sysctl -q -e -w net.ipv6.conf.%iface/.//%.mtu=%mtu%; fi]]" },
+	{ COMMAND_ADDR_FLUSH, 0, _static_up_if_5, false, _static_up_5, "ip addr flush dev %iface% mngtmpaddr" },
+	{ COMMAND_LINK_SET, 0, NULL, false, _static_up_6, "ip link set dev %iface% [[address %hwaddress%]] up" },
+	{ COMMAND_ADDR_ADD, 6, _static_up_if_7, false, _static_up_7, "ip -6 addr add %address%[[/%netmask%]] [[scope %scope%]] dev %iface% [[preferred_lft %preferred-lifetime%]]" },
+	{ COMMAND_ADDR_ADD, 6, _static_up_if_8, false, _static_up_8, "ip -6 addr add %address%[[/%netmask%]] [[scope %scope%]] dev %iface% [[preferred_lft %preferred-lifetime%]] nodad" },
+	{ COMMAND_ROUTE_REPLACE, 6, NULL, false, _static_up_9, "[[ ip -6 route replace default via %gateway% [[metric %metric%]] dev %iface% onlink ]]" },
+	{ COMMAND_SHELL, 0, _static_up_if_10, false, _static_up_10, "/lib/ifupdown/settle-dad.sh" },
+	{ COMMAND_END, 0, NULL, false, NULL, NULL }
+};
+static int _static_up(interface_defn *ifd, execfn *exec) {
+	return execute_ops(_static_up_ops, &_static_slots, ifd, exec);
+}
+static const template_op _static_down_0[] = {
+    { TEMPLATE_OPEN, NULL, 0, -1, 0, 0 },
+    { TEMPLATE_TEXT, " ip -6 route del default via ", 29, -1, 0, 0 },
+    { TEMPLATE_VAR, "gateway", 7, 3, 0, 0 },
+    { TEMPLATE_TEXT, " ", 1, -1, 0, 0 },
+    { TEMPLATE_OPEN, NULL, 0, -1, 0, 0 },
+    { TEMPLATE_TEXT, "metric ", 7, -1, 0, 0 },
+    { TEMPLATE_VAR, "metric", 6, 2, 0, 0 },
+    { TEMPLATE_CLOSE, NULL, 0, -1, 0, 0 },
+    { TEMPLATE_TEXT, " dev ", 5, -1, 0, 0 },
+    { TEMPLATE_VAR, "iface", 5, -1, 0, 0 },
+    { TEMPLATE_TEXT, " ", 1, -1, 0, 0 },
+    { TEMPLATE_CLOSE, NULL, 0, -1, 0, 0 },
+    { TEMPLATE_END, NULL, 0, -1, 0, 0 },
+};
+static const template_op _static_down_1[] = {
+    { TEMPLATE_TEXT, "ip -6 addr del ", 15, -1, 0, 0 },
+    { TEMPLATE_VAR, "address", 7, 0, 0, 0 },
+    { TEMPLATE_OPEN, NULL, 0, -1, 0, 0 },
+    { TEMPLATE_TEXT, "/", 1, -1, 0, 0 },
+    { TEMPLATE_VAR, "netmask", 7, 1, 0, 0 },
+    { TEMPLATE_CLOSE, NULL, 0, -1, 0, 0 },
+    { TEMPLATE_TEXT, " ", 1, -1, 0, 0 },
+    { TEMPLATE_OPEN, NULL, 0, -1, 0, 0 },
+    { TEMPLATE_TEXT, "scope ", 6, -1, 0, 0 },
+    { TEMPLATE_VAR, "scope", 5, 10, 0, 0 },
+    { TEMPLATE_CLOSE, NULL, 0, -1, 0, 0 },
+    { TEMPLATE_TEXT, " dev ", 5, -1, 0, 0 },
+    { TEMPLATE_VAR, "iface", 5, -1, 0, 0 },
+    { TEMPLATE_END, NULL, 0, -1, 0, 0 },
+};
+static bool _static_down_if_2(interface_defn *ifd) { return iface_is_link(); }
+static const template_op _static_down_2[] = {
+    { TEMPLATE_TEXT, "ip -6 addr flush dev ", 21, -1, 0, 0 },
+    { TEMPLATE_VAR, "iface", 5, -1, 0, 0 },
+    { TEMPLATE_END, NULL, 0, -1, 0, 0 },
+};
+static bool _static_down_if_3(interface_defn *ifd) { return iface_is_link(); }
+static const template_op _static_down_3[] = {
+    { TEMPLATE_TEXT, "ip link set dev ", 16, -1, 0, 0 },
+    { TEMPLATE_VAR, "iface", 5, -1, 0, 0 },
+    { TEMPLATE_TEXT, " down", 5, -1, 0, 0 },
+    { TEMPLATE_END, NULL, 0, -1, 0, 0 },
+};
+static const command_op _static_down_ops[] = {
+	{ COMMAND_ROUTE_DEL, 6, NULL, false, _static_down_0, "[[ ip -6 route del default via %gateway% [[metric %metric%]] dev %iface% ]]" },
+	{ COMMAND_ADDR_DEL, 6, NULL, false, _static_down_1, "ip -6 addr del %address%[[/%netmask%]] [[scope %scope%]] dev %iface%" },
+	{ COMMAND_ADDR_FLUSH, 6, _static_down_if_2, false, _static_down_2, "ip -6 addr flush dev %iface%" },
+	{ COMMAND_LINK_SET, 0, _static_down_if_3, false, _static_down_3, "ip link set dev %iface% down" },
+	{ COMMAND_END, 0, NULL, false, NULL, NULL }
+};
+static int _static_down(interface_defn *ifd, execfn *exec) {
+	return execute_ops(_static_down_ops, &_static_slots, ifd, exec);
+}
+static const command_op _static_rename_ops[] = { { COMMAND_END, 0, NULL, false, NULL, NULL } };
+static int _static_rename(interface_defn *ifd, execfn *exec) { return 0; }
+static option_default _manual_default[] = {
+	{ NULL, NULL }
+};
+static conversion _manual_conv[] = {
+	{ CONVERT_OPTION, "hwaddress", 9, 0, NULL, cleanup_hwaddress, 0, NULL },
+	{ CONVERT_END, NULL, 0, -1, NULL, NULL, 0, NULL }
+};
+static const char *const _manual_slot_names[] = {
+	"hwaddress",
+	"mtu",
+	NULL
+};
+static const option_slots _manual_slots = { 2, _manual_slot_names };
+static const template_op _manual_up_0[] = {
+    { TEMPLATE_TEXT, "-", 1, -1, 0, 0 },
+    { TEMPLATE_OPEN, NULL, 0, -1, 0, 0 },
+    { TEMPLATE_TEXT, "if [ \"$(cat /sys/class/net/", 27, -1, 0, 0 },
+    { TEMPLATE_VAR, "iface", 5, -1, 0, 0 },
+    { TEMPLATE_TEXT, "/mtu)\" -lt ", 11, -1, 0, 0 },
+    { TEMPLATE_VAR, "mtu", 3, 1, 0, 0 },
+    { TEMPLATE_TEXT, " ]; then ip link set dev ", 25, -1, 0, 0 },
+    { TEMPLATE_VAR, "iface", 5, -1, 0, 0 },
+    { TEMPLATE_TEXT, " mtu ", 5, -1, 0, 0 },
+    { TEMPLATE_VAR, "mtu", 3, 1, 0, 0 },
+    { TEMPLATE_TEXT, "; else sysctl -q -e -w net.ipv6.conf.", 37, -1, 0, 0 },
+    { TEMPLATE_VAR, "iface", 5, -1, '.', '/' },
+    { TEMPLATE_TEXT, ".mtu=", 5, -1, 0, 0 },
+    { TEMPLATE_VAR, "mtu", 3, 1, 0, 0 },
+    { TEMPLATE_TEXT, "; fi", 4, -1, 0, 0 },
+    { TEMPLATE_CLOSE, NULL, 0, -1, 0, 0 },
+    { TEMPLATE_END, NULL, 0, -1, 0, 0 },
+};
+static const template_op _manual_up_1[] = {
+    { TEMPLATE_OPEN, NULL, 0, -1, 0, 0 },
+    { TEMPLATE_TEXT, "ip link set dev ", 16, -1, 0, 0 },
+    { TEMPLATE_VAR, "iface", 5, -1, 0, 0 },
+    { TEMPLATE_TEXT, " address ", 9, -1, 0, 0 },
+    { TEMPLATE_VAR, "hwaddress", 9, 0, 0, 0 },
+    { TEMPLATE_CLOSE, NULL, 0, -1, 0, 0 },
+    { TEMPLATE_END, NULL, 0, -1, 0, 0 },
+};
+static const template_op _manual_up_2[] = {
+    { TEMPLATE_TEXT, "ip link set dev ", 16, -1, 0, 0 },
+    { TEMPLATE_VAR, "iface", 5, -1, 0, 0 },
+    { TEMPLATE_TEXT, " up 2>/dev/null || true", 23, -1, 0, 0 },
+    { TEMPLATE_END, NULL, 0, -1, 0, 0 },
+};
+static const command_op _manual_up_ops[] = {
+	{ COMMAND_SHELL, 0, NULL, false, _manual_up_0, "-[[if [ \"$(cat /sys/class/net/%iface%/mtu)\" -lt %mtu% ]; then ip link set dev %iface% mtu %mtu%; else sysctl -q -e -w net.ipv6.conf.%iface/.//%.mtu=%mtu%; fi]]" },
+	{ COMMAND_LINK_SET, 0, NULL, false, _manual_up_1, "[[ip link set dev %iface% address %hwaddress%]]" },
+	{ COMMAND_LINK_SET, 0, NULL, false, _manual_up_2, "ip link set dev %iface% up 2>/dev/null || true" },
+	{ COMMAND_END, 0, NULL, false, NULL, NULL }
+};
+static int _manual_up(interface_defn *ifd, execfn *exec) {
+	return execute_ops(_manual_up_ops, &_manual_slots, ifd, exec);
+}
+static bool _manual_down_if_0(interface_defn *ifd) { return iface_is_link(); }
+static const template_op _manual_down_0[] = {
+    { TEMPLATE_TEXT, "ip -6 addr flush dev ", 21, -1, 0, 0 },
+    { TEMPLATE_VAR, "iface", 5, -1, 0, 0 },
+    { TEMPLATE_TEXT, " 2>/dev/null || true", 20, -1, 0, 0 },
+    { TEMPLATE_END, NULL, 0, -1, 0, 0 },
+};
+static bool _manual_down_if_1(interface_defn *ifd) { return iface_is_link() || !do_all; }
+static const template_op _manual_down_1[] = {
+    { TEMPLATE_TEXT, "ip link set dev ", 16, -1, 0, 0 },
+    { TEMPLATE_VAR, "iface", 5, -1, 0, 0 },
+    { TEMPLATE_TEXT, " down 2>/dev/null || true", 25, -1, 0, 0 },
+    { TEMPLATE_END, NULL, 0, -1, 0, 0 },
+};
+static const command_op _manual_down_ops[] = {
+	{ COMMAND_ADDR_FLUSH, 6, _manual_down_if_0, false, _manual_down_0, "ip -6 addr flush dev %iface% 2>/dev/null || true" },
+	{ COMMAND_LINK_SET, 0, _manual_down_if_1, false, _manual_down_1, "ip link set dev %iface% down 2>/dev/null || true" },
+	{ COMMAND_END, 0, NULL, false, NULL, NULL }
+};
+static int _manual_down(interface_defn *ifd, execfn *exec) {
+	return execute_ops(_manual_down_ops, &_manual_slots, ifd, exec);
+}
+static const command_op _manual_rename_ops[] = { { COMMAND_END, 0, NULL, false, NULL, NULL } };
+static int _manual_rename(interface_defn *ifd, execfn *exec) { return 0; }
+static option_default _dhcp_default[] = {
+	{ "accept_ra", "1" },
+	{ "request_prefix", "0" },
+	{ "ll-attempts", "60" },
+	{ "ll-interval", "0.1" },
+	{ NULL, NULL }
+};
+static conversion _dhcp_conv[] = {
+	{ CONVERT_OPTION, "hwaddress", 9, 0, NULL, cleanup_hwaddress, 0, NULL },
+	{ CONVERT_END, NULL, 0, -1, NULL, NULL, 0, NULL }
+};
+static const char *const _dhcp_slot_names[] = {
+	"hwaddress",
+	"accept_ra",
+	"autoconf",
+	"request_prefix",
+	"ll-attempts",
+	"ll-interval",
+	NULL
+};
+static const option_slots _dhcp_slots = { 6, _dhcp_slot_names };
+static const template_op _dhcp_up_0[] = {
+    { TEMPLATE_TEXT, "modprobe -q net-pf-10 > /dev/null 2>&1 || true # ignore failure.", 64, -1, 0, 0 },
+    { TEMPLATE_END, NULL, 0, -1, 0, 0 },
+};
+static const template_op _dhcp_up_1[] = {
+    { TEMPLATE_TEXT, "-", 1, -1, 0, 0 },
+    { TEMPLATE_OPEN, NULL, 0, -1, 0, 0 },
+    { TEMPLATE_TEXT, "sysctl -q -e -w net.ipv6.conf.", 30, -1, 0, 0 },
+    { TEMPLATE_VAR, "iface", 5, -1, '.', '/' },
+    { TEMPLATE_TEXT, ".accept_ra=", 11, -1, 0, 0 },
+    { TEMPLATE_VAR, "accept_ra", 9, 1, 0, 0 },
+    { TEMPLATE_CLOSE, NULL, 0, -1, 0, 0 },
+    { TEMPLATE_END, NULL, 0, -1, 0, 0 },
+};
+static const template_op _dhcp_up_2[] = {
+    { TEMPLATE_TEXT, "-", 1, -1, 0, 0 },
+    { TEMPLATE_OPEN, NULL, 0, -1, 0, 0 },
+    { TEMPLATE_TEXT, "sysctl -q -e -w net.ipv6.conf.", 30, -1, 0, 0 },
+    { TEMPLATE_VAR, "iface", 5, -1, '.', '/' },
+    { TEMPLATE_TEXT, ".autoconf=", 10, -1, 0, 0 },
+    { TEMPLATE_VAR, "autoconf", 8, 2, 0, 0 },
+    { TEMPLATE_CLOSE, NULL, 0, -1, 0, 0 },
+    { TEMPLATE_END, NULL, 0, -1, 0, 0 },
+};
+static bool _dhcp_up_if_3(interface_defn *ifd) { return var_set_slot(&_dhcp_slots, 1, ifd) && !var_true_slot(&_dhcp_slots, 1, ifd); }
+static const template_op _dhcp_up_3[] = {
+    { TEMPLATE_TEXT, "ip addr flush dev ", 18, -1, 0, 0 },
+    { TEMPLATE_VAR, "iface", 5, -1, 0, 0 },
+    { TEMPLATE_TEXT, " mngtmpaddr", 11, -1, 0, 0 },
+    { TEMPLATE_END, NULL, 0, -1, 0, 0 },
+};
+static const template_op _dhcp_up_4[] = {
+    { TEMPLATE_TEXT, "ip link set dev ", 16, -1, 0, 0 },
+    { TEMPLATE_VAR, "iface", 5, -1, 0, 0 },
+    { TEMPLATE_TEXT, " ", 1, -1, 0, 0 },
+    { TEMPLATE_OPEN, NULL, 0, -1, 0, 0 },
+    { TEMPLATE_TEXT, "address ", 8, -1, 0, 0 },
+    { TEMPLATE_VAR, "hwaddress", 9, 0, 0, 0 },
+    { TEMPLATE_CLOSE, NULL, 0, -1, 0, 0 },
+    { TEMPLATE_TEXT, " up", 3, -1, 0, 0 },
+    { TEMPLATE_END, NULL, 0, -1, 0, 0 },
+};
+static bool _dhcp_up_if_5(interface_defn *ifd) { return execable("/lib/ifupdown/wait-for-ll6.sh"); }
+static const template_op _dhcp_up_5[] = {
+    { TEMPLATE_TEXT, "/lib/ifupdown/wait-for-ll6.sh", 29, -1, 0, 0 },
+    { TEMPLATE_END, NULL, 0, -1, 0, 0 },
+};
+static bool _dhcp_up_if_6(interface_defn *ifd) { return execable("dhclient") && var_true_slot(&_dhcp_slots, 3, ifd); }
+static const template_op _dhcp_up_6[] = {
+    { TEMPLATE_TEXT, "dhclient -6 -v -pf /run/dhclient6.", 34, -1, 0, 0 },
+    { TEMPLATE_VAR, "iface", 5, -1, 0, 0 },
+    { TEMPLATE_TEXT, ".pid -lf /var/lib/dhcp/dhclient6.", 33, -1, 0, 0 },
+    { TEMPLATE_VAR, "iface", 5, -1, 0, 0 },
+    { TEMPLATE_TEXT, ".leases -I -P -N -df /var/lib/dhcp/dhclient.", 44, -1, 0, 0 },
+    { TEMPLATE_VAR, "iface", 5, -1, 0, 0 },
+    { TEMPLATE_TEXT, ".leases ", 8, -1, 0, 0 },
+    { TEMPLATE_VAR, "iface", 5, -1, 0, 0 },
+    { TEMPLATE_END, NULL, 0, -1, 0, 0 },
+};
+static bool _dhcp_up_if_7(interface_defn *ifd) { return execable("dhclient"); }
+static const template_op _dhcp_up_7[] = {
+    { TEMPLATE_TEXT, "dhclient -6 -v -pf /run/dhclient6.", 34, -1, 0, 0 },
+    { TEMPLATE_VAR, "iface", 5, -1, 0, 0 },
+    { TEMPLATE_TEXT, ".pid -lf /var/lib/dhcp/dhclient6.", 33, -1, 0, 0 },
+    { TEMPLATE_VAR, "iface", 5, -1, 0, 0 },
+    { TEMPLATE_TEXT, ".leases -I -df /var/lib/dhcp/dhclient.", 38, -1, 0, 0 },
+    { TEMPLATE_VAR, "iface", 5, -1, 0, 0 },
+    { TEMPLATE_TEXT, ".leases ", 8, -1, 0, 0 },
+    { TEMPLATE_VAR, "iface", 5, -1, 0, 0 },
+    { TEMPLATE_END, NULL, 0, -1, 0, 0 },
+};
+static bool _dhcp_up_if_8(interface_defn *ifd) { return 1; }
+static const template_op _dhcp_up_8[] = {
+    { TEMPLATE_TEXT, "echo 'No DHCPv6 client software found!' >&2; false", 50, -1, 0, 0 },
+    { TEMPLATE_END, NULL, 0, -1, 0, 0 },
+};
+static const command_op _dhcp_up_ops[] = {
+	{ COMMAND_SHELL, 0, NULL, false, _dhcp_up_0, "modprobe -q net-pf-10 > /dev/null 2>&1 || true # ignore failure." },
+	{ COMMAND_SYSCTL, 0, NULL, false, _dhcp_up_1, "-[[sysctl -q -e -w net.ipv6.conf.%iface/.//%.accept_ra=%accept_ra%]]" },
+	{ COMMAND_SYSCTL, 0, NULL, false, _dhcp_up_2, "-[[sysctl -q -e -w net.ipv6.conf.%iface/.//%.autoconf=%autoconf%]]" },
+	{ COMMAND_ADDR_FLUSH, 0, _dhcp_up_if_3, false, _dhcp_up_3, "ip addr flush dev %iface% mngtmpaddr" },
+	{ COMMAND_LINK_SET, 0, NULL, false, _dhcp_up_4, "ip link set dev %iface% [[address %hwaddress%]] up" },
+	{ COMMAND_SHELL, 0, _dhcp_up_if_5, false, _dhcp_up_5, "/lib/ifupdown/wait-for-ll6.sh" },
+	{ COMMAND_SHELL, 0, _dhcp_up_if_6, false, _dhcp_up_6, "dhclient -6 -v -pf /run/dhclient6.%iface%.pid -lf /var/lib/dhcp/dhclient6.%iface%.leases -I -P -N -df /var/lib/dhcp/dhclient.%iface%.leases %iface%" },
+	{ COMMAND_SHELL, 0, _dhcp_up_if_7, true, _dhcp_up_7, "dhclient -6 -v -pf /run/dhclient6.%iface%.pid -lf /var/lib/dhcp/dhclient6.%iface%.leases -I -df /var/lib/dhcp/dhclient.%iface%.leases %iface%" },
+	{ COMMAND_SHELL, 0, _dhcp_up_if_8, true, _dhcp_up_8, "echo 'No DHCPv6 client software found!' >&2; false" },
+	{ COMMAND_END, 0, NULL, false, NULL, NULL }
+};
+static int _dhcp_up(interface_defn *ifd, execfn *exec) {
+	return execute_ops(_dhcp_up_ops, &_dhcp_slots, ifd, exec);
+}
+static bool _dhcp_down_if_0(interface_defn *ifd) { return execable("dhclient"); }
+static const template_op _dhcp_down_0[] = {
+    { TEMPLATE_TEXT, "dhclient -6 -v -r -pf /run/dhclient6.", 37, -1, 0, 0 },
+    { TEMPLATE_VAR, "iface", 5, -1, 0, 0 },
+    { TEMPLATE_TEXT, ".pid -lf /var/lib/dhcp/dhclient6.", 33, -1, 0, 0 },
+    { TEMPLATE_VAR, "iface", 5, -1, 0, 0 },
+    { TEMPLATE_TEXT, ".leases -I -df /var/lib/dhcp/dhclient.", 38, -1, 0, 0 },
+    { TEMPLATE_VAR, "iface", 5, -1, 0, 0 },
+    { TEMPLATE_TEXT, ".leases ", 8, -1, 0, 0 },
+    { TEMPLATE_VAR, "iface", 5, -1, 0, 0 },
+    { TEMPLATE_END, NULL, 0, -1, 0, 0 },
+};
+static bool _dhcp_down_if_1(interface_defn *ifd) { return 1; }
+static const template_op _dhcp_down_1[] = {
+    { TEMPLATE_TEXT, "echo 'No DHCPv6 client software found!' >&2; false", 50, -1, 0, 0 },
+    { TEMPLATE_END, NULL, 0, -1, 0, 0 },
+};
+static bool _dhcp_down_if_2(interface_defn *ifd) { return iface_is_link(); }
+static const template_op _dhcp_down_2[] = {
+    { TEMPLATE_TEXT, "ip link set dev ", 16, -1, 0, 0 },
+    { TEMPLATE_VAR, "iface", 5, -1, 0, 0 },
+    { TEMPLATE_TEXT, " down", 5, -1, 0, 0 },
+    { TEMPLATE_END, NULL, 0, -1, 0, 0 },
+};
+static const command_op _dhcp_down_ops[] = {
+	{ COMMAND_SHELL, 0, _dhcp_down_if_0, false, _dhcp_down_0, "dhclient -6 -v -r -pf /run/dhclient6.%iface%.pid -lf /var/lib/dhcp/dhclient6.%iface%.leases -I -df /var/lib/dhcp/dhclient.%iface%.leases %iface%" },
+	{ COMMAND_SHELL, 0, _dhcp_down_if_1, true, _dhcp_down_1, "echo 'No DHCPv6 client software found!' >&2; false" },
+	{ COMMAND_LINK_SET, 0, _dhcp_down_if_2, false, _dhcp_down_2, "ip link set dev %iface% down" },
+	{ COMMAND_END, 0, NULL, false, NULL, NULL }
+};
+static int _dhcp_down(interface_defn *ifd, execfn *exec) {
+	return execute_ops(_dhcp_down_ops, &_dhcp_slots, ifd, exec);
+}
+static const command_op _dhcp_rename_ops[] = { { COMMAND_END, 0, NULL, false, NULL, NULL } };
+static int _dhcp_rename(interface_defn *ifd, execfn *exec) { return 0; }
+static option_default _tunnel_default[] = {
+	{ NULL, NULL }
+};
+static conversion _tunnel_conv[] = {
+	{ CONVERT_END, NULL, 0, -1, NULL, NULL, 0, NULL }
+};
+static const char *const _tunnel_slot_names[] = {
+	"address",
+	"netmask",
+	"mode",
+	"endpoint",
+	"dstaddr",
+	"local",
+	"metric",
+	"gateway",
+	"ttl",
+	"mtu",
+	"encaplimit",
+	NULL
+};
+static const option_slots _tunnel_slots = { 11, _tunnel_slot_names };
+static const template_op _tunnel_up_0[] = {
+    { TEMPLATE_TEXT, "ip -6 tunnel add ", 17, -1, 0, 0 },
+    { TEMPLATE_VAR, "iface", 5, -1, 0, 0 },
+    { TEMPLATE_TEXT, " mode ", 6, -1, 0, 0 },
+    { TEMPLATE_VAR, "mode", 4, 2, 0, 0 },
+    { TEMPLATE_TEXT, " remote ", 8, -1, 0, 0 },
+    { TEMPLATE_VAR, "endpoint", 8, 3, 0, 0 },
+    { TEMPLATE_TEXT, " ", 1, -1, 0, 0 },
+    { TEMPLATE_OPEN, NULL, 0, -1, 0, 0 },
+    { TEMPLATE_TEXT, "local ", 6, -1, 0, 0 },
+    { TEMPLATE_VAR, "local", 5, 5, 0, 0 },
+    { TEMPLATE_CLOSE, NULL, 0, -1, 0, 0 },
+    { TEMPLATE_TEXT, "        ", 8, -1, 0, 0 },
+    { TEMPLATE_OPEN, NULL, 0, -1, 0, 0 },
+    { TEMPLATE_TEXT, "ttl ", 4, -1, 0, 0 },
+    { TEMPLATE_VAR, "ttl", 3, 8, 0, 0 },
+    { TEMPLATE_CLOSE, NULL, 0, -1, 0, 0 },
+    { TEMPLATE_TEXT, " ", 1, -1, 0, 0 },
+    { TEMPLATE_OPEN, NULL, 0, -1, 0, 0 },
+    { TEMPLATE_TEXT, "encaplimit ", 11, -1, 0, 0 },
+    { TEMPLATE_VAR, "encaplimit", 10, 10, 0, 0 },
+    { TEMPLATE_CLOSE, NULL, 0, -1, 0, 0 },
+    { TEMPLATE_END, NULL, 0, -1, 0, 0 },
+};
+static const template_op _tunnel_up_1[] = {
+    { TEMPLATE_TEXT, "ip link set ", 12, -1, 0, 0 },
+    { TEMPLATE_VAR, "iface", 5, -1, 0, 0 },
+    { TEMPLATE_TEXT, " up ", 4, -1, 0, 0 },
+    { TEMPLATE_OPEN, NULL, 0, -1, 0, 0 },
+    { TEMPLATE_TEXT, "mtu ", 4, -1, 0, 0 },
+    { TEMPLATE_VAR, "mtu", 3, 9, 0, 0 },
+    { TEMPLATE_CLOSE, NULL, 0, -1, 0, 0 },
+    { TEMPLATE_END, NULL, 0, -1, 0, 0 },
+};
+static bool _tunnel_up_if_2(interface_defn *ifd) { return !var_strcasecmp_slot(&_tunnel_slots, 2, "ipip6"); }
+static const template_op _tunnel_up_2[] = {
+    { TEMPLATE_OPEN, NULL, 0, -1, 0, 0 },
+    { TEMPLATE_TEXT, "ip -4 addr add ", 15, -1, 0, 0 },
+    { TEMPLATE_VAR, "address", 7, 0, 0, 0 },
+    { TEMPLATE_TEXT, "/", 1, -1, 0, 0 },
+    { TEMPLATE_VAR, "netmask", 7, 1, 0, 0 },
+    { TEMPLATE_TEXT, " dev ", 5, -1, 0, 0 },
+    { TEMPLATE_VAR, "iface", 5, -1, 0, 0 },
+    { TEMPLATE_TEXT, " ", 1, -1, 0, 0 },
+    { TEMPLATE_OPEN, NULL, 0, -1, 0, 0 },
+    { TEMPLATE_TEXT, "peer ", 5, -1, 0, 0 },
+    { TEMPLATE_VAR, "dstaddr", 7, 4, 0, 0 },
+    { TEMPLATE_CLOSE, NULL, 0, -1, 0, 0 },
+    { TEMPLATE_TEXT, " ", 1, -1, 0, 0 },
+    { TEMPLATE_CLOSE, NULL, 0, -1, 0, 0 },
+    { TEMPLATE_END, NULL, 0, -1, 0, 0 },
+};
+static bool _tunnel_up_if_3(interface_defn *ifd) { return !var_strcasecmp_slot(&_tunnel_slots, 2, "ipip6"); }
+static const template_op _tunnel_up_3[] = {
+    { TEMPLATE_OPEN, NULL, 0, -1, 0, 0 },
+    { TEMPLATE_TEXT, "ip -4 route add 0.0.0.0/0 via ", 30, -1, 0, 0 },
+    { TEMPLATE_VAR, "gateway", 7, 7, 0, 0 },
+    { TEMPLATE_TEXT, " ", 1, -1, 0, 0 },
+    { TEMPLATE_OPEN, NULL, 0, -1, 0, 0 },
+    { TEMPLATE_TEXT, "metric ", 7, -1, 0, 0 },
+    { TEMPLATE_VAR, "metric", 6, 6, 0, 0 },
+    { TEMPLATE_CLOSE, NULL, 0, -1, 0, 0 },
+    { TEMPLATE_TEXT, " dev ", 5, -1, 0, 0 },
+    { TEMPLATE_VAR, "iface", 5, -1, 0, 0 },
+    { TEMPLATE_TEXT, " onlink ", 8, -1, 0, 0 },
+    { TEMPLATE_CLOSE, NULL, 0, -1, 0, 0 },
+    { TEMPLATE_END, NULL, 0, -1, 0, 0 },
+};
+static bool _tunnel_up_if_4(interface_defn *ifd) { return var_strcasecmp_slot(&_tunnel_slots, 2, "ipip6"); }
+static const template_op _tunnel_up_4[] = {
+    { TEMPLATE_OPEN, NULL, 0, -1, 0, 0 },
+    { TEMPLATE_TEXT, "ip -6 addr add ", 15, -1, 0, 0 },
+    { TEMPLATE_VAR, "address", 7, 0, 0, 0 },
+    { TEMPLATE_TEXT, "/", 1, -1, 0, 0 },
+    { TEMPLATE_VAR, "netmask", 7, 1, 0, 0 },
+    { TEMPLATE_TEXT, " dev ", 5, -1, 0, 0 },
+    { TEMPLATE_VAR, "iface", 5, -1, 0, 0 },
+    { TEMPLATE_TEXT, " ", 1, -1, 0, 0 },
+    { TEMPLATE_OPEN, NULL, 0, -1, 0, 0 },
+    { TEMPLATE_TEXT, "peer ", 5, -1, 0, 0 },
+    { TEMPLATE_VAR, "dstaddr", 7, 4, 0, 0 },
+    { TEMPLATE_CLOSE, NULL, 0, -1, 0, 0 },
+    { TEMPLATE_TEXT, " ", 1, -1, 0, 0 },
+    { TEMPLATE_CLOSE, NULL, 0, -1, 0, 0 },
+    { TEMPLATE_END, NULL, 0, -1, 0, 0 },
+};
+static bool _tunnel_up_if_5(interface_defn *ifd) { return var_strcasecmp_slot(&_tunnel_slots, 2, "ipip6"); }
+static const template_op _tunnel_up_5[] = {
+    { TEMPLATE_OPEN, NULL, 0, -1, 0, 0 },
+    { TEMPLATE_TEXT, "ip -6 route add ::/0 via ", 25, -1, 0, 0 },
+    { TEMPLATE_VAR, "gateway", 7, 7, 0, 0 },
+    { TEMPLATE_TEXT, " ", 1, -1, 0, 0 },
+    { TEMPLATE_OPEN, NULL, 0, -1, 0, 0 },
+    { TEMPLATE_TEXT, "metric ", 7, -1, 0, 0 },
+    { TEMPLATE_VAR, "metric", 6, 6, 0, 0 },
+    { TEMPLATE_CLOSE, NULL, 0, -1, 0, 0 },
+    { TEMPLATE_TEXT, " dev ", 5, -1, 0, 0 },
+    { TEMPLATE_VAR, "iface", 5, -1, 0, 0 },
+    { TEMPLATE_TEXT, " onlink ", 8, -1, 0, 0 },
+    { TEMPLATE_CLOSE, NULL, 0, -1, 0, 0 },
+    { TEMPLATE_END, NULL, 0, -1, 0, 0 },
+};
+static const command_op _tunnel_up_ops[] = {
+	{ COMMAND_IP, 6, NULL, false, _tunnel_up_0, "ip -6 tunnel add %iface% mode %mode% remote %endpoint% [[local %local%]] \
+       [[ttl %ttl%]] [[encaplimit %encaplimit%]]" },
+	{ COMMAND_LINK_SET, 0, NULL, false, _tunnel_up_1, "ip link set %iface% up [[mtu %mtu%]]" },
+	{ COMMAND_ADDR_ADD, 4, _tunnel_up_if_2, false, _tunnel_up_2, "[[ip -4 addr add %address%/%netmask% dev %iface% [[peer %dstaddr%]] ]]" },
+	{ COMMAND_ROUTE_ADD, 4, _tunnel_up_if_3, false, _tunnel_up_3, "[[ip -4 route add 0.0.0.0/0 via %gateway% [[metric %metric%]] dev %iface% onlink ]]" },
+	{ COMMAND_ADDR_ADD, 6, _tunnel_up_if_4, false, _tunnel_up_4, "[[ip -6 addr add %address%/%netmask% dev %iface% [[peer %dstaddr%]] ]]" },
+	{ COMMAND_ROUTE_ADD, 6, _tunnel_up_if_5, false, _tunnel_up_5, "[[ip -6 route add ::/0 via %gateway% [[metric %metric%]] dev %iface% onlink ]]" },
+	{ COMMAND_END, 0, NULL, false, NULL, NULL }
+};
+static int _tunnel_up(interface_defn *ifd, execfn *exec) {
+	return execute_ops(_tunnel_up_ops, &_tunnel_slots, ifd, exec);
+}
+static const template_op _tunnel_down_0[] = {
+    { TEMPLATE_TEXT, "ip -6 tunnel del ", 17, -1, 0, 0 },
+    { TEMPLATE_VAR, "iface", 5, -1, 0, 0 },
+    { TEMPLATE_END, NULL, 0, -1, 0, 0 },
+};
+static const command_op _tunnel_down_ops[] = {
+	{ COMMAND_IP, 6, NULL, false, _tunnel_down_0, "ip -6 tunnel del %iface%" },
+	{ COMMAND_END, 0, NULL, false, NULL, NULL }
+};
+static int _tunnel_down(interface_defn *ifd, execfn *exec) {
+	return execute_ops(_tunnel_down_ops, &_tunnel_slots, ifd, exec);
+}
+static const command_op _tunnel_rename_ops[] = { { COMMAND_END, 0, NULL, false, NULL, NULL } };
+static int _tunnel_rename(interface_defn *ifd, execfn *exec) { return 0; }
+static option_default _v4tunnel_default[] = {
+	{ "preferred-lifetime", "" },
+	{ NULL, NULL }
+};
+static conversion _v4tunnel_conv[] = {
+	{ CONVERT_OPTION, "preferred-lifetime", 18, 8, NULL, set_preferred_lft, 0, NULL },
+	{ CONVERT_END, NULL, 0, -1, NULL, NULL, 0, NULL }
+};
+static const char *const _v4tunnel_slot_names[] = {
+	"address",
+	"netmask",
+	"endpoint",
+	"local",
+	"metric",
+	"gateway",
+	"ttl",
+	"mtu",
+	"preferred-lifetime",
+	NULL
+};
+static const option_slots _v4tunnel_slots = { 9, _v4tunnel_slot_names };
+static const template_op _v4tunnel_up_0[] = {
+    { TEMPLATE_TEXT, "modprobe -q net-pf-10 > /dev/null 2>&1 || true # ignore failure.", 64, -1, 0, 0 },
+    { TEMPLATE_END, NULL, 0, -1, 0, 0 },
+};
+static const template_op _v4tunnel_up_1[] = {
+    { TEMPLATE_TEXT, "ip tunnel add ", 14, -1, 0, 0 },
+    { TEMPLATE_VAR, "iface", 5, -1, 0, 0 },
+    { TEMPLATE_TEXT, " mode sit remote ", 17, -1, 0, 0 },
+    { TEMPLATE_VAR, "endpoint", 8, 2, 0, 0 },
+    { TEMPLATE_TEXT, " ", 1, -1, 0, 0 },
+    { TEMPLATE_OPEN, NULL, 0, -1, 0, 0 },
+    { TEMPLATE_TEXT, "local ", 6, -1, 0, 0 },
+    { TEMPLATE_VAR, "local", 5, 3, 0, 0 },
+    { TEMPLATE_CLOSE, NULL, 0, -1, 0, 0 },
+    { TEMPLATE_TEXT, "        ", 8, -1, 0, 0 },
+    { TEMPLATE_OPEN, NULL, 0, -1, 0, 0 },
+    { TEMPLATE_TEXT, "ttl ", 4, -1, 0, 0 },
+    { TEMPLATE_VAR, "ttl", 3, 6, 0, 0 },
+    { TEMPLATE_CLOSE, NULL, 0, -1, 0, 0 },
+    { TEMPLATE_END, NULL, 0, -1, 0, 0 },
+};
+static const template_op _v4tunnel_up_2[] = {
+    { TEMPLATE_TEXT, "ip link set ", 12, -1, 0, 0 },
+    { TEMPLATE_VAR, "iface", 5, -1, 0, 0 },
+    { TEMPLATE_TEXT, " up ", 4, -1, 0, 0 },
+    { TEMPLATE_OPEN, NULL, 0, -1, 0, 0 },
+    { TEMPLATE_TEXT, "mtu ", 4, -1, 0, 0 },
+    { TEMPLATE_VAR, "mtu", 3, 7, 0, 0 },
+    { TEMPLATE_CLOSE, NULL, 0, -1, 0, 0 },
+    { TEMPLATE_END, NULL, 0, -1, 0, 0 },
+};
+static const template_op _v4tunnel_up_3[] = {
+    { TEMPLATE_OPEN, NULL, 0, -1, 0, 0 },
+    { TEMPLATE_TEXT, " ip addr add ", 13, -1, 0, 0 },
+    { TEMPLATE_VAR, "address", 7, 0, 0, 0 },
+    { TEMPLATE_OPEN, NULL, 0, -1, 0, 0 },
+    { TEMPLATE_TEXT, "/", 1, -1, 0, 0 },
+    { TEMPLATE_VAR, "netmask", 7, 1, 0, 0 },
+    { TEMPLATE_CLOSE, NULL, 0, -1, 0, 0 },
+    { TEMPLATE_TEXT, " dev ", 5, -1, 0, 0 },
+    { TEMPLATE_VAR, "iface", 5, -1, 0, 0 },
+    { TEMPLATE_TEXT, " ", 1, -1, 0, 0 },
+    { TEMPLATE_OPEN, NULL, 0, -1, 0, 0 },
+    { TEMPLATE_TEXT, "preferred_lft ", 14, -1, 0, 0 },
+    { TEMPLATE_VAR, "preferred-lifetime", 18, 8, 0, 0 },
+    { TEMPLATE_CLOSE, NULL, 0, -1, 0, 0 },
+    { TEMPLATE_TEXT, " ", 1, -1, 0, 0 },
+    { TEMPLATE_CLOSE, NULL, 0, -1, 0, 0 },
+    { TEMPLATE_END, NULL, 0, -1, 0, 0 },
+};
+static const template_op _v4tunnel_up_4[] = {
+    { TEMPLATE_OPEN, NULL, 0, -1, 0, 0 },
+    { TEMPLATE_TEXT, " ip route add ", 14, -1, 0, 0 },
+    { TEMPLATE_VAR, "gateway", 7, 5, 0, 0 },
+    { TEMPLATE_TEXT, " dev ", 5, -1, 0, 0 },
+    { TEMPLATE_VAR, "iface", 5, -1, 0, 0 },
+    { TEMPLATE_TEXT, " ", 1, -1, 0, 0 },
+    { TEMPLATE_CLOSE, NULL, 0, -1, 0, 0 },
+    { TEMPLATE_END, NULL, 0, -1, 0, 0 },
+};
+static const template_op _v4tunnel_up_5[] = {
+    { TEMPLATE_OPEN, NULL, 0, -1, 0, 0 },
+    { TEMPLATE_TEXT, " ip route add ::/0 via ", 23, -1, 0, 0 },
+    { TEMPLATE_VAR, "gateway", 7, 5, 0, 0 },
+    { TEMPLATE_TEXT, " ", 1, -1, 0, 0 },
+    { TEMPLATE_OPEN, NULL, 0, -1, 0, 0 },
+    { TEMPLATE_TEXT, "metric ", 7, -1, 0, 0 },
+    { TEMPLATE_VAR, "metric", 6, 4, 0, 0 },
+    { TEMPLATE_CLOSE, NULL, 0, -1, 0, 0 },
+    { TEMPLATE_TEXT, " dev ", 5, -1, 0, 0 },
+    { TEMPLATE_VAR, "iface", 5, -1, 0, 0 },
+    { TEMPLATE_TEXT, " onlink ", 8, -1, 0, 0 },
+    { TEMPLATE_CLOSE, NULL, 0, -1, 0, 0 },
+    { TEMPLATE_END, NULL, 0, -1, 0, 0 },
+};
+static const command_op _v4tunnel_up_ops[] = {
+	{ COMMAND_SHELL, 0, NULL, false, _v4tunnel_up_0, "modprobe -q net-pf-10 > /dev/null 2>&1 || true # ignore failure." },
+	{ COMMAND_IP, 0, NULL, false, _v4tunnel_up_1, "ip tunnel add %iface% mode sit remote %endpoint% [[local %local%]] \
+       [[ttl %ttl%]]" },
+	{ COMMAND_LINK_SET, 0, NULL, false, _v4tunnel_up_2, "ip link set %iface% up [[mtu %mtu%]]" },
+	{ COMMAND_ADDR_ADD, 0, NULL, false, _v4tunnel_up_3, "[[ ip addr add %address%[[/%netmask%]] dev %iface% [[preferred_lft %preferred-lifetime%]] ]]" },
+	{ COMMAND_ROUTE_ADD, 0, NULL, false, _v4tunnel_up_4, "[[ ip route add %gateway% dev %iface% ]]" },
+	{ COMMAND_ROUTE_ADD, 0, NULL, false, _v4tunnel_up_5, "[[ ip route add ::/0 via %gateway% [[metric %metric%]] dev %iface% onlink ]]" },
+	{ COMMAND_END, 0, NULL, false, NULL, NULL }
+};
+static int _v4tunnel_up(interface_defn *ifd, execfn *exec) {
+	return execute_ops(_v4tunnel_up_ops, &_v4tunnel_slots, ifd, exec);
+}
+static const template_op _v4tunnel_down_0[] = {
+    { TEMPLATE_TEXT, "ip tunnel del ", 14, -1, 0, 0 },
+    { TEMPLATE_VAR, "iface", 5, -1, 0, 0 },
+    { TEMPLATE_END, NULL, 0, -1, 0, 0 },
+};
+static const command_op _v4tunnel_down_ops[] = {
+	{ COMMAND_IP, 0, NULL, false, _v4tunnel_down_0, "ip tunnel del %iface%" },
+	{ COMMAND_END, 0, NULL, false, NULL, NULL }
+};
+static int _v4tunnel_down(interface_defn *ifd, execfn *exec) {
+	return execute_ops(_v4tunnel_down_ops, &_v4tunnel_slots, ifd, exec);
+}
+static const command_op _v4tunnel_rename_ops[] = { { COMMAND_END, 0, NULL, false, NULL, NULL } };
+static int _v4tunnel_rename(interface_defn *ifd, execfn *exec) { return 0; }
+static option_default _6to4_default[] = {
+	{ "preferred-lifetime", "" },
+	{ NULL, NULL }
+};
+static conversion _6to4_conv[] = {
+	{ CONVERT_OPTION, "local", 5, 0, "hexaddress", make_hex_address, 0, NULL },
+	{ CONVERT_OPTION, "preferred-lifetime", 18, 4, NULL, set_preferred_lft, 0, NULL },
+	{ CONVERT_END, NULL, 0, -1, NULL, NULL, 0, NULL }
+};
+static const char *const _6to4_slot_names[] = {
+	"local",
+	"metric",
+	"ttl",
+	"mtu",
+	"preferred-lifetime",
+	"hexaddress",
+	NULL
+};
+static const option_slots _6to4_slots = { 6, _6to4_slot_names };
+static const template_op _6to4_up_0[] = {
+    { TEMPLATE_TEXT, "modprobe -q net-pf-10 > /dev/null 2>&1 || true # ignore failure.", 64, -1, 0, 0 },
+    { TEMPLATE_END, NULL, 0, -1, 0, 0 },
+};
+static const template_op _6to4_up_1[] = {
+    { TEMPLATE_TEXT, "ip tunnel add ", 14, -1, 0, 0 },
+    { TEMPLATE_VAR, "iface", 5, -1, 0, 0 },
+    { TEMPLATE_TEXT, " mode sit remote any local ", 27, -1, 0, 0 },
+    { TEMPLATE_VAR, "local", 5, 0, 0, 0 },
+    { TEMPLATE_TEXT, "        ", 8, -1, 0, 0 },
+    { TEMPLATE_OPEN, NULL, 0, -1, 0, 0 },
+    { TEMPLATE_TEXT, "ttl ", 4, -1, 0, 0 },
+    { TEMPLATE_VAR, "ttl", 3, 2, 0, 0 },
+    { TEMPLATE_CLOSE, NULL, 0, -1, 0, 0 },
+    { TEMPLATE_END, NULL, 0, -1, 0, 0 },
+};
+static const template_op _6to4_up_2[] = {
+    { TEMPLATE_TEXT, "ip link set ", 12, -1, 0, 0 },
+    { TEMPLATE_VAR, "iface", 5, -1, 0, 0 },
+    { TEMPLATE_TEXT, " up ", 4, -1, 0, 0 },
+    { TEMPLATE_OPEN, NULL, 0, -1, 0, 0 },
+    { TEMPLATE_TEXT, "mtu ", 4, -1, 0, 0 },
+    { TEMPLATE_VAR, "mtu", 3, 3, 0, 0 },
+    { TEMPLATE_CLOSE, NULL, 0, -1, 0, 0 },
+    { TEMPLATE_END, NULL, 0, -1, 0, 0 },
+};
+static const template_op _6to4_up_3[] = {
+    { TEMPLATE_TEXT, "ip addr add 2002:", 17, -1, 0, 0 },
+    { TEMPLATE_VAR, "hexaddress", 10, 5, 0, 0 },
+    { TEMPLATE_TEXT, "::1/16 dev ", 11, -1, 0, 0 },
+    { TEMPLATE_VAR, "iface", 5, -1, 0, 0 },
+    { TEMPLATE_TEXT, " ", 1, -1, 0, 0 },
+    { TEMPLATE_OPEN, NULL, 0, -1, 0, 0 },
+    { TEMPLATE_TEXT, "preferred_lft ", 14, -1, 0, 0 },
+    { TEMPLATE_VAR, "preferred-lifetime", 18, 4, 0, 0 },
+    { TEMPLATE_CLOSE, NULL, 0, -1, 0, 0 },
+    { TEMPLATE_END, NULL, 0, -1, 0, 0 },
+};
+static const template_op _6to4_up_4[] = {
+    { TEMPLATE_TEXT, "ip route add 2000::/3 via ::192.88.99.1 ", 40, -1, 0, 0 },
+    { TEMPLATE_OPEN, NULL, 0, -1, 0, 0 },
+    { TEMPLATE_TEXT, "metric ", 7, -1, 0, 0 },
+    { TEMPLATE_VAR, "metric", 6, 1, 0, 0 },
+    { TEMPLATE_CLOSE, NULL, 0, -1, 0, 0 },
+    { TEMPLATE_TEXT, " dev ", 5, -1, 0, 0 },
+    { TEMPLATE_VAR, "iface", 5, -1, 0, 0 },
+    { TEMPLATE_END, NULL, 0, -1, 0, 0 },
+};
+static const command_op _6to4_up_ops[] = {
+	{ COMMAND_SHELL, 0, NULL, false, _6to4_up_0, "modprobe -q net-pf-10 > /dev/null 2>&1 || true # ignore failure." },
+	{ COMMAND_IP, 0, NULL, false, _6to4_up_1, "ip tunnel add %iface% mode sit remote any local %local% \
+       [[ttl %ttl%]]" },
+	{ COMMAND_LINK_SET, 0, NULL, false, _6to4_up_2, "ip link set %iface% up [[mtu %mtu%]]" },
+	{ COMMAND_ADDR_ADD, 0, NULL, false, _6to4_up_3, "ip addr add 2002:%hexaddress%::1/16 dev %iface% [[preferred_lft %preferred-lifetime%]]" },
+	{ COMMAND_ROUTE_ADD, 0, NULL, false, _6to4_up_4, "ip route add 2000::/3 via ::192.88.99.1 [[metric %metric%]] dev %iface%" },
+	{ COMMAND_END, 0, NULL, false, NULL, NULL }
+};
+static int _6to4_up(interface_defn *ifd, execfn *exec) {
+	return execute_ops(_6to4_up_ops, &_6to4_slots, ifd, exec);
+}
+static const template_op _6to4_down_0[] = {
+    { TEMPLATE_TEXT, "ip -6 route flush dev ", 22, -1, 0, 0 },
+    { TEMPLATE_VAR, "iface", 5, -1, 0, 0 },
+    { TEMPLATE_END, NULL, 0, -1, 0, 0 },
+};
+static const template_op _6to4_down_1[] = {
+    { TEMPLATE_TEXT, "ip link set dev ", 16, -1, 0, 0 },
+    { TEMPLATE_VAR, "iface", 5, -1, 0, 0 },
+    { TEMPLATE_TEXT, " down", 5, -1, 0, 0 },
+    { TEMPLATE_END, NULL, 0, -1, 0, 0 },
+};
+static const template_op _6to4_down_2[] = {
+    { TEMPLATE_TEXT, "ip tunnel del ", 14, -1, 0, 0 },
+    { TEMPLATE_VAR, "iface", 5, -1, 0, 0 },
+    { TEMPLATE_END, NULL, 0, -1, 0, 0 },
+};
+static const command_op _6to4_down_ops[] = {
+	{ COMMAND_IP, 6, NULL, false, _6to4_down_0, "ip -6 route flush dev %iface%" },
+	{ COMMAND_LINK_SET, 0, NULL, false, _6to4_down_1, "ip link set dev %iface% down" },
+	{ COMMAND_IP, 0, NULL, false, _6to4_down_2, "ip tunnel del %iface%" },
+	{ COMMAND_END, 0, NULL, false, NULL, NULL }
+};
+static int _6to4_down(interface_defn *ifd, execfn *exec) {
+	return execute_ops(_6to4_down_ops, &_6to4_slots, ifd, exec);
+}
+static const command_op _6to4_rename_ops[] = { { COMMAND_END, 0, NULL, false, NULL, NULL } };
+static int _6to4_rename(interface_defn *ifd, execfn *exec) { return 0; }
+static method methods[] = {
+        {
+                "6to4",
+                _6to4_up, _6to4_down, _6to4_rename,
+                _6to4_conv, _6to4_default,
+                &_6to4_slots,
+                _6to4_up_ops, _6to4_down_ops, _6to4_rename_ops,
+        },
+        {
+                "auto",
+                _auto_up, _auto_down, _auto_rename,
+                _auto_conv, _auto_default,
+                &_auto_slots,
+                _auto_up_ops, _auto_down_ops, _auto_rename_ops,
+        },
+        {
+                "dhcp",
+                _dhcp_up, _dhcp_down, _dhcp_rename,
+                _dhcp_conv, _dhcp_default,
+                &_dhcp_slots,
+                _dhcp_up_ops, _dhcp_down_ops, _dhcp_rename_ops,
+        },
+        {
+                "loopback",
+                _loopback_up, _loopback_down, _loopback_rename,
+                _loopback_conv, _loopback_default,
+                &_loopback_slots,
+                _loopback_up_ops, _loopback_down_ops, _loopback_rename_ops,
+        },
+        {
+                "manual",
+                _manual_up, _manual_down, _manual_rename,
+                _manual_conv, _manual_default,
+                &_manual_slots,
+                _manual_up_ops, _manual_down_ops, _manual_rename_ops,
+        },
+        {
+                "static",
+                _static_up, _static_down, _static_rename,
+                _static_conv, _static_default,
+                &_static_slots,
+                _static_up_ops, _static_down_ops, _static_rename_ops,
+        },
+        {
+                "tunnel",
+                _tunnel_up, _tunnel_down, _tunnel_rename,
+                _tunnel_conv, _tunnel_default,
+                &_tunnel_slots,
+                _tunnel_up_ops, _tunnel_down_ops, _tunnel_rename_ops,
+        },
+        {
+                "v4tunnel",
+                _v4tunnel_up, _v4tunnel_down, _v4tunnel_rename,
+                _v4tunnel_conv, _v4tunnel_default,
+                &_v4tunnel_slots,
+                _v4tunnel_up_ops, _v4tunnel_down_ops, _v4tunnel_rename_ops,
+        },
+};
+
+static const signed char method_slots[] = { 4, 6, 5, 7, 2, 0, 3, 1 };
+
+address_family addr_inet6 = {
+        "inet6",
+        sizeof(methods)/sizeof(struct method),
+        methods,
+        { 65, 7, method_slots }
+};
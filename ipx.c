@@ -0,0 +1,118 @@
+#include <stddef.h>
+#include "header.h"
+
+
+#include "archcommon.h"
+#include "archlinux.h"
+
+
+static option_default _static_default[] = {
+	{ NULL, NULL }
+};
+static conversion _static_conv[] = {
+	{ CONVERT_END, NULL, 0, -1, NULL, NULL, 0, NULL }
+};
+static const char *const _static_slot_names[] = {
+	"frame",
+	"netnum",
+	NULL
+};
+static const option_slots _static_slots = { 2, _static_slot_names };
+static const template_op _static_up_0[] = {
+    { TEMPLATE_TEXT, "ipx_interface add ", 18, -1, 0, 0 },
+    { TEMPLATE_VAR, "iface", 5, -1, 0, 0 },
+    { TEMPLATE_TEXT, " ", 1, -1, 0, 0 },
+    { TEMPLATE_VAR, "frame", 5, 0, 0, 0 },
+    { TEMPLATE_TEXT, " ", 1, -1, 0, 0 },
+    { TEMPLATE_VAR, "netnum", 6, 1, 0, 0 },
+    { TEMPLATE_END, NULL, 0, -1, 0, 0 },
+};
+static const command_op _static_up_ops[] = {
+	{ COMMAND_SHELL, 0, NULL, false, _static_up_0, "ipx_interface add %iface% %frame% %netnum%" },
+	{ COMMAND_END, 0, NULL, false, NULL, NULL }
+};
+static int _static_up(interface_defn *ifd, execfn *exec) {
+	return execute_ops(_static_up_ops, &_static_slots, ifd, exec);
+}
+static const template_op _static_down_0[] = {
+    { TEMPLATE_TEXT, "ipx_interface del ", 18, -1, 0, 0 },
+    { TEMPLATE_VAR, "iface", 5, -1, 0, 0 },
+    { TEMPLATE_TEXT, " ", 1, -1, 0, 0 },
+    { TEMPLATE_VAR, "frame", 5, 0, 0, 0 },
+    { TEMPLATE_END, NULL, 0, -1, 0, 0 },
+};
+static const command_op _static_down_ops[] = {
+	{ COMMAND_SHELL, 0, NULL, false, _static_down_0, "ipx_interface del %iface% %frame%" },
+	{ COMMAND_END, 0, NULL, false, NULL, NULL }
+};
+static int _static_down(interface_defn *ifd, execfn *exec) {
+	return execute_ops(_static_down_ops, &_static_slots, ifd, exec);
+}
+static const command_op _static_rename_ops[] = { { COMMAND_END, 0, NULL, false, NULL, NULL } };
+static int _static_rename(interface_defn *ifd, execfn *exec) { return 0; }
+static option_default _dynamic_default[] = {
+	{ NULL, NULL }
+};
+static conversion _dynamic_conv[] = {
+	{ CONVERT_END, NULL, 0, -1, NULL, NULL, 0, NULL }
+};
+static const char *const _dynamic_slot_names[] = {
+	"frame",
+	NULL
+};
+static const option_slots _dynamic_slots = { 1, _dynamic_slot_names };
+static const template_op _dynamic_up_0[] = {
+    { TEMPLATE_TEXT, "ipx_interface add ", 18, -1, 0, 0 },
+    { TEMPLATE_VAR, "iface", 5, -1, 0, 0 },
+    { TEMPLATE_TEXT, " ", 1, -1, 0, 0 },
+    { TEMPLATE_VAR, "frame", 5, 0, 0, 0 },
+    { TEMPLATE_END, NULL, 0, -1, 0, 0 },
+};
+static const command_op _dynamic_up_ops[] = {
+	{ COMMAND_SHELL, 0, NULL, false, _dynamic_up_0, "ipx_interface add %iface% %frame%" },
+	{ COMMAND_END, 0, NULL, false, NULL, NULL }
+};
+static int _dynamic_up(interface_defn *ifd, execfn *exec) {
+	return execute_ops(_dynamic_up_ops, &_dynamic_slots, ifd, exec);
+}
+static const template_op _dynamic_down_0[] = {
+    { TEMPLATE_TEXT, "ipx_interface del ", 18, -1, 0, 0 },
+    { TEMPLATE_VAR, "iface", 5, -1, 0, 0 },
+    { TEMPLATE_TEXT, " ", 1, -1, 0, 0 },
+    { TEMPLATE_VAR, "frame", 5, 0, 0, 0 },
+    { TEMPLATE_END, NULL, 0, -1, 0, 0 },
+};
+static const command_op _dynamic_down_ops[] = {
+	{ COMMAND_SHELL, 0, NULL, false, _dynamic_down_0, "ipx_interface del %iface% %frame%" },
+	{ COMMAND_END, 0, NULL, false, NULL, NULL }
+};
+static int _dynamic_down(interface_defn *ifd, execfn *exec) {
+	return execute_ops(_dynamic_down_ops, &_dynamic_slots, ifd, exec);
+}
+static const command_op _dynamic_rename_ops[] = { { COMMAND_END, 0, NULL, false, NULL, NULL } };
+static int _dynamic_rename(interface_defn *ifd, execfn *exec) { return 0; }
+static method methods[] = {
+        {
+                "dynamic",
+                _dynamic_up, _dynamic_down, _dynamic_rename,
+                _dynamic_conv, _dynamic_default,
+                &_dynamic_slots,
+                _dynamic_up_ops, _dynamic_down_ops, _dynamic_rename_ops,
+        },
+        {
+                "static",
+                _static_up, _static_down, _static_rename,
+                _static_conv, _static_default,
+                &_static_slots,
+                _static_up_ops, _static_down_ops, _static_rename_ops,
+        },
+};
+
+static const signed char method_slots[] = { 0, 1 };
+
+address_family addr_ipx = {
+        "ipx",
+        sizeof(methods)/sizeof(struct method),
+        methods,
+        { 10, 1, method_slots }
+};
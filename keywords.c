@@ -0,0 +1,22 @@
+/* Generated by keywords.pl from header.h and addrfam.c */
+
+#include <stddef.h>
+#include "header.h"
+
+const char *const stanza_words[] = {
+	"mapping",
+	"source",
+	"source-directory",
+	"iface",
+	"auto",
+	NULL,
+	"no-auto-down",
+	"no-scripts",
+	"rename",
+};
+
+static const signed char stanza_word_slots[] = { 4, 0, 6, 3, 1, 8, 7, 2 };
+const perfect_hash stanza_word_hash = { 608, 7, stanza_word_slots };
+
+static const signed char addr_fam_slots[] = { 0, -1, -1, -1, 4, 1, 2, 3 };
+const perfect_hash addr_fam_hash = { 2, 7, addr_fam_slots };
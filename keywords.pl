@@ -0,0 +1,64 @@
+#!/usr/bin/perl -w
+
+# Make the perfect hash tables for the words that start a stanza, from
+# enum stanza_word in header.h, and for the address families listed in
+# addrfam.c.
+#
+# usage: keywords.pl header.h addrfam.c > keywords.c
+
+use strict;
+use FindBin;
+
+require "$FindBin::Bin/phash.pl";
+
+die "usage: keywords.pl header.h addrfam.c\n" unless (@ARGV == 2);
+
+my ($header, $addrfam) = @ARGV;
+
+# enumerators with a quoted word are looked up, the others match by prefix
+my @words = ();
+my $in_enum = 0;
+
+open(my $h, "<", $header) or die "$header: $!\n";
+while (<$h>) {
+        if (/^enum stanza_word \{/) {
+                $in_enum = 1;
+        } elsif ($in_enum and /^\}/) {
+                last;
+        } elsif ($in_enum and /^\s*STANZA_\w+,\s*(?:\/\*\s*"([^"]+)")?/) {
+                push @words, $1;
+        }
+}
+close($h);
+
+die "$header: no enum stanza_word\n" unless (@words);
+
+my @families = ();
+
+open(my $a, "<", $addrfam) or die "$addrfam: $!\n";
+while (<$a>) {
+        push @families, $1 if (/^\s*&addr_(\w+),/);
+}
+close($a);
+
+die "$addrfam: no address families\n" unless (@families);
+
+print "/* Generated by keywords.pl from $header and $addrfam */\n\n";
+print "#include <stddef.h>\n";
+print "#include \"header.h\"\n\n";
+
+print "const char *const stanza_words[] = {\n";
+print "\t" . (defined($_) ? "\"$_\"" : "NULL") . ",\n" foreach (@words);
+print "};\n\n";
+
+# the prefix words get no slot, and their index is never returned
+my @indices = grep { defined($words[$_]) } 0 .. $#words;
+my ($seed, $mask, @slot) = perfect_hash(map { $words[$_] } @indices);
+@slot = map { $_ < 0 ? -1 : $indices[$_] } @slot;
+
+print "static const signed char stanza_word_slots[] = { " . join(", ", @slot) . " };\n";
+print "const perfect_hash stanza_word_hash = { $seed, $mask, stanza_word_slots };\n\n";
+
+my $families = print_perfect_hash("addr_fam_slots", @families);
+
+print "const perfect_hash addr_fam_hash = $families;\n";
@@ -0,0 +1,167 @@
+#include <stddef.h>
+#include "header.h"
+
+
+#include "archcommon.h"
+#include "archlinux.h"
+
+
+static option_default _none_default[] = {
+	{ "description", "" },
+	{ NULL, NULL }
+};
+static conversion _none_conv[] = {
+	{ CONVERT_IFACE, NULL, 0, -1, "link", get_token, 3, (char * []){".", "0", ""} },
+	{ CONVERT_IFACE, NULL, 0, -1, "vlan_id0", get_token, 3, (char * []){".", "1", ""} },
+	{ CONVERT_IFACE, NULL, 0, -1, "iface0", get_token, 3, (char * []){":", "0", ""} },
+	{ CONVERT_OPTION, "vlan_id0", 8, 2, "vlan_id1", get_token, 3, (char * []){":", "0", ""} },
+	{ CONVERT_OPTION, "vlan_id1", 8, 4, "vlan_id", to_decimal, 1, (char * []){"10"} },
+	{ CONVERT_END, NULL, 0, -1, NULL, NULL, 0, NULL }
+};
+static const char *const _none_slot_names[] = {
+	"description",
+	"link",
+	"vlan_id0",
+	"iface0",
+	"vlan_id1",
+	"vlan_id",
+	NULL
+};
+static const option_slots _none_slots = { 6, _none_slot_names };
+static bool _none_up_if_0(interface_defn *ifd) { return iface_has("."); }
+static const template_op _none_up_0[] = {
+    { TEMPLATE_TEXT, "if test -d /sys/class/net/", 26, -1, 0, 0 },
+    { TEMPLATE_VAR, "link", 4, 1, 0, 0 },
+    { TEMPLATE_TEXT, " &&         ! ip link show ", 27, -1, 0, 0 },
+    { TEMPLATE_VAR, "iface0", 6, 3, 0, 0 },
+    { TEMPLATE_TEXT, " >/dev/null 2>&1;     then         if test `cat /sys/class/net/", 63, -1, 0, 0 },
+    { TEMPLATE_VAR, "link", 4, 1, 0, 0 },
+    { TEMPLATE_TEXT, "/type` -eq 32; then             echo 0x", 39, -1, 0, 0 },
+    { TEMPLATE_VAR, "vlan_id1", 8, 4, 0, 0 },
+    { TEMPLATE_TEXT, " > /sys/class/net/", 18, -1, 0, 0 },
+    { TEMPLATE_VAR, "link", 4, 1, 0, 0 },
+    { TEMPLATE_TEXT, "/create_child;         else             ip link set up dev ", 59, -1, 0, 0 },
+    { TEMPLATE_VAR, "link", 4, 1, 0, 0 },
+    { TEMPLATE_TEXT, ";             ip link add link ", 31, -1, 0, 0 },
+    { TEMPLATE_VAR, "link", 4, 1, 0, 0 },
+    { TEMPLATE_TEXT, " name ", 6, -1, 0, 0 },
+    { TEMPLATE_VAR, "iface0", 6, 3, 0, 0 },
+    { TEMPLATE_TEXT, " type vlan id ", 14, -1, 0, 0 },
+    { TEMPLATE_VAR, "vlan_id", 7, 5, 0, 0 },
+    { TEMPLATE_TEXT, "; \tfi;     fi", 13, -1, 0, 0 },
+    { TEMPLATE_END, NULL, 0, -1, 0, 0 },
+};
+static bool _none_up_if_1(interface_defn *ifd) { return iface_is_lo(); }
+static const template_op _none_up_1[] = {
+    { TEMPLATE_TEXT, "-ip link set up dev ", 20, -1, 0, 0 },
+    { TEMPLATE_VAR, "iface", 5, -1, 0, 0 },
+    { TEMPLATE_TEXT, " 2>/dev/null", 12, -1, 0, 0 },
+    { TEMPLATE_END, NULL, 0, -1, 0, 0 },
+};
+static const template_op _none_up_2[] = {
+    { TEMPLATE_OPEN, NULL, 0, -1, 0, 0 },
+    { TEMPLATE_TEXT, "ip link set ", 12, -1, 0, 0 },
+    { TEMPLATE_VAR, "iface0", 6, 3, 0, 0 },
+    { TEMPLATE_TEXT, " alias \"", 8, -1, 0, 0 },
+    { TEMPLATE_VAR, "description", 11, 0, 0, 0 },
+    { TEMPLATE_TEXT, "\"", 1, -1, 0, 0 },
+    { TEMPLATE_CLOSE, NULL, 0, -1, 0, 0 },
+    { TEMPLATE_END, NULL, 0, -1, 0, 0 },
+};
+static const command_op _none_up_ops[] = {
+	{ COMMAND_SHELL, 0, _none_up_if_0, false, _none_up_0, "if test -d /sys/class/net/%link% && \
+        ! ip link show %iface0% >/dev/null 2>&1; \
+    then \
+        if test `cat /sys/class/net/%link%/type` -eq 32; then \
+            echo 0x%vlan_id1% > /sys/class/net/%link%/create_child; \
+        else \
+            ip link set up dev %link%; \
+            ip link add link %link% name %iface0% type vlan id %vlan_id%; \
+	fi; \
+    fi" },
+	{ COMMAND_LINK_SET, 0, _none_up_if_1, false, _none_up_1, "-ip link set up dev %iface% 2>/dev/null" },
+	{ COMMAND_LINK_SET, 0, NULL, false, _none_up_2, "[[ip link set %iface0% alias \"%description%\"]]" },
+	{ COMMAND_END, 0, NULL, false, NULL, NULL }
+};
+static int _none_up(interface_defn *ifd, execfn *exec) {
+	return execute_ops(_none_up_ops, &_none_slots, ifd, exec);
+}
+static bool _none_down_if_0(interface_defn *ifd) { return iface_has(".") && !iface_has(":"); }
+static const template_op _none_down_0[] = {
+    { TEMPLATE_TEXT, "if test -d /sys/class/net/", 26, -1, 0, 0 },
+    { TEMPLATE_VAR, "link", 4, 1, 0, 0 },
+    { TEMPLATE_TEXT, "/device/infiniband; then         if test `cat /sys/class/net/", 61, -1, 0, 0 },
+    { TEMPLATE_VAR, "link", 4, 1, 0, 0 },
+    { TEMPLATE_TEXT, "/type` -eq 32; then             echo 0x", 39, -1, 0, 0 },
+    { TEMPLATE_VAR, "vlan_id1", 8, 4, 0, 0 },
+    { TEMPLATE_TEXT, " > /sys/class/net/", 18, -1, 0, 0 },
+    { TEMPLATE_VAR, "link", 4, 1, 0, 0 },
+    { TEMPLATE_TEXT, "/delete_child;         fi     else         ip link del ", 55, -1, 0, 0 },
+    { TEMPLATE_VAR, "iface", 5, -1, 0, 0 },
+    { TEMPLATE_TEXT, ";     fi", 8, -1, 0, 0 },
+    { TEMPLATE_END, NULL, 0, -1, 0, 0 },
+};
+static bool _none_down_if_1(interface_defn *ifd) { return iface_is_lo(); }
+static const template_op _none_down_1[] = {
+    { TEMPLATE_TEXT, "-ip link set down dev ", 22, -1, 0, 0 },
+    { TEMPLATE_VAR, "iface", 5, -1, 0, 0 },
+    { TEMPLATE_TEXT, " 2>/dev/null", 12, -1, 0, 0 },
+    { TEMPLATE_END, NULL, 0, -1, 0, 0 },
+};
+static const template_op _none_down_2[] = {
+    { TEMPLATE_OPEN, NULL, 0, -1, 0, 0 },
+    { TEMPLATE_TEXT, "-test -n \"", 10, -1, 0, 0 },
+    { TEMPLATE_VAR, "description", 11, 0, 0, 0 },
+    { TEMPLATE_TEXT, "\" && ip link set ", 17, -1, 0, 0 },
+    { TEMPLATE_VAR, "iface0", 6, 3, 0, 0 },
+    { TEMPLATE_TEXT, " alias \"\"", 9, -1, 0, 0 },
+    { TEMPLATE_CLOSE, NULL, 0, -1, 0, 0 },
+    { TEMPLATE_END, NULL, 0, -1, 0, 0 },
+};
+static const command_op _none_down_ops[] = {
+	{ COMMAND_SHELL, 0, _none_down_if_0, false, _none_down_0, "if test -d /sys/class/net/%link%/device/infiniband; then \
+        if test `cat /sys/class/net/%link%/type` -eq 32; then \
+            echo 0x%vlan_id1% > /sys/class/net/%link%/delete_child; \
+        fi \
+    else \
+        ip link del %iface%; \
+    fi" },
+	{ COMMAND_LINK_SET, 0, _none_down_if_1, false, _none_down_1, "-ip link set down dev %iface% 2>/dev/null" },
+	{ COMMAND_SHELL, 0, NULL, false, _none_down_2, "[[-test -n \"%description%\" && ip link set %iface0% alias \"\"]]" },
+	{ COMMAND_END, 0, NULL, false, NULL, NULL }
+};
+static int _none_down(interface_defn *ifd, execfn *exec) {
+	return execute_ops(_none_down_ops, &_none_slots, ifd, exec);
+}
+static const template_op _none_rename_0[] = {
+    { TEMPLATE_TEXT, "ip link set ", 12, -1, 0, 0 },
+    { TEMPLATE_VAR, "iface", 5, -1, 0, 0 },
+    { TEMPLATE_TEXT, " name ", 6, -1, 0, 0 },
+    { TEMPLATE_VAR, "newname", 7, -1, 0, 0 },
+    { TEMPLATE_END, NULL, 0, -1, 0, 0 },
+};
+static const command_op _none_rename_ops[] = {
+	{ COMMAND_LINK_SET, 0, NULL, false, _none_rename_0, "ip link set %iface% name %newname%" },
+	{ COMMAND_END, 0, NULL, false, NULL, NULL }
+};
+static int _none_rename(interface_defn *ifd, execfn *exec) {
+	return execute_ops(_none_rename_ops, &_none_slots, ifd, exec);
+}
+static method methods[] = {
+        {
+                "none",
+                _none_up, _none_down, _none_rename,
+                _none_conv, _none_default,
+                &_none_slots,
+                _none_up_ops, _none_down_ops, _none_rename_ops,
+        },
+};
+
+static const signed char method_slots[] = { 0 };
+
+address_family addr_link = {
+        "link",
+        sizeof(methods)/sizeof(struct method),
+        methods,
+        { 1, 0, method_slots }
+};
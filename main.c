@@ -16,6 +16,7 @@
 #include <err.h>
 #include <ifaddrs.h>
 #include <signal.h>
+#include <sys/wait.h>
 
 #include "archcommon.h"
 #include "header.h"
@@ -28,6 +29,8 @@ bool run_scripts = true;
 bool verbose = false;
 bool no_loopback = false;
 bool ignore_failures = false;
+bool skip_redundant = false;
+executor_type executor = EXECUTOR_SHELL;
 
 interfaces_file *defn;
 
@@ -35,6 +38,7 @@ static char *statedir;
 static char *lockfile;
 static char *statefile;
 static char *tmpstatefile;
+static char *cachefile;
 
 volatile bool interrupted = false;
 
@@ -69,6 +73,7 @@ static void help(int (*cmds) (interface_defn *)) {
 	if ((cmds == iface_list) || (cmds == iface_query)) {
 		printf("       %s <options> --list\n", argv0);
 		printf("       %s --state <ifaces...>\n", argv0);
+		printf("       %s --children <ifaces...>\n", argv0);
 	}
 
 	printf("\n"
@@ -95,11 +100,21 @@ static void help(int (*cmds) (interface_defn *)) {
 
 	if (!(cmds == iface_list) && !(cmds == iface_query))
 		printf(	"\t-f, --force            force de/configuration\n"
-			"\t--ignore-errors        ignore errors\n");
+			"\t--ignore-errors        ignore errors\n"
+			"\t-j, --jobs N           process up to N interfaces in parallel\n"
+			"\t--skip-redundant       don't repeat link and sysctl settings\n"
+			"\t--executor TYPE        how to run commands: \"shell\" (default)\n"
+#ifdef __linux__
+			"\t                       \"coproc\", \"netlink\" or \"batch\"\n"
+#else
+			"\t                       or \"coproc\"\n"
+#endif
+			);
 
 	if ((cmds == iface_list) || (cmds == iface_query))
 		printf(	"\t--list                 list all matching known interfaces\n"
-			"\t--state                show the state of specified interfaces\n");
+			"\t--state                show the state of specified interfaces\n"
+			"\t--children             list the VLAN interfaces of specified interfaces\n");
 
 	exit(0);
 }
@@ -386,6 +401,8 @@ static bool run_mappings = true;
 static bool force = false;
 static bool list = false;
 static bool state_query = false;
+static bool children_query = false;
+static int jobs = 1;
 char *allow_class = NULL;
 static char *interfaces = NULL;
 char **no_auto_down_int = NULL;
@@ -396,9 +413,8 @@ char **rename_int = NULL;
 int rename_ints = 0;
 static char **excludeint = NULL;
 static int excludeints = 0;
-static variable *option = NULL;
-static int n_options = 0;
-static int max_options = 0;
+/* The --option settings, kept like the options of a stanza */
+static interface_defn option_defn;
 static int n_target_ifaces;
 static char **target_iface;
 
@@ -444,13 +460,17 @@ static void parse_options(int *argc, char **argv[]) {
 		{"option", required_argument, NULL, 'o'},
 		{"list", no_argument, NULL, 'l'},
 		{"state", no_argument, NULL, 6},
+		{"children", no_argument, NULL, 12},
 		{"read-environment", no_argument, NULL, 8},
 		{"state-dir", required_argument, NULL, 9},
+		{"jobs", required_argument, NULL, 'j'},
+		{"executor", required_argument, NULL, 11},
+		{"skip-redundant", no_argument, NULL, 13},
 		{0, 0, 0, 0}
 	};
 
 	for (;;) {
-		int c = getopt_long(*argc, *argv, "X:s:i:o:hVvnalf", long_opts, NULL);
+		int c = getopt_long(*argc, *argv, "X:s:i:o:j:hVvnalf", long_opts, NULL);
 
 		if (c == EOF)
 			break;
@@ -500,7 +520,7 @@ static void parse_options(int *argc, char **argv[]) {
 				if (strcmp(name, "pre-down") == 0)
 					strcpy(name, "down");
 
-				set_variable(name, val, &option, &n_options, &max_options);
+				set_option(&option_defn, name, val);
 				free(name);
 
 				break;
@@ -564,10 +584,12 @@ static void parse_options(int *argc, char **argv[]) {
 			free(statefile);
 			free(tmpstatefile);
 			free(lockfile);
+			free(cachefile);
 			statedir = NULL;
 			statefile = NULL;
 			tmpstatefile = NULL;
 			lockfile = NULL;
+			cachefile = NULL;
 			if(asprintf(&statedir, "%s", optarg) == -1 || !statedir)
 				err(1, "asprintf");
 			if(asprintf(&statefile, "%s/ifstate", optarg) == -1 || !statefile)
@@ -576,12 +598,64 @@ static void parse_options(int *argc, char **argv[]) {
 				err(1, "asprintf");
 			if(asprintf(&lockfile, "%s/.ifstate.lock", optarg) == -1 || !lockfile)
 				err(1, "asprintf");
+			if(asprintf(&cachefile, "%s/.interfaces.cache", optarg) == -1 || !cachefile)
+				err(1, "asprintf");
 			break;
 
 		case 10: /* --no-act-commands */
 			no_act_commands = true;
 			break;
 
+		case 11: /* --executor */
+			if ((cmds == iface_list) || (cmds == iface_query))
+				usage();
+
+			if (strcmp(optarg, "shell") == 0)
+				executor = EXECUTOR_SHELL;
+			else if (strcmp(optarg, "coproc") == 0)
+				executor = EXECUTOR_COPROC;
+#ifdef __linux__
+			else if (strcmp(optarg, "netlink") == 0)
+				executor = EXECUTOR_NETLINK;
+			else if (strcmp(optarg, "batch") == 0)
+				executor = EXECUTOR_BATCH;
+#endif
+			else
+				errx(1, "unknown executor \"%s\"", optarg);
+			break;
+
+		case 12: /* --children */
+			if (cmds != iface_query)
+				usage();
+
+			children_query = true;
+			break;
+
+		case 13: /* --skip-redundant */
+			if ((cmds == iface_list) || (cmds == iface_query))
+				usage();
+
+			skip_redundant = true;
+			break;
+
+		case 'j': {
+			if ((cmds == iface_list) || (cmds == iface_query))
+				usage();
+
+			char *end;
+
+			errno = 0;
+			long n = strtol(optarg, &end, 10);
+
+			if (end == optarg || *end || errno || n < 1 || n > INT_MAX) {
+				warnx("invalid number of jobs \"%s\"", optarg);
+				usage();
+			}
+
+			jobs = n;
+			break;
+		}
+
 		default:
 			usage();
 			break;
@@ -626,17 +700,68 @@ static bool do_state(int n_target_ifaces, char *target_iface[]) {
 	return all_up;
 }
 
-/* Add string to a list if it is not a duplicate */
-static void append_to_list_nodup(char ***list, int *n, char *entry) {
-	for (int i = 0; i < *n; i++)
-		if (!strcmp((*list)[i], entry))
-			return;
+/* List the VLAN interfaces defined for the given parents. Return true if all of them have any */
+static bool do_children(int n_parents, char *parents[]) {
+	if (n_parents == 0) {
+		warnx("no interface(s) specified");
+		usage();
+	}
+
+	/* Only the names of the stanzas are needed */
+	defn = read_interfaces(interfaces, cachefile, true);
+
+	if (!defn)
+		errx(1, "couldn't read interfaces file \"%s\"", interfaces);
+
+	bool all_found = true;
+
+	for (int i = 0; i < n_parents; i++) {
+		interface_defn *ifd = find_vlans(defn, parents[i]);
+
+		if (!ifd)
+			all_found = false;
+
+		for (; ifd; ifd = ifd->next_vlan)
+			puts(ifd->logical_iface);
+	}
+
+	return all_found;
+}
+
+/* Add string to a list if it is not a duplicate; seen holds the entries so far */
+static void append_to_list_nodup(char ***list, int *n, char *entry, hash_table *seen) {
+	if (hash_get(seen, entry, strlen(entry)))
+		return;
+
+	hash_set(seen, entry, entry);
 
 	(*n)++;
 	*list = realloc(*list, *n * sizeof **list);
 	(*list)[*n - 1] = entry;
 }
 
+/* Like append_to_list_nodup(), but with a range of names written out */
+static void append_range(char ***list, int *n, char *entry, hash_table *seen) {
+	name_range range;
+
+	if (!parse_range(entry, &range)) {
+		append_to_list_nodup(list, n, entry, seen);
+		return;
+	}
+
+	if (range.last - range.first >= MAX_RANGE_NAMES)
+		errx(1, "range with more than %d names: %s", MAX_RANGE_NAMES, entry);
+
+	for (long i = range.first; i <= range.last; i++) {
+		char *name = range_name(entry, &range, i);
+
+		if (hash_get(seen, name, strlen(name)))
+			free(name);
+		else
+			append_to_list_nodup(list, n, name, seen);
+	}
+}
+
 struct ifaddrs *ifap = NULL;
 
 /* Check if an interface name is actually pattern */
@@ -657,11 +782,12 @@ static bool is_pattern(const char *name) {
 static void expand_matches(int *argc, char ***argv) {
 	char **exp_iface = NULL;
 	int n_exp_ifaces = 0;
+	hash_table seen = { NULL, 0, 0 };
 
 	for (int i = 0; i < *argc; i++) {
 		// Interface names not containing a slash are taken over literally.
 		if (!is_pattern((*argv)[i])) {
-			append_to_list_nodup(&exp_iface, &n_exp_ifaces, (*argv)[i]);
+			append_range(&exp_iface, &n_exp_ifaces, (*argv)[i], &seen);
 			continue;
 		}
 
@@ -722,10 +848,12 @@ static void expand_matches(int *argc, char ***argv) {
 				exp = ifa->ifa_name;
 			}
 
-			append_to_list_nodup(&exp_iface, &n_exp_ifaces, exp);
+			append_to_list_nodup(&exp_iface, &n_exp_ifaces, exp, &seen);
 		}
 	}
 
+	hash_clear(&seen);
+
 	*argv = exp_iface;
 	*argc = n_exp_ifaces;
 }
@@ -793,10 +921,11 @@ static void do_rename(void) {
 			.option = &option,
 		};
 
-		if (!addr_link.method[0].rename(&ifd, doit)) {
+		if (!addr_link.method[0].rename(&ifd, doit) || !flush_commands()) {
 			errx(1, "unable to rename %s to %s", rename_int[i], logical);
 		}
 
+		clear_option_index(&ifd);
 		logical[-1] = '=';
 		renamed_ints++;
 	}
@@ -806,6 +935,124 @@ static void do_rename(void) {
 }
 
 
+/*
+ * Append the VLANs in an allow class whose parent is a target, after all
+ * targets, grouped by parent in target order and otherwise in class order.
+ */
+static void add_vlans(allowup_defn *allowups) {
+	int n = n_target_ifaces;
+	int n_interfaces = 0;
+	char **interfaces = NULL;
+	hash_table parents = { NULL, 0, 0 };
+	hash_table seen = { NULL, 0, 0 };
+
+	for (int j = 0; j < allowups->n_interfaces; j++)
+		append_range(&interfaces, &n_interfaces, allowups->interfaces[j], &seen);
+
+	hash_clear(&seen);
+
+	int *first = malloc(n * sizeof *first);
+	int *next = malloc(n_interfaces * sizeof *next);
+
+	if (!first || (n_interfaces && !next))
+		err(1, "malloc");
+
+	for (int i = 0; i < n; i++) {
+		first[i] = -1;
+		hash_set(&seen, target_iface[i], target_iface[i]);
+
+		if (!vlan_parent_len(target_iface[i]) && !hash_get(&parents, target_iface[i], strlen(target_iface[i])))
+			hash_set(&parents, target_iface[i], (void *)(intptr_t)(i + 1));
+	}
+
+	for (int j = n_interfaces - 1; j >= 0; j--) {
+		size_t len = vlan_parent_len(interfaces[j]);
+		if (!len)
+			continue;
+
+		int i = (intptr_t)hash_get(&parents, interfaces[j], len) - 1;
+		if (i < 0)
+			continue;
+
+		next[j] = first[i];
+		first[i] = j;
+	}
+
+	for (int i = 0; i < n; i++)
+		for (int j = first[i]; j != -1; j = next[j])
+			append_to_list_nodup(&target_iface, &n_target_ifaces, interfaces[j], &seen);
+
+	hash_clear(&parents);
+	hash_clear(&seen);
+	free(interfaces);
+	free(first);
+	free(next);
+}
+
+/* The interfaces in the --allow class, with patterns expanded and logical names removed */
+static hash_table allowed_ifaces;
+
+/* The entries of the --allow class with a range, which are not written out */
+static char **allowed_ranges;
+static int n_allowed_ranges;
+
+static void expand_allow_class(void) {
+	allowup_defn *allowup = find_allowup(defn, allow_class);
+
+	if (allowup == NULL) // empty class
+		return;
+
+	char **interfaces = NULL;
+	int n_interfaces = 0;
+
+	for (int i = 0; i < allowup->n_interfaces; i++) {
+		char *entry = allowup->interfaces[i];
+		name_range range;
+
+		/* a name with a range is also kept as it is, as before ranges existed */
+		if (!is_pattern(entry) && parse_range(entry, &range)) {
+			char *name = strndup(entry, strcspn(entry, "="));
+			if (!name)
+				err(1, "strndup");
+
+			allowed_ranges = realloc(allowed_ranges, (n_allowed_ranges + 1) * sizeof *allowed_ranges);
+			if (!allowed_ranges)
+				err(1, "realloc");
+
+			allowed_ranges[n_allowed_ranges++] = name;
+
+			if (!hash_get(&allowed_ifaces, name, strlen(name)))
+				hash_set(&allowed_ifaces, name, name);
+
+			continue;
+		}
+
+		interfaces = realloc(interfaces, (n_interfaces + 1) * sizeof *interfaces);
+		if (!interfaces)
+			err(1, "realloc");
+
+		interfaces[n_interfaces++] = entry;
+	}
+
+	char **patterns = interfaces;
+	expand_matches(&n_interfaces, &interfaces);
+	free(patterns);
+
+	for (int i = 0; i < n_interfaces; i++) {
+		size_t len = strcspn(interfaces[i], "=");
+
+		if (!hash_get(&allowed_ifaces, interfaces[i], len)) {
+			char *name = strndup(interfaces[i], len);
+			if (!name)
+				err(1, "strndup");
+
+			hash_set(&allowed_ifaces, name, name);
+		}
+	}
+
+	free(interfaces);
+}
+
 /* Check non-option arguments and build a list of interfaces to act upon */
 static void select_interfaces(int argc, char *argv[]) {
 	if (argc > 0 && (do_all)) {
@@ -821,7 +1068,8 @@ static void select_interfaces(int argc, char *argv[]) {
 	if (do_all && (cmds == iface_query))
 		usage();
 
-	defn = read_interfaces(interfaces);
+	/* Runs for a few named interfaces only parse the stanzas they use */
+	defn = read_interfaces(interfaces, cachefile, argc > 0);
 
 	if (!defn)
 		errx(1, "couldn't read interfaces file \"%s\"", interfaces);
@@ -876,19 +1124,12 @@ static void select_interfaces(int argc, char *argv[]) {
 	/* Bring up VLAN interfaces in the same allow class */
 	if (n_target_ifaces && cmds == iface_up && allow_class) {
 		allowup_defn *allowups = find_allowup(defn, allow_class);
-		if (allowups) {
-			int n = n_target_ifaces;
-			for (int i = 0; i < n; i++) {
-				if (strchr(target_iface[i], '.'))
-					continue;
-				int len = strlen(target_iface[i]);
-				for (int j = 0; j < allowups->n_interfaces; j++) {
-					if (!strncmp(target_iface[i], allowups->interfaces[j], len) && allowups->interfaces[j][len] == '.')
-						append_to_list_nodup(&target_iface, &n_target_ifaces, allowups->interfaces[j]);
-				}
-			}
-		}
+		if (allowups)
+			add_vlans(allowups);
 	}
+
+	if (allow_class)
+		expand_allow_class();
 }
 
 static interface_defn meta_iface = {
@@ -931,12 +1172,25 @@ static void do_post_all(void) {
 		errx(1, "post-%s script failed", cmds == iface_up ? "up" : "down");
 }
 
-bool match_patterns(const char *string, int argc, char *argv[]) {
-	if (!argc || !argv || !string)
-		return false;
+static matcher excludes;
+static matcher no_auto_down;
+
+/* Return the first mapping that applies to the given logical interface, starting at map */
+static mapping_defn *find_mapping(mapping_defn *map, const char *liface) {
+	for (; map; map = map->next)
+		if (matcher_match(&map->compiled, liface, map->n_matches, map->match))
+			return map;
+
+	return NULL;
+}
 
-	for (int i = 0; i < argc; i++)
-		if (fnmatch(argv[i], string, 0) == 0)
+/* Returns true if iface is in the --allow class */
+static bool is_allowed(const char *iface) {
+	if (hash_get(&allowed_ifaces, iface, strlen(iface)))
+		return true;
+
+	for (int i = 0; i < n_allowed_ranges; i++)
+		if (in_range(allowed_ranges[i], iface))
 			return true;
 
 	return false;
@@ -945,41 +1199,16 @@ bool match_patterns(const char *string, int argc, char *argv[]) {
 /* Check whether we should ignore the given interface */
 static bool ignore_interface(const char *iface) {
 	/* If --allow is used, ignore interfaces that are not in the given class */
-	if (allow_class != NULL) {
-		allowup_defn *allowup = find_allowup(defn, allow_class);
-
-		if (allowup == NULL) // empty class
-			return true;
-
-		bool found = false;
-
-		char **interfaces = allowup->interfaces;
-		int n_interfaces = allowup->n_interfaces;
-		expand_matches(&n_interfaces, &interfaces);
-
-		for (int i = 0; i < n_interfaces; i++) {
-			char *logical = strchr(interfaces[i], '=');
-			if (logical)
-				*logical++ = 0;
-			if (strcmp(interfaces[i], iface) == 0) {
-				found = true;
-				break;
-			}
-		}
-
-		free(interfaces);
-
-		if (!found)
-			return true;
-	}
+	if (allow_class != NULL && !is_allowed(iface))
+		return true;
 
 	/* Ignore interfaces specified with --exclude */
-	if ((excludeints != 0 && match_patterns(iface, excludeints, excludeint)))
+	if (excludeints != 0 && matcher_match(&excludes, iface, excludeints, excludeint))
 		return true;
 
 	/* Ignore no-auto-down interfaces during ifdown -a */
 	if(do_all && cmds == iface_down) {
-		if (no_auto_down_ints && match_patterns(iface, no_auto_down_ints, no_auto_down_int))
+		if (no_auto_down_ints && matcher_match(&no_auto_down, iface, no_auto_down_ints, no_auto_down_int))
 			return true;
 	}
 
@@ -1017,25 +1246,10 @@ static bool do_interface(const char *target_iface, char *parent_state) {
 
 	/* Check if this interface exists */
 
-	bool found = false;
-
-	for (interface_defn *currif = defn->ifaces; currif; currif = currif->next) {
-		if (strcmp(liface, currif->logical_iface) == 0) {
-			found = true;
-			break;
-		}
-	}
+	bool found = find_interface(defn, liface) != NULL;
 
-	if (!found) {
-		for (mapping_defn *currmap = defn->mappings; currmap; currmap = currmap->next) {
-			for (int i = 0; i < currmap->n_matches; i++) {
-				if (fnmatch(currmap->match[i], liface, 0) == 0) {
-					found = true;
-					break;
-				}
-			}
-		}
-	}
+	if (!found)
+		found = find_mapping(defn->mappings, liface) != NULL;
 
 	if (cmds != iface_up) {
 		char *filename = ifacestatefile(iface);
@@ -1070,11 +1284,11 @@ static bool do_interface(const char *target_iface, char *parent_state) {
 
 	char piface[80];
 	FILE *plock = NULL;
+	size_t parent_len = vlan_parent_len(iface);
 	strncpy(piface, iface, sizeof piface);
-	pch = strchr(piface, '.');
+	piface[parent_len] = '\0';
 
-	if (pch && !parent_state && do_interface_lock) {
-		*pch = '\0';
+	if (parent_len && !parent_state && do_interface_lock) {
 		char envname[160];
 		snprintf(envname, sizeof envname, "IFUPDOWN_%s", piface);
 		sanitize_env_name(envname + 9);
@@ -1124,16 +1338,9 @@ static bool do_interface(const char *target_iface, char *parent_state) {
 
 	/* Are we the parent of one or more VLAN interfaces? */
 
-	if (!pch && !parent_state && cmds == iface_down) {
-		size_t namelen = strlen(iface);
-
-		for (struct interface_defn *ifd = defn->ifaces; ifd; ifd = ifd->next) {
-			if (strncmp(iface, ifd->logical_iface, namelen) || ifd->logical_iface[namelen] != '.')
-				continue;
-
+	if (!parent_len && !parent_state && cmds == iface_down)
+		for (interface_defn *ifd = find_vlans(defn, iface); ifd; ifd = ifd->next_vlan)
 			do_interface(ifd->logical_iface, "");
-		}
-	}
 
 	/* If we are not forcing the command, then exit with success if it is a no-op */
 
@@ -1173,27 +1380,20 @@ static bool do_interface(const char *target_iface, char *parent_state) {
 	bool have_mapping = false;
 
 	if (((cmds == iface_up) && run_mappings) || (cmds == iface_query)) {
-		for (mapping_defn *currmap = defn->mappings; currmap; currmap = currmap->next) {
-			for (int i = 0; i < currmap->n_matches; i++) {
-				if (fnmatch(currmap->match[i], liface, 0) != 0)
-					continue;
-
-				if ((cmds == iface_query) && !run_mappings) {
-					if (verbose)
-						warnx("not running mapping scripts for %s", liface);
-
-					have_mapping = true;
-					break;
-				}
-
+		for (mapping_defn *currmap = find_mapping(defn->mappings, liface); currmap; currmap = find_mapping(currmap->next, liface)) {
+			if ((cmds == iface_query) && !run_mappings) {
 				if (verbose)
-					warnx("running mapping script %s on %s", currmap->script, liface);
+					warnx("not running mapping scripts for %s", liface);
 
-				if(!run_mapping(iface, liface, sizeof(liface), currmap))
-					goto end;
-
-				break;
+				have_mapping = true;
+				continue;
 			}
+
+			if (verbose)
+				warnx("running mapping script %s on %s", currmap->script, liface);
+
+			if(!run_mapping(iface, liface, sizeof(liface), currmap))
+				goto end;
 		}
 	}
 
@@ -1213,23 +1413,10 @@ static bool do_interface(const char *target_iface, char *parent_state) {
 	/* Handle ifquery --list */
 
 	if (cmds == iface_list) {
-		for (interface_defn *currif = defn->ifaces; currif; currif = currif->next)
-			if (strcmp(liface, currif->logical_iface) == 0)
-				okay = true;
-
-		if (!okay) {
-			mapping_defn *currmap;
+		okay = find_interface(defn, liface) != NULL;
 
-			for (currmap = defn->mappings; currmap; currmap = currmap->next) {
-				for (int i = 0; i < currmap->n_matches; i++) {
-					if (fnmatch(currmap->match[i], liface, 0) != 0)
-						continue;
-
-					okay = true;
-					break;
-				}
-			}
-		}
+		if (!okay)
+			okay = find_mapping(defn->mappings, liface) != NULL;
 
 		if (okay) {
 			interface_defn *currif = defn->ifaces;
@@ -1244,137 +1431,126 @@ static bool do_interface(const char *target_iface, char *parent_state) {
 
 	/* Run the desired command for all matching logical interfaces */
 
-	for (interface_defn *currif = defn->ifaces; currif; currif = currif->next) {
-		if (strcmp(liface, currif->logical_iface) == 0) {
-			/* Bring the link up if necessary, but only once for each physical interface */
-			if (!okay && (cmds == iface_up)) {
-				interface_defn link = {
-					.real_iface = iface,
-					.logical_iface = liface,
-					.max_options = 0,
-					.address_family = &addr_link,
-					.method = &(addr_link.method[0]),
-					.n_options = 0,
-					.option = NULL
-				};
-
-				convert_variables(link.method->conversions, &link);
-
-				for (option_default *o = addr_link.method[0].defaults; o && o->option && o->value; o++) {
-					for (int j = 0; j < currif->n_options; j++) {
-						if (strcmp(currif->option[j].name, o->option) == 0) {
-							set_variable(o->option, currif->option[j].value, &link.option, &link.n_options, &link.max_options);
-							break;
-						}
-					}
-				}
+	for (interface_defn *currif = find_interface(defn, liface); currif; currif = currif->next_same) {
+		resolve_options(currif);
 
-				if (!link.method->up(&link, doit))
-					break;
+		/* Bring the link up if necessary, but only once for each physical interface */
+		if (!okay && (cmds == iface_up)) {
+			interface_defn link = {
+				.real_iface = iface,
+				.logical_iface = liface,
+				.max_options = 0,
+				.address_family = &addr_link,
+				.method = &(addr_link.method[0]),
+				.n_options = 0,
+				.option = NULL
+			};
 
-				for (int i = 0; i < link.n_options; i++) {
-					free(link.option[i].name);
-					free(link.option[i].value);
-				}
+			convert_variables(link.method, &link);
+
+			for (option_default *o = addr_link.method[0].defaults; o && o->option && o->value; o++) {
+				int j = find_option(currif, o->option, strlen(o->option));
 
-				if (link.option)
-					free(link.option);
+				if (j != -1)
+					set_option(&link, o->option, currif->option[j].value);
 			}
 
-			okay = true;
+			bool linked = link.method->up(&link, doit) && flush_commands();
 
-			for (option_default *o = currif->method->defaults; o && o->option && o->value; o++) {
-				bool found = false;
+			for (int i = 0; i < link.n_options; i++)
+				release_string(link.option[i].value);
 
-				for (int j = 0; j < currif->n_options; j++) {
-					if (strcmp(currif->option[j].name, o->option) == 0) {
-						found = true;
-						break;
-					}
-				}
+			if (link.option)
+				free(link.option);
 
-				if (!found)
-					set_variable(o->option, o->value, &currif->option, &currif->n_options, &currif->max_options);
-			}
+			clear_option_index(&link);
 
-			for (int i = 0; i < n_options; i++) {
-				if (option[i].value[0] == '\0') {
-					if (strcmp(option[i].name, "pre-up") != 0 && strcmp(option[i].name, "up") != 0 && strcmp(option[i].name, "down") != 0 && strcmp(option[i].name, "post-down") != 0) {
-						int j;
-
-						for (j = 0; j < currif->n_options; j++) {
-							if (strcmp(currif->option[j].name, option[i].name) == 0) {
-								currif->n_options--;
-								break;
-							}
-						}
-
-						for (; j < currif->n_options; j++) {
-							option[j].name = option[j + 1].name;
-							option[j].value = option[j + 1].value;
-						}
-					} else {
-						/* do nothing */
-					}
-				} else {
-					set_variable(option[i].name, option[i].value, &currif->option, &currif->n_options, &currif->max_options);
-				}
-			}
+			if (!linked)
+				break;
+		}
 
-			currif->real_iface = iface;
+		okay = true;
 
-			convert_variables(currif->method->conversions, currif);
+		currif->real_iface = iface;
 
-			if (verbose)
-				warnx("%s interface %s=%s (%s)", (cmds == iface_query) ? "querying" : "configuring", iface, liface, currif->address_family->name);
+		/* A stanza that is used again, as with --force, keeps its converted options */
+		const char *prepared_for = intern(iface, strlen(iface));
+
+		if (currif->prepared_for != prepared_for) {
+			currif->prepared_for = prepared_for;
 
-			char *pidfilename = make_pidfile_name(argv0, currif);
+			for (option_default *o = currif->method->defaults; o && o->option && o->value; o++)
+				if (find_option(currif, o->option, strlen(o->option)) == -1)
+					set_option(currif, o->option, o->value);
 
-			if (!no_act) {
-				FILE *pidfile = fopen(pidfilename, "w");
+			for (int i = 0; i < option_defn.n_options; i++) {
+				variable *option = &option_defn.option[i];
 
-				if (pidfile) {
-					fprintf(pidfile, "%d", getpid());
-					fclose(pidfile);
+				if (option->value[0] == '\0') {
+					/* An empty value removes the option, unless it is one of the command lists */
+					if (!multi_valued(option->name)) {
+						int j = find_option(currif, option->name, strlen(option->name));
+
+						if (j != -1)
+							remove_option(currif, j);
+					}
 				} else {
-					warn("failed to open pid file %s", pidfilename);
+					set_option(currif, option->name, option->value);
 				}
 			}
 
-			switch (cmds(currif)) {
-			case -1:
-				warnx("missing required configuration variables for interface %s/%s", liface, currif->address_family->name);
-				failed = true;
-				break;
+			convert_variables(currif->method, currif);
+		}
 
-			case 0:
-				failed = true;
-				break;
-				/* not entirely successful */
+		if (verbose)
+			warnx("%s interface %s=%s (%s)", (cmds == iface_query) ? "querying" : "configuring", iface, liface, currif->address_family->name);
 
-			case 1:
-				failed = false;
-				break;
-				/* successful */
+		char *pidfilename = make_pidfile_name(argv0, currif);
 
-			default:
-				warnx("unexpected value when configuring interface %s/%s; considering it failed", liface, currif->address_family->name);
-				failed = true;
-				/* what happened here? */
-			}
+		if (!no_act) {
+			FILE *pidfile = fopen(pidfilename, "w");
 
-			if (!no_act)
-				unlink(pidfilename);
+			if (pidfile) {
+				fprintf(pidfile, "%d", getpid());
+				fclose(pidfile);
+			} else {
+				warn("failed to open pid file %s", pidfilename);
+			}
+		}
 
-			free(pidfilename);
+		switch (cmds(currif)) {
+		case -1:
+			warnx("missing required configuration variables for interface %s/%s", liface, currif->address_family->name);
+			failed = true;
+			break;
 
-			currif->real_iface = NULL;
+		case 0:
+			failed = true;
+			break;
+			/* not entirely successful */
 
-			if (failed)
-				break;
+		case 1:
+			failed = false;
+			break;
+			/* successful */
 
-			/* Otherwise keep going: this interface may have match with other address families */
+		default:
+			warnx("unexpected value when configuring interface %s/%s; considering it failed", liface, currif->address_family->name);
+			failed = true;
+			/* what happened here? */
 		}
+
+		if (!no_act)
+			unlink(pidfilename);
+
+		free(pidfilename);
+
+		currif->real_iface = NULL;
+
+		if (failed)
+			break;
+
+		/* Otherwise keep going: this interface may have match with other address families */
 	}
 
 	/* Bring the link down if necessary */
@@ -1389,12 +1565,13 @@ static bool do_interface(const char *target_iface, char *parent_state) {
 			.n_options = 0,
 			.option = NULL
 		};
-		convert_variables(link.method->conversions, &link);
+		convert_variables(link.method, &link);
 
-		if (!link.method->down(&link, doit))
+		if (!link.method->down(&link, doit) || !flush_commands())
 			goto end;
 		if (link.option)
 			free(link.option);
+		clear_option_index(&link);
 	}
 
 	if (!okay && (cmds == iface_query)) {
@@ -1445,6 +1622,505 @@ end:
 	return success;
 }
 
+/* Parallel processing of target interfaces (--jobs) */
+
+struct job {
+	const char *target;
+	char physical[80];
+	size_t parent_len;	/* length of the VLAN parent name, if any */
+	pid_t pid;
+	FILE *out;		/* open while the job runs */
+	FILE *err;
+	struct output {
+		char *buf;	/* read in once the job is done */
+		size_t len;
+	} output[2];
+	int n_deps;		/* number of unfinished jobs this one waits for */
+	int n_dependents;
+	int *dependents;
+	int rank;		/* position in the equivalent serial run */
+	bool started;
+	bool done;
+	bool success;
+};
+
+static struct job *jobv;
+static int *jobs_by_name;
+
+static int compare_jobs(const void *a, const void *b) {
+	int l = *(const int *)a;
+	int r = *(const int *)b;
+	int i = strcmp(jobv[l].physical, jobv[r].physical);
+
+	return i ? i : l - r;
+}
+
+/* Return the position in jobs_by_name of the first job for the given physical interface, or -1 */
+static int find_job(const char *physical, size_t len) {
+	int lo = 0, hi = n_target_ifaces;
+
+	while (lo < hi) {
+		int mid = (lo + hi) / 2;
+
+		if (strncmpz(physical, jobv[jobs_by_name[mid]].physical, len) > 0)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+
+	if (lo < n_target_ifaces && strncmpz(physical, jobv[jobs_by_name[lo]].physical, len) == 0)
+		return lo;
+
+	return -1;
+}
+
+static int compare_siblings(const void *a, const void *b) {
+	int l = *(const int *)a;
+	int r = *(const int *)b;
+	size_t len = jobv[l].parent_len < jobv[r].parent_len ? jobv[l].parent_len : jobv[r].parent_len;
+	int i = strncmp(jobv[l].physical, jobv[r].physical, len);
+
+	if (!i)
+		i = (int)jobv[l].parent_len - (int)jobv[r].parent_len;
+
+	return i ? i : l - r;
+}
+
+static void add_dependency(int before, int after) {
+	struct job *job = &jobv[before];
+
+	job->dependents = realloc(job->dependents, (job->n_dependents + 1) * sizeof *job->dependents);
+	if (!job->dependents)
+		err(1, "realloc");
+
+	job->dependents[job->n_dependents++] = after;
+	jobv[after].n_deps++;
+}
+
+/* Give a job its rank after those of the jobs it waits for, lowest in list order first */
+static void rank_job(int i, const int *first, const int *before, int *rank) {
+	if (jobv[i].rank != -1)
+		return;
+
+	jobv[i].rank = -2;	/* being ranked */
+
+	for (int k = first[i]; k < first[i + 1]; k++)
+		rank_job(before[k], first, before, rank);
+
+	jobv[i].rank = (*rank)++;
+}
+
+/*
+ * Build the dependency graph: a VLAN interface is brought up after its
+ * parent and taken down before it. Multiple entries for the same physical
+ * interface, and VLANs sharing a parent (which each hold the parent's lock
+ * while being configured), are processed in list order.
+ */
+static void build_job_graph(void) {
+	for (int i = 0; i < n_target_ifaces; i++) {
+		jobv[i].target = target_iface[i];
+		strncpy(jobv[i].physical, target_iface[i], sizeof jobv[i].physical);
+		jobv[i].physical[sizeof jobv[i].physical - 1] = '\0';
+		jobv[i].physical[strcspn(jobv[i].physical, "=")] = '\0';
+		jobv[i].parent_len = vlan_parent_len(jobv[i].physical);
+		jobs_by_name[i] = i;
+	}
+
+	int *siblings = malloc(n_target_ifaces * sizeof *siblings);
+	int n_siblings = 0;
+	if (!siblings)
+		err(1, "malloc");
+
+	for (int i = 0; i < n_target_ifaces; i++)
+		if (jobv[i].parent_len)
+			siblings[n_siblings++] = i;
+
+	qsort(siblings, n_siblings, sizeof *siblings, compare_siblings);
+
+	for (int k = 1; k < n_siblings; k++) {
+		struct job *l = &jobv[siblings[k - 1]];
+		struct job *r = &jobv[siblings[k]];
+
+		if (l->parent_len == r->parent_len && !strncmp(l->physical, r->physical, l->parent_len))
+			add_dependency(siblings[k - 1], siblings[k]);
+	}
+
+	free(siblings);
+
+	qsort(jobs_by_name, n_target_ifaces, sizeof *jobs_by_name, compare_jobs);
+
+	for (int k = 1; k < n_target_ifaces; k++)
+		if (!strcmp(jobv[jobs_by_name[k - 1]].physical, jobv[jobs_by_name[k]].physical))
+			add_dependency(jobs_by_name[k - 1], jobs_by_name[k]);
+
+	for (int i = 0; i < n_target_ifaces; i++) {
+		size_t len = jobv[i].parent_len;
+		if (!len)
+			continue;
+
+		for (int k = find_job(jobv[i].physical, len); k >= 0 && k < n_target_ifaces; k++) {
+			int parent = jobs_by_name[k];
+
+			if (strncmpz(jobv[i].physical, jobv[parent].physical, len))
+				break;
+
+			if (cmds == iface_down)
+				add_dependency(i, parent);
+			else
+				add_dependency(parent, i);
+		}
+	}
+
+	/*
+	 * A serial run processes the interfaces in list order, and brings a
+	 * VLAN's parent up, or its VLANs down, when it gets to the interface
+	 * that needs this, even if they come later in the list.
+	 */
+	int *first = calloc(n_target_ifaces + 1, sizeof *first);
+	if (!first)
+		err(1, "calloc");
+
+	for (int i = 0; i < n_target_ifaces; i++)
+		for (int d = 0; d < jobv[i].n_dependents; d++)
+			first[jobv[i].dependents[d] + 1]++;
+
+	for (int i = 0; i < n_target_ifaces; i++)
+		first[i + 1] += first[i];
+
+	/* before[first[i]] to before[first[i + 1] - 1] are the jobs job i waits for */
+	int *before = malloc((first[n_target_ifaces] + 1) * sizeof *before);
+	int *fill = malloc((n_target_ifaces + 1) * sizeof *fill);
+	if (!before || !fill)
+		err(1, "malloc");
+
+	memcpy(fill, first, n_target_ifaces * sizeof *fill);
+
+	for (int i = 0; i < n_target_ifaces; i++)
+		for (int d = 0; d < jobv[i].n_dependents; d++)
+			before[fill[jobv[i].dependents[d]]++] = i;
+
+	int rank = 0;
+
+	for (int i = 0; i < n_target_ifaces; i++)
+		jobv[i].rank = -1;
+
+	for (int i = 0; i < n_target_ifaces; i++)
+		rank_job(i, first, before, &rank);
+
+	free(fill);
+	free(before);
+	free(first);
+}
+
+/* Returns false if the files for the output of the job cannot be created */
+static bool start_job(struct job *job) {
+	job->out = tmpfile();
+	job->err = tmpfile();
+
+	if (!job->out || !job->err) {
+		if (job->out)
+			fclose(job->out);
+
+		if (job->err)
+			fclose(job->err);
+
+		return false;
+	}
+
+	fflush(NULL);
+
+	switch (job->pid = fork()) {
+	case -1:	/* failure */
+		err(1, "fork");
+
+	case 0:	/* child */
+		dup2(fileno(job->out), 1);
+		dup2(fileno(job->err), 2);
+
+		/* the files of the other running jobs are no business of this one */
+		for (int i = 0; i < n_target_ifaces; i++) {
+			if (jobv[i].started && !jobv[i].done) {
+				fclose(jobv[i].out);
+				fclose(jobv[i].err);
+			}
+		}
+
+		fclose(job->out);
+		fclose(job->err);
+
+		bool success = do_interface(job->target, NULL);
+
+		report_skipped_commands();
+		exit(success ? 0 : 1);
+
+	default:	/* parent */
+		break;
+	}
+
+	job->started = true;
+
+	return true;
+}
+
+/*
+ * Read the output of a job that is done, and close the file, so that jobs
+ * waiting for their turn to print do not keep files open.
+ */
+static void read_output(FILE *from, struct output *output) {
+	char buf[4096];
+	size_t len;
+	FILE *to = open_memstream(&output->buf, &output->len);
+
+	if (!to)
+		err(1, "open_memstream");
+
+	rewind(from);
+
+	while ((len = fread(buf, 1, sizeof buf, from)) > 0)
+		fwrite(buf, 1, len, to);
+
+	fclose(to);
+	fclose(from);
+}
+
+static void write_output(struct output *output, FILE *to) {
+	fwrite(output->buf, 1, output->len, to);
+	fflush(to);
+	free(output->buf);
+}
+
+static int compare_strings(const void *a, const void *b) {
+	return strcmp(*(char * const *)a, *(char * const *)b);
+}
+
+static int state_rank(const char *line, char **old_state, int n_old_state) {
+	size_t len = strcspn(line, "=");
+	char *name = strndupa(line, len);
+
+	if (bsearch(&name, old_state, n_old_state, sizeof *old_state, compare_strings))
+		return -1;
+
+	int k = find_job(line, len);
+
+	if (k >= 0)
+		return jobv[jobs_by_name[k]].rank * 2 + 1;
+
+	/* A VLAN parent that was brought up implicitly goes right before its first child */
+	int rank = -1;
+
+	for (int i = 0; i < n_target_ifaces; i++)
+		if (!strncmp(line, jobv[i].physical, len) && jobv[i].physical[len] == '.')
+			if (rank == -1 || jobv[i].rank * 2 < rank)
+				rank = jobv[i].rank * 2;
+
+	return rank;
+}
+
+/*
+ * Jobs add their entries to the state file in whatever order they happen
+ * to start. Put the entries added during this run in the order a serial
+ * run would have produced, so that ifdown -a behaves the same either way.
+ */
+static void reorder_state(char **old_state, int n_old_state) {
+	if (no_act)
+		return;
+
+	FILE *lock_fp = lock_state();
+	FILE *state_fp = fopen(statefile, "re");
+	char **lines = NULL;
+	int *ranks = NULL;
+	int n_lines = 0;
+
+	if (state_fp == NULL)
+		goto end;
+
+	for (int i = 0; i < n_old_state; i++)
+		old_state[i][strcspn(old_state[i], "=")] = '\0';
+
+	qsort(old_state, n_old_state, sizeof *old_state, compare_strings);
+
+	char buf[80];
+
+	while (fgets(buf, sizeof buf, state_fp) != NULL) {
+		lines = realloc(lines, (n_lines + 1) * sizeof *lines);
+		ranks = realloc(ranks, (n_lines + 1) * sizeof *ranks);
+		if (!lines || !ranks)
+			err(1, "realloc");
+
+		lines[n_lines] = strdup(strip(buf));
+		if (!lines[n_lines])
+			err(1, "strdup");
+
+		ranks[n_lines] = state_rank(lines[n_lines], old_state, n_old_state);
+		n_lines++;
+	}
+
+	/* Insertion sort of the new entries, leaving the others in place */
+	for (int i = 0; i < n_lines; i++) {
+		if (ranks[i] < 0)
+			continue;
+
+		for (int j = i + 1; j < n_lines; j++) {
+			if (ranks[j] < 0 || ranks[j] >= ranks[i])
+				continue;
+
+			char *line = lines[i];
+			int rank = ranks[i];
+
+			lines[i] = lines[j];
+			ranks[i] = ranks[j];
+			lines[j] = line;
+			ranks[j] = rank;
+		}
+	}
+
+	FILE *tmp_fp = fopen(tmpstatefile, "w");
+
+	if (tmp_fp == NULL)
+		err(1, "failed to open temporary statefile %s", tmpstatefile);
+
+	for (int i = 0; i < n_lines; i++) {
+		fprintf(tmp_fp, "%s\n", lines[i]);
+		free(lines[i]);
+	}
+
+	fclose(tmp_fp);
+
+	if (rename(tmpstatefile, statefile))
+		err(1, "failed to overwrite statefile %s", statefile);
+
+end:
+	free(lines);
+	free(ranks);
+
+	if (state_fp)
+		fclose(state_fp);
+
+	if (lock_fp)
+		fclose(lock_fp);
+}
+
+/*
+ * Process all target interfaces using up to the given number of concurrent
+ * jobs. Each job runs in its own process, with its output collected and
+ * written out in list order once it finishes.
+ */
+static bool do_interfaces_parallel(void) {
+	bool success = true;
+	char **old_state = NULL;
+	int n_old_state = 0;
+
+	jobv = calloc(n_target_ifaces, sizeof *jobv);
+	jobs_by_name = calloc(n_target_ifaces, sizeof *jobs_by_name);
+	if (!jobv || !jobs_by_name)
+		err(1, "calloc");
+
+	build_job_graph();
+
+	if (cmds == iface_up)
+		read_all_state(&old_state, &n_old_state);
+
+	int running = 0;
+	int n_done = 0;
+	int next_output = 0;
+	bool killed = false;
+
+	while (n_done < n_target_ifaces) {
+		while (running < jobs && !interrupted) {
+			struct job *next = NULL;
+
+			for (int i = 0; i < n_target_ifaces; i++) {
+				if (!jobv[i].started && jobv[i].n_deps == 0) {
+					if (!next || jobv[i].rank < next->rank)
+						next = &jobv[i];
+				}
+			}
+
+			if (!next)
+				break;
+
+			/* out of files: wait for a running job to free some */
+			if (!start_job(next)) {
+				if (!running)
+					err(1, "tmpfile");
+
+				break;
+			}
+
+			running++;
+		}
+
+		if (!running)
+			break;
+
+		int status;
+		pid_t pid = waitpid(-1, &status, 0);
+
+		if (pid == -1) {
+			if (errno == EINTR)
+				continue;
+
+			err(1, "waitpid");
+		}
+
+		if (interrupted && !killed) {
+			for (int i = 0; i < n_target_ifaces; i++)
+				if (jobv[i].started && !jobv[i].done && jobv[i].pid != pid)
+					kill(jobv[i].pid, SIGTERM);
+
+			killed = true;
+		}
+
+		for (int i = 0; i < n_target_ifaces; i++) {
+			struct job *job = &jobv[i];
+
+			if (!job->started || job->done || job->pid != pid)
+				continue;
+
+			job->done = true;
+			job->success = WIFEXITED(status) && WEXITSTATUS(status) == 0;
+			read_output(job->out, &job->output[0]);
+			read_output(job->err, &job->output[1]);
+			running--;
+			n_done++;
+
+			for (int d = 0; d < job->n_dependents; d++)
+				jobv[job->dependents[d]].n_deps--;
+
+			break;
+		}
+
+		while (next_output < n_target_ifaces && jobv[next_output].done) {
+			write_output(&jobv[next_output].output[0], stdout);
+			write_output(&jobv[next_output].output[1], stderr);
+			next_output++;
+		}
+	}
+
+	for (int i = 0; i < n_target_ifaces; i++) {
+		if (!jobv[i].done)
+			success = false;
+		else
+			success &= jobv[i].success;
+	}
+
+	if (cmds == iface_up)
+		reorder_state(old_state, n_old_state);
+
+	for (int i = 0; i < n_old_state; i++)
+		free(old_state[i]);
+
+	free(old_state);
+
+	for (int i = 0; i < n_target_ifaces; i++)
+		free(jobv[i].dependents);
+
+	free(jobs_by_name);
+	free(jobv);
+
+	return success;
+}
+
 int main(int argc, char *argv[]) {
 	argv0 = strrchr(argv[0], '/');
 	if(argv0)
@@ -1463,12 +2139,13 @@ int main(int argc, char *argv[]) {
 		statefile = strdup(RUN_DIR "ifstate");
 		tmpstatefile = strdup(RUN_DIR ".ifstate.tmp");
 		lockfile = strdup(RUN_DIR ".ifstate.lock");
+		cachefile = strdup(RUN_DIR ".interfaces.cache");
 	}
 
 	if (!interfaces)
 		interfaces = strdup("/etc/network/interfaces");
 
-	if (!interfaces || !statedir || !statefile || !tmpstatefile || !lockfile)
+	if (!interfaces || !statedir || !statefile || !tmpstatefile || !lockfile || !cachefile)
 		err(1, "strdup");
 
 	mkdir(statedir, 0755);
@@ -1480,6 +2157,11 @@ int main(int argc, char *argv[]) {
 		goto finish;
 	}
 
+	if (children_query) {
+		success = do_children(argc, argv);
+		goto finish;
+	}
+
 	signal(SIGINT, signal_handler);
 	signal(SIGTERM, signal_handler);
 	signal(SIGHUP, signal_handler);
@@ -1489,8 +2171,14 @@ int main(int argc, char *argv[]) {
 	if (do_all)
 		do_pre_all();
 
-	for (int i = 0; i < n_target_ifaces; i++)
-		success &= do_interface(target_iface[i], NULL);
+	if (jobs > 1 && n_target_ifaces > 1 && (cmds == iface_up || cmds == iface_down)) {
+		success = do_interfaces_parallel();
+	} else {
+		for (int i = 0; i < n_target_ifaces; i++)
+			success &= do_interface(target_iface[i], NULL);
+
+		report_skipped_commands();
+	}
 
 	if (do_all)
 		do_post_all();
@@ -1501,6 +2189,8 @@ finish:
 	free(tmpstatefile);
 	free(statefile);
 	free(statedir);
+	free(cachefile);
+	arena_free();
 
 	return success ? 0 : 1;
 }
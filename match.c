@@ -0,0 +1,131 @@
+#define _GNU_SOURCE
+
+#include <stdlib.h>
+#include <string.h>
+#include <fnmatch.h>
+#include <err.h>
+
+#include "header.h"
+
+/*
+ * A list of shell patterns compiled for matching many names against it.
+ * Patterns without wildcards are looked up in a hash table, patterns that
+ * are a fixed prefix followed by one '*' in a trie, and only the rest are
+ * tried one by one with fnmatch(). There is no locale, so the first two
+ * kinds match byte for byte, exactly like fnmatch() does. Patterns with a
+ * {FIRST..LAST} range also match the names of the range.
+ */
+
+struct trie_node {
+	trie_node *child;	/* first node for the next character */
+	trie_node *sibling;	/* next node for the same character position */
+	char c;
+	bool end;		/* a pattern ends here, so everything below matches */
+};
+
+static bool is_special(char c, int flags) {
+	switch (c) {
+	case '*':
+	case '?':
+	case '[':
+	case '\\':
+		return true;
+	case '(':
+		/* +(...), @(...), !(...) and the *( and ?( above */
+		return flags & FNM_EXTMATCH;
+	default:
+		return false;
+	}
+}
+
+static void add_prefix(matcher *m, const char *prefix, size_t len) {
+	trie_node **node = &m->prefixes;
+
+	if (!*node)
+		*node = arena_alloc(sizeof **node);
+
+	for (size_t i = 0; i < len; i++) {
+		trie_node **child = &(*node)->child;
+
+		while (*child && (*child)->c != prefix[i])
+			child = &(*child)->sibling;
+
+		if (!*child) {
+			*child = arena_alloc(sizeof **child);
+			(*child)->c = prefix[i];
+		}
+
+		node = child;
+	}
+
+	(*node)->end = true;
+}
+
+static bool match_prefix(const trie_node *node, const char *string) {
+	for (; node; string++) {
+		if (node->end)
+			return true;
+
+		if (!*string)
+			return false;
+
+		for (node = node->child; node && node->c != *string; node = node->sibling)
+			;
+	}
+
+	return false;
+}
+
+static void compile_pattern(matcher *m, char *pattern) {
+	size_t len = 0;
+	name_range range;
+
+	if (parse_range(pattern, &range)) {
+		m->ranges = realloc(m->ranges, (m->n_ranges + 1) * sizeof *m->ranges);
+		if (!m->ranges)
+			err(1, "realloc");
+
+		m->ranges[m->n_ranges++] = pattern;
+	}
+
+	while (pattern[len] && !is_special(pattern[len], m->flags))
+		len++;
+
+	if (!pattern[len]) {
+		hash_set(&m->literals, pattern, pattern);
+	} else if (pattern[len] == '*' && !pattern[len + 1]) {
+		add_prefix(m, pattern, len);
+	} else {
+		m->complex = realloc(m->complex, (m->n_complex + 1) * sizeof *m->complex);
+		if (!m->complex)
+			err(1, "realloc");
+
+		m->complex[m->n_complex++] = pattern;
+	}
+}
+
+/*
+ * Return true if string matches any of the patterns, like fnmatch() with
+ * the matcher's flags would. The patterns are compiled on first use, and
+ * patterns appended to the list since the last call are added to it.
+ */
+bool matcher_match(matcher *m, const char *string, int n_patterns, char *patterns[]) {
+	for (; m->n_patterns < n_patterns; m->n_patterns++)
+		compile_pattern(m, patterns[m->n_patterns]);
+
+	if (hash_get(&m->literals, string, strlen(string)))
+		return true;
+
+	if (match_prefix(m->prefixes, string))
+		return true;
+
+	for (int i = 0; i < m->n_complex; i++)
+		if (fnmatch(m->complex[i], string, m->flags) == 0)
+			return true;
+
+	for (int i = 0; i < m->n_ranges; i++)
+		if (in_range(m->ranges[i], string))
+			return true;
+
+	return false;
+}
@@ -0,0 +1,50 @@
+#include <stddef.h>
+#include "header.h"
+
+
+#include "archcommon.h"
+#include "archlinux.h"
+
+
+static option_default _none_default[] = {
+	{ NULL, NULL }
+};
+static conversion _none_conv[] = {
+	{ CONVERT_END, NULL, 0, -1, NULL, NULL, 0, NULL }
+};
+static const char *const _none_slot_names[] = {
+	NULL
+};
+static const option_slots _none_slots = { 0, _none_slot_names };
+static const command_op _none_up_ops[] = {
+	{ COMMAND_END, 0, NULL, false, NULL, NULL }
+};
+static int _none_up(interface_defn *ifd, execfn *exec) {
+	return execute_ops(_none_up_ops, &_none_slots, ifd, exec);
+}
+static const command_op _none_down_ops[] = {
+	{ COMMAND_END, 0, NULL, false, NULL, NULL }
+};
+static int _none_down(interface_defn *ifd, execfn *exec) {
+	return execute_ops(_none_down_ops, &_none_slots, ifd, exec);
+}
+static const command_op _none_rename_ops[] = { { COMMAND_END, 0, NULL, false, NULL, NULL } };
+static int _none_rename(interface_defn *ifd, execfn *exec) { return 0; }
+static method methods[] = {
+        {
+                "none",
+                _none_up, _none_down, _none_rename,
+                _none_conv, _none_default,
+                &_none_slots,
+                _none_up_ops, _none_down_ops, _none_rename_ops,
+        },
+};
+
+static const signed char method_slots[] = { 0 };
+
+address_family addr_meta = {
+        "meta",
+        sizeof(methods)/sizeof(struct method),
+        methods,
+        { 1, 0, method_slots }
+};
@@ -0,0 +1,677 @@
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <errno.h>
+#include <unistd.h>
+#include <err.h>
+#include <net/if.h>
+#include <arpa/inet.h>
+#include <sys/socket.h>
+#include <linux/netlink.h>
+#include <linux/rtnetlink.h>
+#include <linux/if_addr.h>
+
+#include "header.h"
+
+/*
+ * Execute the "ip link set", "ip addr add/del/flush" and "ip route
+ * add/del/replace" commands generated from the method definitions directly
+ * over an rtnetlink socket, instead of running /bin/sh and /sbin/ip for
+ * each of them. Anything that is not recognized is left to the shell.
+ */
+
+#ifndef INFINITY_LIFE_TIME
+#define INFINITY_LIFE_TIME 0xFFFFFFFFU
+#endif
+
+struct request {
+	struct nlmsghdr n;
+	char buf[1024];
+};
+
+struct inet_prefix {
+	int family;
+	int bytelen;
+	int bitlen;
+	unsigned char data[16];
+};
+
+static int nl_fd = -1;
+static pid_t nl_pid;
+static unsigned int nl_seq;
+
+static bool nl_open(void) {
+	/* Never share the socket with a parent process */
+	if (nl_fd != -1 && nl_pid == getpid())
+		return true;
+
+	if (nl_fd != -1)
+		close(nl_fd);
+
+	nl_fd = socket(AF_NETLINK, SOCK_RAW | SOCK_CLOEXEC, NETLINK_ROUTE);
+	if (nl_fd == -1) {
+		warn("could not open rtnetlink socket");
+		return false;
+	}
+
+	nl_pid = getpid();
+	return true;
+}
+
+static void *start_request(struct request *req, int type, int flags, size_t len) {
+	memset(req, 0, sizeof *req);
+	req->n.nlmsg_len = NLMSG_LENGTH(len);
+	req->n.nlmsg_type = type;
+	req->n.nlmsg_flags = NLM_F_REQUEST | flags;
+
+	return NLMSG_DATA(&req->n);
+}
+
+static void add_attr(struct request *req, int type, const void *data, size_t len) {
+	size_t offset = NLMSG_ALIGN(req->n.nlmsg_len);
+
+	if (offset + RTA_SPACE(len) > sizeof *req)
+		errx(1, "netlink request too large");
+
+	struct rtattr *rta = (struct rtattr *)((char *)req + offset);
+	rta->rta_type = type;
+	rta->rta_len = RTA_LENGTH(len);
+	memcpy(RTA_DATA(rta), data, len);
+
+	req->n.nlmsg_len = offset + RTA_SPACE(len);
+}
+
+static void add_attr32(struct request *req, int type, uint32_t value) {
+	add_attr(req, type, &value, sizeof value);
+}
+
+static int nl_send(struct nlmsghdr *n) {
+	struct sockaddr_nl sa = {.nl_family = AF_NETLINK};
+
+	n->nlmsg_seq = ++nl_seq;
+
+	if (sendto(nl_fd, n, n->nlmsg_len, 0, (struct sockaddr *)&sa, sizeof sa) == -1)
+		return -errno;
+
+	return 0;
+}
+
+/* Receive replies to the last request, calling fn for each message. Returns 0 or a negative errno value. */
+static int nl_recv(int (*fn)(struct nlmsghdr *, void *), void *arg) {
+	char buf[16384];
+
+	for (;;) {
+		int len = recv(nl_fd, buf, sizeof buf, 0);
+
+		if (len == -1) {
+			if (errno == EINTR)
+				continue;
+
+			return -errno;
+		}
+
+		for (struct nlmsghdr *h = (struct nlmsghdr *)buf; NLMSG_OK(h, (unsigned int)len); h = NLMSG_NEXT(h, len)) {
+			if (h->nlmsg_seq != nl_seq)
+				continue;
+
+			if (h->nlmsg_type == NLMSG_DONE)
+				return 0;
+
+			if (h->nlmsg_type == NLMSG_ERROR)
+				return ((struct nlmsgerr *)NLMSG_DATA(h))->error;
+
+			if (fn) {
+				int result = fn(h, arg);
+				if (result)
+					return result;
+			}
+		}
+	}
+}
+
+static int nl_talk(struct request *req) {
+	req->n.nlmsg_flags |= NLM_F_ACK;
+
+	int result = nl_send(&req->n);
+	if (result)
+		return result;
+
+	return nl_recv(NULL, NULL);
+}
+
+static bool report(int error) {
+	if (error) {
+		fprintf(stderr, "RTNETLINK answers: %s\n", strerror(-error));
+		return false;
+	}
+
+	return true;
+}
+
+static bool get_ifindex(const char *name, int *index) {
+	*index = if_nametoindex(name);
+
+	if (!*index) {
+		fprintf(stderr, "Cannot find device \"%s\"\n", name);
+		return false;
+	}
+
+	return true;
+}
+
+static int mask_to_prefixlen(const char *mask) {
+	struct in_addr addr;
+
+	if (inet_pton(AF_INET, mask, &addr) != 1)
+		return -1;
+
+	uint32_t bits = ntohl(addr.s_addr);
+	int len = 0;
+
+	while (bits & 0x80000000) {
+		bits <<= 1;
+		len++;
+	}
+
+	return bits ? -1 : len;
+}
+
+/* Parse an address with an optional prefix length or netmask */
+static bool get_prefix(const char *str, int family, struct inet_prefix *prefix) {
+	char *addr = strdupa(str);
+	char *slash = strchr(addr, '/');
+
+	if (slash)
+		*slash++ = '\0';
+
+	memset(prefix, 0, sizeof *prefix);
+
+	if ((family == AF_UNSPEC || family == AF_INET) && inet_pton(AF_INET, addr, prefix->data) == 1) {
+		prefix->family = AF_INET;
+		prefix->bytelen = 4;
+	} else if ((family == AF_UNSPEC || family == AF_INET6) && inet_pton(AF_INET6, addr, prefix->data) == 1) {
+		prefix->family = AF_INET6;
+		prefix->bytelen = 16;
+	} else {
+		return false;
+	}
+
+	prefix->bitlen = prefix->bytelen * 8;
+
+	if (slash) {
+		char *end;
+		long len = strtol(slash, &end, 10);
+
+		if (*end || end == slash) {
+			if (prefix->family != AF_INET)
+				return false;
+
+			len = mask_to_prefixlen(slash);
+		}
+
+		if (len < 0 || len > prefix->bitlen)
+			return false;
+
+		prefix->bitlen = len;
+	}
+
+	return true;
+}
+
+static bool get_u32(const char *str, uint32_t *value) {
+	char *end;
+	unsigned long result = strtoul(str, &end, 0);
+
+	if (*end || end == str || result > UINT32_MAX)
+		return false;
+
+	*value = result;
+	return true;
+}
+
+static bool get_scope(const char *str, unsigned char *scope) {
+	uint32_t value;
+
+	if (!strcmp(str, "global"))
+		*scope = RT_SCOPE_UNIVERSE;
+	else if (!strcmp(str, "site"))
+		*scope = RT_SCOPE_SITE;
+	else if (!strcmp(str, "link"))
+		*scope = RT_SCOPE_LINK;
+	else if (!strcmp(str, "host"))
+		*scope = RT_SCOPE_HOST;
+	else if (get_u32(str, &value) && value <= 255)
+		*scope = value;
+	else
+		return false;
+
+	return true;
+}
+
+static int get_hwaddr(const char *str, unsigned char *addr, int max) {
+	int len = 0;
+
+	while (*str && len < max) {
+		unsigned int byte;
+		int n;
+
+		if (sscanf(str, "%2x%n", &byte, &n) != 1)
+			return -1;
+
+		addr[len++] = byte;
+		str += n;
+
+		if (*str == ':')
+			str++;
+		else if (*str)
+			return -1;
+	}
+
+	return *str ? -1 : len;
+}
+
+/* ip link set [dev] NAME [up|down] [mtu MTU] [address LLADDR] */
+static bool link_set(char **argv, bool *okay) {
+	const char *name = NULL;
+	unsigned int flags = 0, change = 0;
+	uint32_t mtu = 0;
+	unsigned char hwaddr[32];
+	int hwaddr_len = 0;
+
+	for (; *argv; argv++) {
+		if (!strcmp(*argv, "dev") && argv[1]) {
+			name = *++argv;
+		} else if (!strcmp(*argv, "up")) {
+			flags |= IFF_UP;
+			change |= IFF_UP;
+		} else if (!strcmp(*argv, "down")) {
+			flags &= ~IFF_UP;
+			change |= IFF_UP;
+		} else if (!strcmp(*argv, "mtu") && argv[1]) {
+			if (!get_u32(*++argv, &mtu))
+				return false;
+		} else if (!strcmp(*argv, "address") && argv[1]) {
+			hwaddr_len = get_hwaddr(*++argv, hwaddr, sizeof hwaddr);
+			if (hwaddr_len <= 0)
+				return false;
+		} else if (!name) {
+			name = *argv;
+		} else {
+			return false;
+		}
+	}
+
+	if (!name || !nl_open())
+		return false;
+
+	struct request req;
+	struct ifinfomsg *ifi = start_request(&req, RTM_NEWLINK, 0, sizeof *ifi);
+	ifi->ifi_family = AF_UNSPEC;
+	ifi->ifi_flags = flags;
+	ifi->ifi_change = change;
+
+	if (!get_ifindex(name, &ifi->ifi_index)) {
+		*okay = false;
+		return true;
+	}
+
+	if (mtu)
+		add_attr32(&req, IFLA_MTU, mtu);
+
+	if (hwaddr_len)
+		add_attr(&req, IFLA_ADDRESS, hwaddr, hwaddr_len);
+
+	*okay = report(nl_talk(&req));
+	return true;
+}
+
+/* The scope ip gives an address added without one: host for 127.0.0.0/8 */
+static unsigned char default_scope(const struct inet_prefix *local) {
+	if (local->family == AF_INET && local->bytelen >= 1 && local->data[0] == 127)
+		return RT_SCOPE_HOST;
+
+	return RT_SCOPE_UNIVERSE;
+}
+
+/* ip addr add|del ADDR[/LEN] [broadcast ADDR] [peer ADDR] [scope SCOPE] dev NAME [label LABEL] [preferred_lft LFT] [nodad] */
+static bool addr_modify(int cmd, int flags, int family, char **argv, bool *okay) {
+	const char *name = NULL;
+	const char *label = NULL;
+	struct inet_prefix local, peer, broadcast;
+	bool have_local = false, have_peer = false, have_broadcast = false;
+	unsigned char scope = RT_SCOPE_UNIVERSE;
+	bool have_scope = false;
+	uint32_t ifa_flags = 0;
+	uint32_t preferred_lft = INFINITY_LIFE_TIME;
+	bool have_lft = false;
+
+	for (; *argv; argv++) {
+		if (!strcmp(*argv, "dev") && argv[1]) {
+			name = *++argv;
+		} else if (!strcmp(*argv, "label") && argv[1]) {
+			label = *++argv;
+		} else if ((!strcmp(*argv, "broadcast") || !strcmp(*argv, "brd")) && argv[1]) {
+			if (!get_prefix(*++argv, family, &broadcast) || broadcast.family != AF_INET)
+				return false;
+			have_broadcast = true;
+		} else if (!strcmp(*argv, "peer") && argv[1]) {
+			if (!get_prefix(*++argv, family, &peer))
+				return false;
+			have_peer = true;
+		} else if (!strcmp(*argv, "scope") && argv[1]) {
+			if (!get_scope(*++argv, &scope))
+				return false;
+			have_scope = true;
+		} else if (!strcmp(*argv, "preferred_lft") && argv[1]) {
+			argv++;
+			if (strcmp(*argv, "forever") && !get_u32(*argv, &preferred_lft))
+				return false;
+			have_lft = true;
+		} else if (!strcmp(*argv, "nodad")) {
+			ifa_flags |= IFA_F_NODAD;
+		} else if (!have_local) {
+			if (!strcmp(*argv, "local") && argv[1])
+				argv++;
+			if (!get_prefix(*argv, family, &local))
+				return false;
+			have_local = true;
+		} else {
+			return false;
+		}
+	}
+
+	if (!name || !have_local || !nl_open())
+		return false;
+
+	if (have_peer && peer.family != local.family)
+		return false;
+
+	if (!have_scope && cmd != RTM_DELADDR)
+		scope = default_scope(&local);
+
+	struct request req;
+	struct ifaddrmsg *ifa = start_request(&req, cmd, flags, sizeof *ifa);
+	ifa->ifa_family = local.family;
+	ifa->ifa_prefixlen = local.bitlen;
+	ifa->ifa_scope = scope;
+	ifa->ifa_flags = ifa_flags & 0xff;
+
+	int index;
+	if (!get_ifindex(name, &index)) {
+		*okay = false;
+		return true;
+	}
+
+	ifa->ifa_index = index;
+
+	add_attr(&req, IFA_LOCAL, local.data, local.bytelen);
+
+	if (have_peer) {
+		add_attr(&req, IFA_ADDRESS, peer.data, peer.bytelen);
+		if (peer.bitlen != peer.bytelen * 8)
+			ifa->ifa_prefixlen = peer.bitlen;
+	} else {
+		add_attr(&req, IFA_ADDRESS, local.data, local.bytelen);
+	}
+
+	if (have_broadcast)
+		add_attr(&req, IFA_BROADCAST, broadcast.data, broadcast.bytelen);
+
+	if (label)
+		add_attr(&req, IFA_LABEL, label, strlen(label) + 1);
+
+	if (ifa_flags & ~0xff)
+		add_attr32(&req, IFA_FLAGS, ifa_flags);
+
+	if (have_lft && cmd == RTM_NEWADDR) {
+		struct ifa_cacheinfo ci = {
+			.ifa_prefered = preferred_lft,
+			.ifa_valid = INFINITY_LIFE_TIME,
+		};
+
+		add_attr(&req, IFA_CACHEINFO, &ci, sizeof ci);
+	}
+
+	*okay = report(nl_talk(&req));
+	return true;
+}
+
+struct flush_filter {
+	int index;
+	int scope;
+	int n_msgs;
+	struct nlmsghdr **msgs;
+};
+
+static int collect_addr(struct nlmsghdr *h, void *arg) {
+	struct flush_filter *filter = arg;
+	struct ifaddrmsg *ifa = NLMSG_DATA(h);
+
+	if (h->nlmsg_type != RTM_NEWADDR || (int)ifa->ifa_index != filter->index)
+		return 0;
+
+	if (filter->scope != -1 && ifa->ifa_scope != filter->scope)
+		return 0;
+
+	struct nlmsghdr *copy = malloc(h->nlmsg_len);
+	if (!copy)
+		err(1, "malloc");
+
+	memcpy(copy, h, h->nlmsg_len);
+
+	filter->msgs = realloc(filter->msgs, (filter->n_msgs + 1) * sizeof *filter->msgs);
+	if (!filter->msgs)
+		err(1, "realloc");
+
+	filter->msgs[filter->n_msgs++] = copy;
+	return 0;
+}
+
+/* ip addr flush dev NAME [scope SCOPE] */
+static bool addr_flush(int family, char **argv, bool *okay) {
+	const char *name = NULL;
+	struct flush_filter filter = {.scope = -1};
+
+	for (; *argv; argv++) {
+		if (!strcmp(*argv, "dev") && argv[1]) {
+			name = *++argv;
+		} else if (!strcmp(*argv, "scope") && argv[1]) {
+			unsigned char scope;
+			if (!get_scope(*++argv, &scope))
+				return false;
+			filter.scope = scope;
+		} else {
+			return false;
+		}
+	}
+
+	if (!name || !nl_open())
+		return false;
+
+	if (!get_ifindex(name, &filter.index)) {
+		*okay = false;
+		return true;
+	}
+
+	struct request req;
+	struct ifaddrmsg *ifa = start_request(&req, RTM_GETADDR, NLM_F_DUMP, sizeof *ifa);
+	ifa->ifa_family = family;
+
+	int result = nl_send(&req.n);
+	if (!result)
+		result = nl_recv(collect_addr, &filter);
+
+	for (int i = 0; i < filter.n_msgs; i++) {
+		struct nlmsghdr *h = filter.msgs[i];
+
+		/* Removing a primary address also removes its secondaries */
+		if (!result) {
+			h->nlmsg_type = RTM_DELADDR;
+			h->nlmsg_flags = NLM_F_REQUEST | NLM_F_ACK;
+
+			result = nl_send(h);
+			if (!result)
+				result = nl_recv(NULL, NULL);
+
+			if (result == -EADDRNOTAVAIL || result == -ENOENT)
+				result = 0;
+		}
+
+		free(h);
+	}
+
+	free(filter.msgs);
+
+	*okay = report(result);
+	return true;
+}
+
+/* ip route add|del|replace PREFIX|default [via ADDR] [dev NAME] [metric METRIC] [onlink] */
+static bool route_modify(int cmd, int flags, int family, char **argv, bool *okay) {
+	const char *name = NULL;
+	struct inet_prefix dst, gateway;
+	bool have_dst = false, have_gateway = false;
+	uint32_t metric = 0;
+	bool have_metric = false;
+	unsigned int rtm_flags = 0;
+
+	for (; *argv; argv++) {
+		if (!strcmp(*argv, "via") && argv[1]) {
+			if (!get_prefix(*++argv, family, &gateway) || gateway.bitlen != gateway.bytelen * 8)
+				return false;
+			have_gateway = true;
+		} else if (!strcmp(*argv, "dev") && argv[1]) {
+			name = *++argv;
+		} else if ((!strcmp(*argv, "metric") || !strcmp(*argv, "priority")) && argv[1]) {
+			if (!get_u32(*++argv, &metric))
+				return false;
+			have_metric = true;
+		} else if (!strcmp(*argv, "onlink")) {
+			rtm_flags |= RTNH_F_ONLINK;
+		} else if (!have_dst) {
+			if (!strcmp(*argv, "default")) {
+				memset(&dst, 0, sizeof dst);
+				dst.family = family;
+			} else if (!get_prefix(*argv, family, &dst)) {
+				return false;
+			}
+			have_dst = true;
+		} else {
+			return false;
+		}
+	}
+
+	if (!have_dst)
+		return false;
+
+	if (dst.family == AF_UNSPEC)
+		dst.family = have_gateway ? gateway.family : AF_INET;
+
+	if (have_gateway && gateway.family != dst.family)
+		return false;
+
+	if (!nl_open())
+		return false;
+
+	struct request req;
+	struct rtmsg *rtm = start_request(&req, cmd, flags, sizeof *rtm);
+	rtm->rtm_family = dst.family;
+	rtm->rtm_dst_len = dst.bitlen;
+	rtm->rtm_table = RT_TABLE_MAIN;
+	rtm->rtm_flags = rtm_flags;
+
+	if (cmd == RTM_DELROUTE) {
+		rtm->rtm_scope = RT_SCOPE_NOWHERE;
+	} else {
+		rtm->rtm_protocol = RTPROT_BOOT;
+		rtm->rtm_scope = have_gateway ? RT_SCOPE_UNIVERSE : RT_SCOPE_LINK;
+		rtm->rtm_type = RTN_UNICAST;
+	}
+
+	if (dst.bitlen)
+		add_attr(&req, RTA_DST, dst.data, dst.bytelen);
+
+	if (have_gateway)
+		add_attr(&req, RTA_GATEWAY, gateway.data, gateway.bytelen);
+
+	if (have_metric)
+		add_attr32(&req, RTA_PRIORITY, metric);
+
+	if (name) {
+		int index;
+
+		if (!get_ifindex(name, &index)) {
+			*okay = false;
+			return true;
+		}
+
+		add_attr32(&req, RTA_OIF, index);
+	}
+
+	*okay = report(nl_talk(&req));
+	return true;
+}
+
+static bool dispatch(char **argv, bool *okay) {
+	int family = AF_UNSPEC;
+
+	if (strcmp(*argv, "ip") && strcmp(*argv, "/sbin/ip") && strcmp(*argv, "/bin/ip"))
+		return false;
+
+	for (argv++; *argv && **argv == '-'; argv++) {
+		if (!strcmp(*argv, "-4"))
+			family = AF_INET;
+		else if (!strcmp(*argv, "-6"))
+			family = AF_INET6;
+		else
+			return false;
+	}
+
+	if (!argv[0] || !argv[1])
+		return false;
+
+	const char *object = argv[0];
+	const char *command = argv[1];
+	argv += 2;
+
+	if (!strcmp(object, "link")) {
+		if (!strcmp(command, "set"))
+			return link_set(argv, okay);
+	} else if (!strcmp(object, "addr") || !strcmp(object, "address")) {
+		if (!strcmp(command, "add"))
+			return addr_modify(RTM_NEWADDR, NLM_F_CREATE | NLM_F_EXCL, family, argv, okay);
+		if (!strcmp(command, "del"))
+			return addr_modify(RTM_DELADDR, 0, family, argv, okay);
+		if (!strcmp(command, "flush"))
+			return addr_flush(family, argv, okay);
+	} else if (!strcmp(object, "route")) {
+		if (!strcmp(command, "add"))
+			return route_modify(RTM_NEWROUTE, NLM_F_CREATE | NLM_F_EXCL, family, argv, okay);
+		if (!strcmp(command, "replace"))
+			return route_modify(RTM_NEWROUTE, NLM_F_CREATE | NLM_F_REPLACE, family, argv, okay);
+		if (!strcmp(command, "del"))
+			return route_modify(RTM_DELROUTE, 0, family, argv, okay);
+	}
+
+	return false;
+}
+
+/*
+ * Try to execute the given command over rtnetlink. Returns false if the
+ * command was not recognized and should be run by the shell instead.
+ */
+bool netlink_execute(const char *command, bool *okay) {
+	char **argv = split_command(command);
+
+	if (!argv)
+		return false;
+
+	bool handled = dispatch(argv, okay);
+
+	free(argv);
+
+	return handled;
+}
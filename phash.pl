@@ -0,0 +1,55 @@
+# Collision-free hash tables for a fixed set of names, made at build time
+# so that the C code can look a name up with one hash and one compare.
+# perfect_hash_find() in hash.c must hash exactly like phash_string().
+
+use strict;
+
+# FNV-1a starting from the seed instead of the usual offset basis
+sub phash_string {
+        my ($seed, $string) = @_;
+        my $hash = $seed;
+
+        foreach my $c (unpack("C*", $string)) {
+                $hash = (($hash ^ $c) * 16777619) & 0xffffffff;
+        }
+
+        return $hash ^ ($hash >> 16);
+}
+
+# Find a seed for which no two keys share a slot. Returns the seed, the
+# mask, and for each slot the index of its key or -1.
+sub perfect_hash {
+        my @keys = @_;
+        my $size = 1;
+
+        die "Too many keys for a perfect hash table\n" if (@keys > 127);
+
+        $size *= 2 while ($size < @keys);
+
+        for (;; $size *= 2) {
+                SEED: for (my $seed = 1; $seed <= 10000; $seed++) {
+                        my @slot = (-1) x $size;
+
+                        for (my $i = 0; $i < @keys; $i++) {
+                                my $s = phash_string($seed, $keys[$i]) & ($size - 1);
+
+                                next SEED if ($slot[$s] >= 0);
+                                $slot[$s] = $i;
+                        }
+
+                        return ($seed, $size - 1, @slot);
+                }
+        }
+}
+
+# Print the slots of a table for the keys and return its initializer
+sub print_perfect_hash {
+        my ($name, @keys) = @_;
+        my ($seed, $mask, @slot) = perfect_hash(@keys);
+
+        print "static const signed char ${name}[] = { " . join(", ", @slot) . " };\n";
+
+        return "{ $seed, $mask, $name }";
+}
+
+1;